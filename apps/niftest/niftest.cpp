@@ -3,8 +3,22 @@
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+#if defined(__linux) || defined(__unix) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
 
 #include <components/nif/niffile.hpp>
+#include <components/nifosg/nifloader.hpp>
+#include <components/nifbullet/bulletnifloader.hpp>
+#include <components/resource/imagemanager.hpp>
+#include <components/resource/bulletshape.hpp>
 #include <components/files/constrainedfilestream.hpp>
 #include <components/vfs/manager.hpp>
 #include <components/vfs/bsaarchive.hpp>
@@ -37,38 +51,161 @@ bool isNIF(const std::string & filename)
 {
     return hasExtension(filename,"nif");
 }
+///See if the file has the "kf" extension.
+bool isKF(const std::string & filename)
+{
+    return hasExtension(filename,"kf");
+}
 ///See if the file has the "bsa" extension.
 bool isBSA(const std::string & filename)
 {
     return hasExtension(filename,"bsa");
 }
 
-/// Check all the nif files in a given VFS::Archive
+/// Options controlling what is done with every file
+struct Options
+{
+    /// Map BSA archives into memory instead of streaming from them
+    bool mMemoryMapArchives;
+    /// Also build a scene graph with NifOsg::Loader
+    bool mConvertOsg;
+    /// Also build a collision shape with NifBullet::BulletNifLoader
+    bool mConvertBullet;
+    /// Report timings
+    bool mBenchmark;
+    /// Print the timings of every file
+    bool mPerFile;
+    /// Number of slowest files to report
+    unsigned int mSlowest;
+    /// Number of worker threads
+    unsigned int mThreads;
+
+    Options()
+        : mMemoryMapArchives(false), mConvertOsg(false), mConvertBullet(false)
+        , mBenchmark(false), mPerFile(false), mSlowest(10), mThreads(1)
+    {}
+} options;
+
+/// A file queued for checking. Files inside archives are read through the VFS of their archive.
+struct Job
+{
+    std::string mName;
+    std::string mDisplayName;
+    const VFS::Manager* mVFS;
+    Resource::ImageManager* mImageManager;
+};
+
+/// Timings of a single file, in seconds
+struct Result
+{
+    std::string mDisplayName;
+    size_t mBytes;
+    double mParse;
+    double mOsg;
+    double mBullet;
+    /// Empty if the file was checked successfully
+    std::string mError;
+
+    double total() const { return mParse + mOsg + mBullet; }
+};
+
+/// VFS managers and image managers of all archives, kept alive until all jobs are done
+std::vector<std::shared_ptr<VFS::Manager> > managers;
+std::vector<std::shared_ptr<Resource::ImageManager> > imageManagers;
+
+std::vector<Job> jobs;
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    return duration.count();
+}
+
+/// Parse a single nif or kf file, and optionally convert it
+Result checkFile(const Job& job)
+{
+    Result result;
+    result.mDisplayName = job.mDisplayName;
+    result.mBytes = 0;
+    result.mParse = result.mOsg = result.mBullet = 0.0;
+
+    try
+    {
+        Files::IStreamPtr stream = job.mVFS ? job.mVFS->get(job.mName) : Files::openConstrainedFileStream(job.mName.c_str());
+
+        stream->seekg(0, std::ios_base::end);
+        std::streamoff size = stream->tellg();
+        stream->seekg(0, std::ios_base::beg);
+        if (size > 0)
+            result.mBytes = static_cast<size_t>(size);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        Nif::NIFFilePtr file(new Nif::NIFFile(stream, job.mDisplayName));
+        result.mParse = secondsSince(start);
+
+        if (options.mConvertOsg)
+        {
+            start = std::chrono::steady_clock::now();
+            if (isKF(job.mName))
+            {
+                osg::ref_ptr<NifOsg::KeyframeHolder> keyframes (new NifOsg::KeyframeHolder);
+                NifOsg::Loader::loadKf(file, *keyframes);
+            }
+            else
+                NifOsg::Loader::load(file, job.mImageManager);
+            result.mOsg = secondsSince(start);
+        }
+
+        if (options.mConvertBullet && !isKF(job.mName))
+        {
+            start = std::chrono::steady_clock::now();
+            NifBullet::BulletNifLoader loader;
+            loader.load(file);
+            result.mBullet = secondsSince(start);
+        }
+    }
+    catch (std::exception& e)
+    {
+        result.mError = e.what();
+    }
+
+    return result;
+}
+
+/// Queue all the nif and kf files in a given VFS::Archive
 /// \note Takes ownership!
 /// \note Can not read a bsa file inside of a bsa file.
 void readVFS(VFS::Archive* anArchive,std::string archivePath = "")
 {
-    VFS::Manager myManager(true);
-    myManager.addArchive(anArchive);
-    myManager.buildIndex();
+    std::shared_ptr<VFS::Manager> myManager(new VFS::Manager(true));
+    myManager->addArchive(anArchive);
+    myManager->buildIndex();
+    managers.push_back(myManager);
+
+    std::shared_ptr<Resource::ImageManager> imageManager;
+    if (options.mConvertOsg)
+    {
+        imageManager.reset(new Resource::ImageManager(myManager.get()));
+        imageManagers.push_back(imageManager);
+    }
 
-    std::map<std::string, VFS::File*> files=myManager.getIndex();
+    const std::map<std::string, VFS::File*>& files=myManager->getIndex();
     for(std::map<std::string, VFS::File*>::const_iterator it=files.begin(); it!=files.end(); ++it)
     {
         std::string name = it->first;
 
         try{
-            if(isNIF(name))
+            if(isNIF(name) || isKF(name))
             {
-            //           std::cout << "Decoding: " << name << std::endl;
-                Nif::NIFFile temp_nif(myManager.get(name),archivePath+name);
+                Job job = { name, archivePath+name, myManager.get(), imageManager.get() };
+                jobs.push_back(job);
             }
             else if(isBSA(name))
             {
                 if(!archivePath.empty() && !isBSA(archivePath))
                 {
 //                     std::cout << "Reading BSA File: " << name << std::endl;
-                    readVFS(new VFS::BsaArchive(archivePath+name),archivePath+name+"/");
+                    readVFS(new VFS::BsaArchive(archivePath+name, options.mMemoryMapArchives),archivePath+name+"/");
 //                     std::cout << "Done with BSA File: " << name << std::endl;
                 }
             }
@@ -80,15 +217,104 @@ void readVFS(VFS::Archive* anArchive,std::string archivePath = "")
     }
 }
 
+/// Peak resident set size of this process in KiB, or 0 if unknown
+size_t getPeakRSS()
+{
+#if defined(__linux) || defined(__unix) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#if defined(__APPLE__)
+    // Reported in bytes on macOS
+    return static_cast<size_t>(usage.ru_maxrss) / 1024;
+#else
+    return static_cast<size_t>(usage.ru_maxrss);
+#endif
+#else
+    return 0;
+#endif
+}
+
+void printResult(const Result& result)
+{
+    std::cout << result.mDisplayName << ": " << result.mBytes << " bytes, parse " << result.mParse * 1000.0 << " ms";
+    if (options.mConvertOsg)
+        std::cout << ", osg " << result.mOsg * 1000.0 << " ms";
+    if (options.mConvertBullet)
+        std::cout << ", bullet " << result.mBullet * 1000.0 << " ms";
+    if (!result.mError.empty())
+        std::cout << " (failed)";
+    std::cout << std::endl;
+}
+
+void printReport(const std::vector<Result>& results, double wallTime)
+{
+    size_t bytes = 0;
+    size_t failed = 0;
+    double parse = 0.0, osg = 0.0, bullet = 0.0;
+    for (std::vector<Result>::const_iterator it = results.begin(); it != results.end(); ++it)
+    {
+        bytes += it->mBytes;
+        parse += it->mParse;
+        osg += it->mOsg;
+        bullet += it->mBullet;
+        if (!it->mError.empty())
+            ++failed;
+    }
+
+    double megabytes = bytes / (1024.0 * 1024.0);
+    std::cout << "Checked " << results.size() << " files (" << failed << " failed), " << megabytes << " MB, "
+              << options.mThreads << " threads" << std::endl;
+    std::cout << "Wall time: " << wallTime << " s";
+    if (wallTime > 0)
+        std::cout << " (" << megabytes / wallTime << " MB/s)";
+    std::cout << std::endl;
+
+    // Thread times are summed over all threads, so they can exceed the wall time
+    std::cout << "Parse time: " << parse << " s";
+    if (parse > 0)
+        std::cout << " (" << megabytes / parse << " MB/s per thread)";
+    std::cout << std::endl;
+    if (options.mConvertOsg)
+        std::cout << "NifOsg time: " << osg << " s" << std::endl;
+    if (options.mConvertBullet)
+        std::cout << "NifBullet time: " << bullet << " s" << std::endl;
+
+    size_t peakRSS = getPeakRSS();
+    if (peakRSS)
+        std::cout << "Peak RSS: " << peakRSS / 1024.0 << " MB" << std::endl;
+
+    std::vector<Result> slowest(results);
+    size_t count = std::min<size_t>(options.mSlowest, slowest.size());
+    std::partial_sort(slowest.begin(), slowest.begin() + count, slowest.end(),
+        [] (const Result& left, const Result& right) { return left.total() > right.total(); });
+    if (count > 0)
+        std::cout << "Slowest files:" << std::endl;
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::cout << "  ";
+        printResult(slowest[i]);
+    }
+}
+
 std::vector<std::string> parseOptions (int argc, char** argv)
 {
     bpo::options_description desc("Ensure that OpenMW can use the provided NIF and BSA files\n\n"
         "Usages:\n"
-        "  niftool <nif files, BSA files, or directories>\n"
-        "      Scan the file or directories for nif errors.\n\n"
+        "  niftool <nif files, kf files, BSA files, or directories>\n"
+        "      Scan the file or directories for nif errors.\n"
+        "  niftool --benchmark --threads 4 --convert-osg --convert-bullet <BSA files or directories>\n"
+        "      Time parsing and converting all nif and kf files, without requiring a GPU.\n\n"
         "Allowed options");
     desc.add_options()
         ("help,h", "print help message.")
+        ("benchmark,b", "report aggregate timings, throughput, peak memory usage and the slowest files.")
+        ("per-file", "with --benchmark, also report the timings of every file.")
+        ("slowest", bpo::value<unsigned int>()->default_value(10), "with --benchmark, number of slowest files to report.")
+        ("threads,j", bpo::value<unsigned int>()->default_value(1), "number of files to check in parallel.")
+        ("convert-osg", "also convert the files to scene graphs with the NifOsg loader.")
+        ("convert-bullet", "also convert the nif files to collision shapes with the NifBullet loader.")
+        ("mmap", "memory map BSA archives instead of streaming from them.")
         ("input-file", bpo::value< std::vector<std::string> >(), "input file")
         ;
 
@@ -116,6 +342,15 @@ std::vector<std::string> parseOptions (int argc, char** argv)
         std::cout << desc << std::endl;
         exit(1);
     }
+
+    options.mBenchmark = variables.count("benchmark") != 0;
+    options.mPerFile = variables.count("per-file") != 0;
+    options.mSlowest = variables["slowest"].as<unsigned int>();
+    options.mThreads = std::max(1u, variables["threads"].as<unsigned int>());
+    options.mConvertOsg = variables.count("convert-osg") != 0;
+    options.mConvertBullet = variables.count("convert-bullet") != 0;
+    options.mMemoryMapArchives = variables.count("mmap") != 0;
+
     if (variables.count("input-file"))
     {
         return variables["input-file"].as< std::vector<std::string> >();
@@ -136,15 +371,16 @@ int main(int argc, char **argv)
          std::string name = *it;
 
         try{
-            if(isNIF(name))
+            if(isNIF(name) || isKF(name))
             {
                 //std::cout << "Decoding: " << name << std::endl;
-                Nif::NIFFile temp_nif(Files::openConstrainedFileStream(name.c_str()),name);
+                Job job = { name, name, NULL, NULL };
+                jobs.push_back(job);
              }
              else if(isBSA(name))
              {
 //                 std::cout << "Reading BSA File: " << name << std::endl;
-                readVFS(new VFS::BsaArchive(name));
+                readVFS(new VFS::BsaArchive(name, options.mMemoryMapArchives));
              }
              else if(bfs::is_directory(bfs::path(name)))
              {
@@ -153,7 +389,7 @@ int main(int argc, char **argv)
              }
              else
              {
-                 std::cerr << "ERROR:  \"" << name << "\" is not a nif file, bsa file, or directory!" << std::endl;
+                 std::cerr << "ERROR:  \"" << name << "\" is not a nif file, kf file, bsa file, or directory!" << std::endl;
              }
         }
         catch (std::exception& e)
@@ -161,5 +397,47 @@ int main(int argc, char **argv)
             std::cerr << "ERROR, an exception has occurred:  " << e.what() << std::endl;
         }
      }
+
+     // Loose files have no archive to load textures from
+     std::shared_ptr<VFS::Manager> emptyManager(new VFS::Manager(true));
+     std::shared_ptr<Resource::ImageManager> emptyImageManager;
+     if (options.mConvertOsg)
+         emptyImageManager.reset(new Resource::ImageManager(emptyManager.get()));
+     for (std::vector<Job>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+     {
+         if (!it->mImageManager)
+             it->mImageManager = emptyImageManager.get();
+     }
+
+     std::vector<Result> results(jobs.size());
+     std::atomic<size_t> nextJob(0);
+     std::mutex outputMutex;
+
+     std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+     auto worker = [&] ()
+     {
+         for (size_t i = nextJob++; i < jobs.size(); i = nextJob++)
+         {
+             results[i] = checkFile(jobs[i]);
+
+             std::lock_guard<std::mutex> lock(outputMutex);
+             if (!results[i].mError.empty())
+                 std::cerr << "ERROR, an exception has occurred:  " << results[i].mError << std::endl;
+             if (options.mBenchmark && options.mPerFile)
+                 printResult(results[i]);
+         }
+     };
+
+     std::vector<std::thread> threads;
+     for (unsigned int i = 1; i < options.mThreads; ++i)
+         threads.push_back(std::thread(worker));
+     worker();
+     for (std::vector<std::thread>::iterator it = threads.begin(); it != threads.end(); ++it)
+         it->join();
+
+     if (options.mBenchmark)
+         printReport(results, secondsSince(start));
+
      return 0;
 }
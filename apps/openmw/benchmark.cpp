@@ -0,0 +1,146 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+#include <osg/Stats>
+
+namespace
+{
+    double getPercentile(std::vector<double> sorted, double percentile)
+    {
+        if (sorted.empty())
+            return 0.0;
+        std::sort(sorted.begin(), sorted.end());
+        size_t index = static_cast<size_t>(percentile * (sorted.size() - 1) + 0.5);
+        return sorted[index];
+    }
+
+    void writeSummary(std::ostream& stream, const std::vector<double>& times)
+    {
+        double total = 0.0;
+        double min = times.empty() ? 0.0 : times.front();
+        double max = min;
+        for (std::vector<double>::const_iterator it = times.begin(); it != times.end(); ++it)
+        {
+            total += *it;
+            min = std::min(min, *it);
+            max = std::max(max, *it);
+        }
+        double mean = times.empty() ? 0.0 : total / times.size();
+
+        stream << "{\"total_ms\": " << total
+               << ", \"mean_ms\": " << mean
+               << ", \"min_ms\": " << min
+               << ", \"max_ms\": " << max
+               << ", \"p50_ms\": " << getPercentile(times, 0.5)
+               << ", \"p95_ms\": " << getPercentile(times, 0.95)
+               << ", \"p99_ms\": " << getPercentile(times, 0.99) << "}";
+    }
+
+    void writeArray(std::ostream& stream, const std::vector<double>& times)
+    {
+        stream << "[";
+        for (std::vector<double>::const_iterator it = times.begin(); it != times.end(); ++it)
+        {
+            if (it != times.begin())
+                stream << ", ";
+            stream << *it;
+        }
+        stream << "]";
+    }
+}
+
+namespace OMW
+{
+    Benchmark::Benchmark(int numFrames, float timestep, const std::string& outputPath)
+        : mNumFrames(numFrames)
+        , mTimestep(timestep)
+        , mOutputPath(outputPath)
+    {
+        const char* subsystems[][2] = {
+            { "scripts", "script_time_taken" },
+            { "mechanics", "mechanics_time_taken" },
+            { "world", "world_time_taken" },
+            { "physics", "physics_time_taken" },
+            { "cell_loading", "cell_loading_time_taken" }
+        };
+
+        for (size_t i = 0; i < sizeof(subsystems) / sizeof(subsystems[0]); ++i)
+        {
+            Subsystem subsystem;
+            subsystem.mName = subsystems[i][0];
+            subsystem.mAttribute = subsystems[i][1];
+            subsystem.mTimes.reserve(numFrames);
+            mSubsystems.push_back(subsystem);
+        }
+
+        mFrameTimes.reserve(numFrames);
+    }
+
+    void Benchmark::recordFrame(osg::Stats* stats, unsigned int frameNumber, double frameTime)
+    {
+        mFrameTimes.push_back(frameTime * 1000.0);
+
+        for (std::vector<Subsystem>::iterator it = mSubsystems.begin(); it != mSubsystems.end(); ++it)
+        {
+            double time = 0.0;
+            stats->getAttribute(frameNumber, it->mAttribute, time);
+            it->mTimes.push_back(time * 1000.0);
+        }
+    }
+
+    bool Benchmark::isDone() const
+    {
+        return mFrameTimes.size() >= static_cast<size_t>(mNumFrames);
+    }
+
+    void Benchmark::writeReport() const
+    {
+        if (mOutputPath.empty())
+        {
+            writeJson(std::cout);
+            return;
+        }
+
+        std::ofstream stream(mOutputPath.c_str());
+        if (!stream)
+            throw std::runtime_error("Failed to open benchmark output file: " + mOutputPath);
+        writeJson(stream);
+
+        std::cout << "Benchmark results written to " << mOutputPath << std::endl;
+    }
+
+    void Benchmark::writeJson(std::ostream& stream) const
+    {
+        stream << std::fixed << std::setprecision(4);
+
+        stream << "{\n";
+        stream << "  \"frames\": " << mFrameTimes.size() << ",\n";
+        stream << "  \"timestep\": " << mTimestep << ",\n";
+
+        stream << "  \"summary\": {\n";
+        stream << "    \"frame\": ";
+        writeSummary(stream, mFrameTimes);
+        for (std::vector<Subsystem>::const_iterator it = mSubsystems.begin(); it != mSubsystems.end(); ++it)
+        {
+            stream << ",\n    \"" << it->mName << "\": ";
+            writeSummary(stream, it->mTimes);
+        }
+        stream << "\n  },\n";
+
+        stream << "  \"per_frame_ms\": {\n";
+        stream << "    \"frame\": ";
+        writeArray(stream, mFrameTimes);
+        for (std::vector<Subsystem>::const_iterator it = mSubsystems.begin(); it != mSubsystems.end(); ++it)
+        {
+            stream << ",\n    \"" << it->mName << "\": ";
+            writeArray(stream, it->mTimes);
+        }
+        stream << "\n  }\n";
+        stream << "}" << std::endl;
+    }
+}
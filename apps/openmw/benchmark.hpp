@@ -0,0 +1,52 @@
+#ifndef OPENMW_BENCHMARK_H
+#define OPENMW_BENCHMARK_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace osg
+{
+    class Stats;
+}
+
+namespace OMW
+{
+    /// \brief Collects per-subsystem frame times of a benchmark run and writes them out as JSON
+    ///
+    /// The subsystem timings are read back from the viewer stats, which is where the engine reports them
+    /// for the profiler overlay.
+    class Benchmark
+    {
+        public:
+            Benchmark(int numFrames, float timestep, const std::string& outputPath);
+
+            /// Record the timings of the given frame.
+            /// \param frameTime CPU time spent on the whole frame in seconds
+            void recordFrame(osg::Stats* stats, unsigned int frameNumber, double frameTime);
+
+            /// Have all requested frames been recorded?
+            bool isDone() const;
+
+            /// Write the report to the output path, or to stdout if no path was given.
+            void writeReport() const;
+
+        private:
+            struct Subsystem
+            {
+                std::string mName;
+                std::string mAttribute;
+                std::vector<double> mTimes; // in milliseconds, one entry per recorded frame
+            };
+
+            void writeJson(std::ostream& stream) const;
+
+            int mNumFrames;
+            float mTimestep;
+            std::string mOutputPath;
+            std::vector<double> mFrameTimes;
+            std::vector<Subsystem> mSubsystems;
+    };
+}
+
+#endif
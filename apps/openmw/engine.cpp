@@ -25,6 +25,7 @@
 #include <components/compiler/extensions0.hpp>
 
 #include <components/sceneutil/workqueue.hpp>
+#include <components/sceneutil/riggeometry.hpp>
 
 #include <components/files/configurationmanager.hpp>
 
@@ -43,6 +44,7 @@
 */
 
 #include "mwinput/inputmanagerimp.hpp"
+#include "mwinput/headlessinputmanager.hpp"
 
 #include "mwgui/windowmanagerimp.hpp"
 
@@ -68,6 +70,8 @@
 
 #include "mwstate/statemanagerimp.hpp"
 
+#include "benchmark.hpp"
+
 namespace
 {
     void checkSDLError(int ret)
@@ -244,13 +248,13 @@ bool OMW::Engine::frame(float frametime)
         }
 
         // update world
-        osg::Timer_t beforePhysicsTick = osg::Timer::instance()->tick();;
+        osg::Timer_t beforeWorldTick = osg::Timer::instance()->tick();
         if (mEnvironment.getStateManager()->getState()!=
             MWBase::StateManager::State_NoGame)
         {
             mEnvironment.getWorld()->update(frametime, guiActive);
         }
-        osg::Timer_t afterPhysicsTick = osg::Timer::instance()->tick();
+        osg::Timer_t afterWorldTick = osg::Timer::instance()->tick();
 
         // update GUI
         mEnvironment.getWindowManager()->onFrame(frametime);
@@ -265,9 +269,9 @@ bool OMW::Engine::frame(float frametime)
         stats->setAttribute(frameNumber, "mechanics_time_taken", osg::Timer::instance()->delta_s(beforeMechanicsTick, afterMechanicsTick));
         stats->setAttribute(frameNumber, "mechanics_time_end", osg::Timer::instance()->delta_s(mStartTick, afterMechanicsTick));
 
-        stats->setAttribute(frameNumber, "physics_time_begin", osg::Timer::instance()->delta_s(mStartTick, beforePhysicsTick));
-        stats->setAttribute(frameNumber, "physics_time_taken", osg::Timer::instance()->delta_s(beforePhysicsTick, afterPhysicsTick));
-        stats->setAttribute(frameNumber, "physics_time_end", osg::Timer::instance()->delta_s(mStartTick, afterPhysicsTick));
+        stats->setAttribute(frameNumber, "world_time_begin", osg::Timer::instance()->delta_s(mStartTick, beforeWorldTick));
+        stats->setAttribute(frameNumber, "world_time_taken", osg::Timer::instance()->delta_s(beforeWorldTick, afterWorldTick));
+        stats->setAttribute(frameNumber, "world_time_end", osg::Timer::instance()->delta_s(mStartTick, afterWorldTick));
 
         if (stats->collectStats("resource"))
         {
@@ -297,6 +301,8 @@ OMW::Engine::Engine(Files::ConfigurationManager& configurationManager)
   , mWarningsMode (1)
   , mScriptConsoleMode (false)
   , mActivationDistanceOverride(-1)
+  , mBenchmarkFrames(0)
+  , mBenchmarkTimestep(1.f/60.f)
   , mGrab(true)
   , mExportFonts(false)
   , mScriptContext (0)
@@ -308,16 +314,6 @@ OMW::Engine::Engine(Files::ConfigurationManager& configurationManager)
     Misc::Rng::init();
     MWClass::registerClasses();
 
-    Uint32 flags = SDL_INIT_VIDEO|SDL_INIT_NOPARACHUTE|SDL_INIT_GAMECONTROLLER|SDL_INIT_JOYSTICK;
-    if(SDL_WasInit(flags) == 0)
-    {
-        SDL_SetMainReady();
-        if(SDL_Init(flags) != 0)
-        {
-            throw std::runtime_error("Could not initialize SDL! " + std::string(SDL_GetError()));
-        }
-    }
-
     mStartTick = osg::Timer::instance()->tick();
 }
 
@@ -354,6 +350,10 @@ OMW::Engine::~Engine()
 
     mViewer = NULL;
 
+    // after the scene graph, since skinned meshes wait for their pending work on destruction
+    SceneUtil::RigGeometry::setWorkQueue(NULL);
+    mSkinningQueue = NULL;
+
     if (mWindow)
     {
         SDL_DestroyWindow(mWindow);
@@ -535,6 +535,17 @@ void OMW::Engine::createWindow(Settings::Manager& settings)
     mViewer->getEventQueue()->getCurrentEventState()->setWindowRectangle(0, 0, width, height);
 }
 
+void OMW::Engine::setupHeadlessViewer(Settings::Manager& settings)
+{
+    // No window and no graphics context: the viewer is never realized, so nothing is compiled or drawn.
+    // The GUI still lays itself out for the configured resolution.
+    int width = settings.getInt("resolution x", "Video");
+    int height = settings.getInt("resolution y", "Video");
+
+    mViewer->getCamera()->setViewport(0, 0, width, height);
+    mViewer->getEventQueue()->getCurrentEventState()->setWindowRectangle(0, 0, width, height);
+}
+
 void OMW::Engine::setWindowIcon()
 {
     boost::filesystem::ifstream windowIconStream;
@@ -564,14 +575,18 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
     mEnvironment.setStateManager (
         new MWState::StateManager (mCfgMgr.getUserDataPath() / "saves", mContentFiles.at (0)));
 
-    createWindow(settings);
+    if (mBenchmarkFrames > 0)
+        setupHeadlessViewer(settings);
+    else
+        createWindow(settings);
 
     osg::ref_ptr<osg::Group> rootNode (new osg::Group);
     mViewer->setSceneData(rootNode);
 
     mVFS.reset(new VFS::Manager(mFSStrict));
 
-    VFS::registerArchives(mVFS.get(), mFileCollections, mArchives, true);
+    VFS::registerArchives(mVFS.get(), mFileCollections, mArchives, true,
+        Settings::Manager::getBool("memory map archives", "General"));
 
     mResourceSystem.reset(new Resource::ResourceSystem(mVFS.get()));
     mResourceSystem->getSceneManager()->setUnRefImageDataAfterApply(false); // keep to Off for now to allow better state sharing
@@ -587,45 +602,58 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
         throw std::runtime_error("Invalid setting: 'preload num threads' must be >0");
     mWorkQueue = new SceneUtil::WorkQueue(numThreads);
 
+    int numSkinningThreads = Settings::Manager::getInt("skinning threads", "General");
+    if (numSkinningThreads > 0)
+    {
+        mSkinningQueue = new SceneUtil::WorkQueue(numSkinningThreads);
+        SceneUtil::RigGeometry::setWorkQueue(mSkinningQueue.get());
+    }
+
     // Create input and UI first to set up a bootstrapping environment for
     // showing a loading screen and keeping the window responsive while doing so
 
-    std::string keybinderUser = (mCfgMgr.getUserConfigPath() / "input_v3.xml").string();
-    bool keybinderUserExists = boost::filesystem::exists(keybinderUser);
-    if(!keybinderUserExists)
+    MWInput::InputManager* input = NULL;
+    if (mBenchmarkFrames > 0)
+        mEnvironment.setInputManager (new MWInput::HeadlessInputManager);
+    else
     {
-        std::string input2 = (mCfgMgr.getUserConfigPath() / "input_v2.xml").string();
-        if(boost::filesystem::exists(input2)) {
-            boost::filesystem::copy_file(input2, keybinderUser);
-            keybinderUserExists = boost::filesystem::exists(keybinderUser);
+        std::string keybinderUser = (mCfgMgr.getUserConfigPath() / "input_v3.xml").string();
+        bool keybinderUserExists = boost::filesystem::exists(keybinderUser);
+        if(!keybinderUserExists)
+        {
+            std::string input2 = (mCfgMgr.getUserConfigPath() / "input_v2.xml").string();
+            if(boost::filesystem::exists(input2)) {
+                boost::filesystem::copy_file(input2, keybinderUser);
+                keybinderUserExists = boost::filesystem::exists(keybinderUser);
+            }
         }
-    }
 
-    // find correct path to the game controller bindings
-    // File format for controller mappings is different for SDL <= 2.0.4, 2.0.5, and >= 2.0.6
-    SDL_version linkedSdlVersion;
-    SDL_GetVersion(&linkedSdlVersion);
-    std::string controllerFileName;
-    if (linkedSdlVersion.major == 2 && linkedSdlVersion.minor == 0 && linkedSdlVersion.patch <= 4) {
-        controllerFileName = "gamecontrollerdb_204.txt";
-    } else if (linkedSdlVersion.major == 2 && linkedSdlVersion.minor == 0 && linkedSdlVersion.patch == 5) {
-        controllerFileName = "gamecontrollerdb_205.txt";
-    } else {
-        controllerFileName = "gamecontrollerdb.txt";
-    }
+        // find correct path to the game controller bindings
+        // File format for controller mappings is different for SDL <= 2.0.4, 2.0.5, and >= 2.0.6
+        SDL_version linkedSdlVersion;
+        SDL_GetVersion(&linkedSdlVersion);
+        std::string controllerFileName;
+        if (linkedSdlVersion.major == 2 && linkedSdlVersion.minor == 0 && linkedSdlVersion.patch <= 4) {
+            controllerFileName = "gamecontrollerdb_204.txt";
+        } else if (linkedSdlVersion.major == 2 && linkedSdlVersion.minor == 0 && linkedSdlVersion.patch == 5) {
+            controllerFileName = "gamecontrollerdb_205.txt";
+        } else {
+            controllerFileName = "gamecontrollerdb.txt";
+        }
 
-    const std::string localdefault = mCfgMgr.getLocalPath().string() + "/" + controllerFileName;
-    const std::string globaldefault = mCfgMgr.getGlobalPath().string() + "/" + controllerFileName;
-    std::string gameControllerdb;
-    if (boost::filesystem::exists(localdefault))
-        gameControllerdb = localdefault;
-    else if (boost::filesystem::exists(globaldefault))
-        gameControllerdb = globaldefault;
-    else
-        gameControllerdb = ""; //if it doesn't exist, pass in an empty string
+        const std::string localdefault = mCfgMgr.getLocalPath().string() + "/" + controllerFileName;
+        const std::string globaldefault = mCfgMgr.getGlobalPath().string() + "/" + controllerFileName;
+        std::string gameControllerdb;
+        if (boost::filesystem::exists(localdefault))
+            gameControllerdb = localdefault;
+        else if (boost::filesystem::exists(globaldefault))
+            gameControllerdb = globaldefault;
+        else
+            gameControllerdb = ""; //if it doesn't exist, pass in an empty string
 
-    MWInput::InputManager* input = new MWInput::InputManager (mWindow, mViewer, mScreenCaptureHandler, mScreenCaptureOperation, keybinderUser, keybinderUserExists, gameControllerdb, mGrab);
-    mEnvironment.setInputManager (input);
+        input = new MWInput::InputManager (mWindow, mViewer, mScreenCaptureHandler, mScreenCaptureOperation, keybinderUser, keybinderUserExists, gameControllerdb, mGrab);
+        mEnvironment.setInputManager (input);
+    }
 
     std::string myguiResources = (mResDir / "mygui").string();
     osg::ref_ptr<osg::Group> guiRoot = new osg::Group;
@@ -653,7 +681,8 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
         mFileCollections, mContentFiles, mEncoder, mFallbackMap,
         mActivationDistanceOverride, mCellName, mStartupScript, mResDir.string(), mCfgMgr.getUserDataPath().string()));
     mEnvironment.getWorld()->setupPlayer();
-    input->setPlayer(&mEnvironment.getWorld()->getPlayer());
+    if (input)
+        input->setPlayer(&mEnvironment.getWorld()->getPlayer());
 
     window->setStore(mEnvironment.getWorld()->getStore());
     window->initUI();
@@ -779,6 +808,32 @@ void OMW::Engine::go()
     ToUTF8::Utf8Encoder encoder (mEncoding);
     mEncoder = &encoder;
 
+    std::unique_ptr<Benchmark> benchmark;
+    if (mBenchmarkFrames > 0)
+    {
+        std::cout << "Running benchmark for " << mBenchmarkFrames << " frames" << std::endl;
+
+        benchmark.reset(new Benchmark(mBenchmarkFrames, mBenchmarkTimestep, mBenchmarkOutput));
+
+        // Keep the run reproducible: fixed random sequence, no intro videos or music
+        Misc::Rng::init(0);
+        mSkipMenu = true;
+        mUseSound = false;
+    }
+
+    // Benchmark runs have no window and no input devices, so they don't need video or a display
+    Uint32 flags = SDL_INIT_NOPARACHUTE;
+    if (!benchmark)
+        flags |= SDL_INIT_VIDEO|SDL_INIT_GAMECONTROLLER|SDL_INIT_JOYSTICK;
+    if(SDL_WasInit(flags) == 0)
+    {
+        SDL_SetMainReady();
+        if(SDL_Init(flags) != 0)
+        {
+            throw std::runtime_error("Could not initialize SDL! " + std::string(SDL_GetError()));
+        }
+    }
+
     // Setup viewer
     mViewer = new osgViewer::Viewer;
     mViewer->setReleaseContextAtEndOfFrameHint(false);
@@ -821,8 +876,12 @@ void OMW::Engine::go()
                                    "script_time_taken", 1000.0, true, false, "script_time_begin", "script_time_end", 10000);
     statshandler->addUserStatsLine("Mechanics", osg::Vec4f(1.f, 1.f, 1.f, 1.f), osg::Vec4f(1.f, 1.f, 1.f, 1.f),
                                    "mechanics_time_taken", 1000.0, true, false, "mechanics_time_begin", "mechanics_time_end", 10000);
+    statshandler->addUserStatsLine("World", osg::Vec4f(1.f, 1.f, 1.f, 1.f), osg::Vec4f(1.f, 1.f, 1.f, 1.f),
+                                   "world_time_taken", 1000.0, true, false, "world_time_begin", "world_time_end", 10000);
     statshandler->addUserStatsLine("Physics", osg::Vec4f(1.f, 1.f, 1.f, 1.f), osg::Vec4f(1.f, 1.f, 1.f, 1.f),
                                    "physics_time_taken", 1000.0, true, false, "physics_time_begin", "physics_time_end", 10000);
+    statshandler->addUserStatsLine("Cells", osg::Vec4f(1.f, 1.f, 1.f, 1.f), osg::Vec4f(1.f, 1.f, 1.f, 1.f),
+                                   "cell_loading_time_taken", 1000.0, true, false, "cell_loading_time_begin", "cell_loading_time_end", 10000);
 
     mViewer->addEventHandler(statshandler);
 
@@ -863,6 +922,9 @@ void OMW::Engine::go()
         frameTimer.setStartTick();
         dt = std::min(dt, 0.2);
 
+        if (benchmark)
+            dt = mBenchmarkTimestep;
+
         mViewer->advance(simulationTime);
 
         if (!frame(dt))
@@ -872,12 +934,15 @@ void OMW::Engine::go()
         }
         else
         {
-            mViewer->eventTraversal();
+            // Without a graphics context the viewer would treat the event traversal as all windows being closed
+            if (!benchmark)
+                mViewer->eventTraversal();
             mViewer->updateTraversal();
 
             mEnvironment.getWorld()->updateWindowManager();
 
-            mViewer->renderingTraversals();
+            if (!benchmark)
+                mViewer->renderingTraversals();
 
             bool guiActive = mEnvironment.getWindowManager()->isGuiMode();
 
@@ -896,6 +961,17 @@ void OMW::Engine::go()
                 simulationTime += dt;
         }
 
+        if (benchmark)
+        {
+            benchmark->recordFrame(mViewer->getViewerStats(), mViewer->getFrameStamp()->getFrameNumber(), frameTimer.time_s());
+            if (benchmark->isDone())
+            {
+                benchmark->writeReport();
+                break;
+            }
+            continue;
+        }
+
         mEnvironment.limitFrameRate(frameTimer.time_s());
     }
 
@@ -969,3 +1045,10 @@ void OMW::Engine::setSaveGameFile(const std::string &savegame)
 {
     mSaveGameFile = savegame;
 }
+
+void OMW::Engine::setBenchmark(int frames, float timestep, const std::string& outputPath)
+{
+    mBenchmarkFrames = frames;
+    mBenchmarkTimestep = timestep;
+    mBenchmarkOutput = outputPath;
+}
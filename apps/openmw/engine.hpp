@@ -74,6 +74,7 @@ namespace OMW
             std::unique_ptr<VFS::Manager> mVFS;
             std::unique_ptr<Resource::ResourceSystem> mResourceSystem;
             osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+            osg::ref_ptr<SceneUtil::WorkQueue> mSkinningQueue;
             MWBase::Environment mEnvironment;
             ToUTF8::FromType mEncoding;
             ToUTF8::Utf8Encoder* mEncoder;
@@ -96,6 +97,9 @@ namespace OMW
             std::string mStartupScript;
             int mActivationDistanceOverride;
             std::string mSaveGameFile;
+            int mBenchmarkFrames;
+            float mBenchmarkTimestep;
+            std::string mBenchmarkOutput;
             // Grab mouse?
             bool mGrab;
 
@@ -128,6 +132,8 @@ namespace OMW
             void prepareEngine (Settings::Manager & settings);
 
             void createWindow(Settings::Manager& settings);
+            /// Set up the viewer for benchmark runs, without a window or graphics context
+            void setupHeadlessViewer(Settings::Manager& settings);
             void setWindowIcon();
 
         public:
@@ -203,6 +209,14 @@ namespace OMW
             /// Set the save game file to load after initialising the engine.
             void setSaveGameFile(const std::string& savegame);
 
+            /// Run a fixed number of frames without rendering, then write the per-subsystem frame times
+            /// as JSON and quit.
+            ///
+            /// \param frames Number of frames to simulate, 0 disables the benchmark
+            /// \param timestep Fixed simulation time per frame in seconds
+            /// \param outputPath File to write the results to, stdout if empty
+            void setBenchmark(int frames, float timestep, const std::string& outputPath);
+
         private:
             Files::ConfigurationManager& mCfgMgr;
     };
@@ -158,7 +158,16 @@ bool parseOptions (int argc, char** argv, OMW::Engine& engine, Files::Configurat
         ("export-fonts", bpo::value<bool>()->implicit_value(true)
             ->default_value(false), "Export Morrowind .fnt fonts to PNG image and XML file in current directory")
 
-        ("activate-dist", bpo::value <int> ()->default_value (-1), "activation distance override");
+        ("activate-dist", bpo::value <int> ()->default_value (-1), "activation distance override")
+
+        ("benchmark-frames", bpo::value<int>()->default_value(0),
+            "run the given number of frames without rendering, print per-subsystem frame times as JSON and quit")
+
+        ("benchmark-timestep", bpo::value<float>()->default_value(1.f/60.f),
+            "fixed simulation time per frame in seconds for --benchmark-frames")
+
+        ("benchmark-output", bpo::value<Files::EscapeHashString>()->default_value(""),
+            "write the benchmark results to the given file instead of the standard output");
 
     /*
         Start of tes3mp addition
@@ -310,6 +319,8 @@ bool parseOptions (int argc, char** argv, OMW::Engine& engine, Files::Configurat
     engine.setScriptBlacklist (variables["script-blacklist"].as<Files::EscapeStringVector>().toStdStringVector());
     engine.setScriptBlacklistUse (variables["script-blacklist-use"].as<bool>());
     engine.setSaveGameFile (variables["load-savegame"].as<Files::EscapeHashString>().toStdString());
+    engine.setBenchmark (variables["benchmark-frames"].as<int>(), variables["benchmark-timestep"].as<float>(),
+        variables["benchmark-output"].as<Files::EscapeHashString>().toStdString());
 
     // other settings
     engine.setSoundUsage(!variables["no-sound"].as<bool>());
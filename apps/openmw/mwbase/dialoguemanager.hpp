@@ -106,6 +106,19 @@ namespace MWBase
             /// Removes the last added topic response for the given actor from the journal
             virtual void clearInfoActor (const MWWorld::Ptr& actor) const = 0;
 
+            /// The value of global variable \a name has changed.
+            virtual void notifyGlobalChanged (const std::string& name) = 0;
+
+            /// The journal index or entries of quest \a id have changed.
+            virtual void notifyJournalChanged (const std::string& id) = 0;
+
+            /// The number of items \a id in the player's inventory has changed.
+            virtual void notifyItemCountChanged (const std::string& id) = 0;
+
+            /// Inputs without a change notification (stats, factions, cell, ...) may have changed, e.g. through a
+            /// server update. Test the topics that read them again.
+            virtual void invalidateVolatileTopics() = 0;
+
             /*
                 Start of tes3mp addition
 
@@ -62,7 +62,10 @@
 namespace MWDialogue
 {
     DialogueManager::DialogueManager (const Compiler::Extensions& extensions, Translation::Storage& translationDataStorage) :
-      mTranslationDataStorage(translationDataStorage)
+      mActorKnownTopicsValid(false)
+      , mInfoIndex(MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>())
+      , mTopicDependencies(MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>())
+      , mTranslationDataStorage(translationDataStorage)
       , mCompilerContext (MWScript::CompilerContext::Type_Dialogue)
       , mErrorStream(std::cout.rdbuf())
       , mErrorHandler(mErrorStream)
@@ -74,11 +77,23 @@ namespace MWDialogue
         mIsInChoice = false;
         mGoodbye = false;
         mCompilerContext.setExtensions (&extensions);
+
+        const MWWorld::Store<ESM::Dialogue>& dialogs = MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
+
+        std::list<std::string> keywordList;
+        for (MWWorld::Store<ESM::Dialogue>::iterator it = dialogs.begin(); it != dialogs.end(); ++it)
+            keywordList.push_back(Misc::StringUtils::lowerCase(it->mId));
+        keywordList.sort(Misc::StringUtils::ciLess);
+
+        for (std::list<std::string>::const_iterator it = keywordList.begin(); it != keywordList.end(); ++it)
+            mKeywordSearch.seed(*it, 0 /*unused*/);
     }
 
     void DialogueManager::clear()
     {
         mKnownTopics.clear();
+        mActorKnownTopics.clear();
+        invalidateActorKnownTopics();
         mTalkedTo = false;
         mTemporaryDispositionChange = 0;
         mPermanentDispositionChange = 0;
@@ -106,7 +121,7 @@ namespace MWDialogue
     void DialogueManager::parseText (const std::string& text)
     {
         updateActorKnownTopics();
-        std::vector<HyperTextParser::Token> hypertext = HyperTextParser::parseHyperText(text);
+        std::vector<HyperTextParser::Token> hypertext = HyperTextParser::parseHyperText(text, mKeywordSearch);
 
         for (std::vector<HyperTextParser::Token>::iterator tok = hypertext.begin(); tok != hypertext.end(); ++tok)
         {
@@ -164,12 +179,13 @@ namespace MWDialogue
         mTalkedTo = creatureStats.hasTalkedToPlayer();
 
         mActorKnownTopics.clear();
+        invalidateActorKnownTopics();
 
         //greeting
         const MWWorld::Store<ESM::Dialogue> &dialogs =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
 
-        Filter filter (actor, mChoice, mTalkedTo);
+        Filter filter (actor, mChoice, mTalkedTo, &mInfoIndex);
 
         for (MWWorld::Store<ESM::Dialogue>::iterator it = dialogs.begin(); it != dialogs.end(); ++it)
         {
@@ -257,6 +273,10 @@ namespace MWDialogue
 
     void DialogueManager::executeScript (const std::string& script, const MWWorld::Ptr& actor)
     {
+        // Changes to globals, journals and items are reported, anything else the script may change
+        // is only read by volatile topics
+        invalidateVolatileTopics();
+
         std::vector<Interpreter::Type_Code> code;
         if(compile(script, code, actor))
         {
@@ -289,7 +309,7 @@ namespace MWDialogue
 
     void DialogueManager::executeTopic (const std::string& topic, ResponseCallback* callback)
     {
-        Filter filter (mActor, mChoice, mTalkedTo);
+        Filter filter (mActor, mChoice, mTalkedTo, &mInfoIndex);
 
         const MWWorld::Store<ESM::Dialogue> &dialogues =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
@@ -357,13 +377,29 @@ namespace MWDialogue
     {
         updateGlobals();
 
+        Filter filter (mActor, -1, mTalkedTo, &mInfoIndex);
+
+        if (mActorKnownTopicsValid)
+        {
+            for (std::set<const ESM::Dialogue*>::const_iterator iter = mChangedTopics.begin();
+                iter != mChangedTopics.end(); ++iter)
+            {
+                if (filter.responseAvailable (**iter))
+                    mActorKnownTopics.insert ((*iter)->mId);
+                else
+                    mActorKnownTopics.erase ((*iter)->mId);
+            }
+
+            mChangedTopics.clear();
+            return;
+        }
+
         mActorKnownTopics.clear();
+        mChangedTopics.clear();
 
         const MWWorld::Store<ESM::Dialogue> &dialogs =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
 
-        Filter filter (mActor, -1, mTalkedTo);
-
         for (MWWorld::Store<ESM::Dialogue>::iterator iter = dialogs.begin(); iter != dialogs.end(); ++iter)
         {
             if (iter->mType == ESM::Dialogue::Topic)
@@ -375,6 +411,18 @@ namespace MWDialogue
             }
         }
 
+        mActorKnownTopicsValid = true;
+    }
+
+    void DialogueManager::invalidateActorKnownTopics()
+    {
+        mActorKnownTopicsValid = false;
+    }
+
+    void DialogueManager::invalidateVolatileTopics()
+    {
+        if (mActorKnownTopicsValid)
+            mTopicDependencies.getVolatileTopics (mChangedTopics);
     }
 
     std::list<std::string> DialogueManager::getAvailableTopics()
@@ -397,6 +445,9 @@ namespace MWDialogue
 
     void DialogueManager::keywordSelected (const std::string& keyword, ResponseCallback* callback)
     {
+        // Anything may have happened since the last response, e.g. a service was used
+        invalidateVolatileTopics();
+
         if(!mIsInChoice)
         {
             const ESM::Dialogue* dialogue = searchDialogue(keyword);
@@ -431,12 +482,14 @@ namespace MWDialogue
 
     void DialogueManager::questionAnswered (int answer, ResponseCallback* callback)
     {
+        invalidateVolatileTopics();
+
         mChoice = answer;
 
         const ESM::Dialogue* dialogue = searchDialogue(mLastTopic);
         if (dialogue)
         {
-            Filter filter (mActor, mChoice, mTalkedTo);
+            Filter filter (mActor, mChoice, mTalkedTo, &mInfoIndex);
 
             if (dialogue->mType == ESM::Dialogue::Topic || dialogue->mType == ESM::Dialogue::Greeting)
             {
@@ -510,6 +563,7 @@ namespace MWDialogue
         MWBase::Environment::get().getMechanicsManager()->getPersuasionDispositionChange(
                     mActor, MWBase::MechanicsManager::PersuasionType(type),
                     success, temp, perm);
+        invalidateVolatileTopics();
         mTemporaryDispositionChange += temp;
         mPermanentDispositionChange += perm;
 
@@ -569,7 +623,7 @@ namespace MWDialogue
 
     bool DialogueManager::checkServiceRefused(ResponseCallback* callback)
     {
-        Filter filter (mActor, mChoice, mTalkedTo);
+        Filter filter (mActor, mChoice, mTalkedTo, &mInfoIndex);
 
         const MWWorld::Store<ESM::Dialogue> &dialogues =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
@@ -621,7 +675,7 @@ namespace MWDialogue
         const ESM::Dialogue *dial = store.get<ESM::Dialogue>().find(topic);
 
         const MWMechanics::CreatureStats& creatureStats = actor.getClass().getCreatureStats(actor);
-        Filter filter(actor, 0, creatureStats.hasTalkedToPlayer());
+        Filter filter(actor, 0, creatureStats.hasTalkedToPlayer(), &mInfoIndex);
         const ESM::DialInfo *info = filter.search(*dial, false);
         if(info != NULL)
         {
@@ -747,6 +801,24 @@ namespace MWDialogue
         return 0;
     }
 
+    void DialogueManager::notifyGlobalChanged (const std::string& name)
+    {
+        if (mActorKnownTopicsValid)
+            mTopicDependencies.getGlobalReaders (name, mChangedTopics);
+    }
+
+    void DialogueManager::notifyJournalChanged (const std::string& id)
+    {
+        if (mActorKnownTopicsValid)
+            mTopicDependencies.getJournalReaders (id, mChangedTopics);
+    }
+
+    void DialogueManager::notifyItemCountChanged (const std::string& id)
+    {
+        if (mActorKnownTopicsValid)
+            mTopicDependencies.getItemReaders (id, mChangedTopics);
+    }
+
     void DialogueManager::clearInfoActor(const MWWorld::Ptr &actor) const
     {
         if (actor == mActor && !mLastTopic.empty())
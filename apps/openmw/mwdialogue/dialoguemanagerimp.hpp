@@ -14,6 +14,10 @@
 
 #include "../mwscript/compilercontext.hpp"
 
+#include "infoindex.hpp"
+#include "keywordsearch.hpp"
+#include "topicdependencies.hpp"
+
 namespace ESM
 {
     struct Dialogue;
@@ -30,6 +34,12 @@ namespace MWDialogue
             ModFactionReactionMap mChangedFactionReaction;
 
             std::set<std::string, Misc::StringUtils::CiComp> mActorKnownTopics;
+            bool mActorKnownTopicsValid; // false if all of mActorKnownTopics has to be updated before it is used
+            std::set<const ESM::Dialogue*> mChangedTopics; // topics to test again before mActorKnownTopics is used
+
+            InfoIndex mInfoIndex;
+            TopicDependencies mTopicDependencies;
+            KeywordSearch<std::string, int /*unused*/> mKeywordSearch; // all dialogue IDs, for parseText
 
             Translation::Storage& mTranslationDataStorage;
             MWScript::CompilerContext mCompilerContext;
@@ -52,6 +62,10 @@ namespace MWDialogue
             void parseText (const std::string& text);
 
             void updateActorKnownTopics();
+            ///< Update the topics the actor can talk about whose inputs changed since the last update.
+
+            void invalidateActorKnownTopics();
+
             void updateGlobals();
 
             bool compile (const std::string& cmd, std::vector<Interpreter::Type_Code>& code, const MWWorld::Ptr& actor);
@@ -125,6 +139,15 @@ namespace MWDialogue
             /// Removes the last added topic response for the given actor from the journal
             virtual void clearInfoActor (const MWWorld::Ptr& actor) const;
 
+            virtual void notifyGlobalChanged (const std::string& name);
+
+            virtual void notifyJournalChanged (const std::string& id);
+
+            virtual void notifyItemCountChanged (const std::string& id);
+
+            virtual void invalidateVolatileTopics();
+            ///< Test the topics reading inputs without change notification again on the next update.
+
             /*
                 Start of tes3mp addition
 
@@ -13,6 +13,7 @@ namespace ESM
 
 namespace MWDialogue
 {
+    class InfoIndex;
     class SelectWrapper;
 
     class Filter
@@ -20,6 +21,10 @@ namespace MWDialogue
             MWWorld::Ptr mActor;
             int mChoice;
             bool mTalkedToPlayer;
+            const InfoIndex *mIndex;
+
+            void getCandidates (const ESM::Dialogue& dialogue, std::vector<const ESM::DialInfo *>& candidates) const;
+            ///< Get the infos of \a dialogue that can match the actor, using the index if there is one.
 
             bool testActor (const ESM::DialInfo& info) const;
             ///< Is this the right actor for this \a info?
@@ -53,7 +58,7 @@ namespace MWDialogue
 
         public:
 
-            Filter (const MWWorld::Ptr& actor, int choice, bool talkedToPlayer);
+            Filter (const MWWorld::Ptr& actor, int choice, bool talkedToPlayer, const InfoIndex *index = NULL);
 
             std::vector<const ESM::DialInfo *> list (const ESM::Dialogue& dialogue,
                 bool fallbackToInfoRefusal, bool searchAll, bool invertDisposition=false) const;
@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 
+#include "keywordsearch.hpp"
+
 namespace MWDialogue
 {
     namespace HyperTextParser
@@ -27,8 +29,8 @@ namespace MWDialogue
 
         // In translations (at least Russian) the links are marked with @#, so
         // it should be a function to parse it
-        std::vector<Token> parseHyperText(const std::string & text);
-        void tokenizeKeywords(const std::string & text, std::vector<Token> & tokens);
+        std::vector<Token> parseHyperText(const std::string & text, KeywordSearch<std::string, int /*unused*/> & keywordSearch);
+        void tokenizeKeywords(const std::string & text, std::vector<Token> & tokens, KeywordSearch<std::string, int /*unused*/> & keywordSearch);
         size_t removePseudoAsterisks(std::string & phrase);
     }
 }
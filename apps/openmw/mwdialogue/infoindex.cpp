@@ -0,0 +1,96 @@
+#include "infoindex.hpp"
+
+#include <algorithm>
+
+#include <components/esm/loaddial.hpp>
+#include <components/esm/loadnpc.hpp>
+#include <components/misc/stringops.hpp>
+
+#include "../mwworld/class.hpp"
+#include "../mwworld/store.hpp"
+
+namespace MWDialogue
+{
+    InfoIndex::InfoIndex (const MWWorld::Store<ESM::Dialogue>& dialogues)
+    {
+        for (MWWorld::Store<ESM::Dialogue>::iterator iter = dialogues.begin(); iter != dialogues.end(); ++iter)
+        {
+            DialogueIndex& index = mDialogues[&*iter];
+
+            int position = 0;
+            for (ESM::Dialogue::InfoContainer::const_iterator infoIter = iter->mInfo.begin();
+                infoIter != iter->mInfo.end(); ++infoIter, ++position)
+            {
+                const ESM::DialInfo& info = *infoIter;
+
+                Entry entry;
+                entry.mPosition = position;
+                entry.mInfo = &info;
+
+                // Each info is stored under the most selective of its speaker conditions only
+                if (!info.mActor.empty())
+                    index.mByActor[Misc::StringUtils::lowerCase (info.mActor)].push_back (entry);
+                else if (info.mFactionLess)
+                    index.mByFaction[""].push_back (entry);
+                else if (!info.mFaction.empty())
+                    index.mByFaction[Misc::StringUtils::lowerCase (info.mFaction)].push_back (entry);
+                else if (!info.mClass.empty())
+                    index.mByClass[Misc::StringUtils::lowerCase (info.mClass)].push_back (entry);
+                else if (!info.mRace.empty())
+                    index.mByRace[Misc::StringUtils::lowerCase (info.mRace)].push_back (entry);
+                else if (info.mData.mGender >= ESM::DialInfo::NA && info.mData.mGender <= ESM::DialInfo::Female)
+                    index.mByGender[info.mData.mGender + 1].push_back (entry);
+                else
+                    index.mByGender[0].push_back (entry);
+            }
+        }
+    }
+
+    void InfoIndex::addBucket (const Buckets& buckets, const std::string& key, std::vector<Entry>& entries)
+    {
+        Buckets::const_iterator iter = buckets.find (key);
+        if (iter != buckets.end())
+            entries.insert (entries.end(), iter->second.begin(), iter->second.end());
+    }
+
+    void InfoIndex::getCandidates (const ESM::Dialogue& dialogue, const MWWorld::ConstPtr& actor,
+        std::vector<const ESM::DialInfo *>& candidates) const
+    {
+        std::map<const ESM::Dialogue *, DialogueIndex>::const_iterator found = mDialogues.find (&dialogue);
+        if (found == mDialogues.end())
+        {
+            // Not known to the index, let the filter test everything
+            for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin();
+                iter != dialogue.mInfo.end(); ++iter)
+                candidates.push_back (&*iter);
+            return;
+        }
+
+        const DialogueIndex& index = found->second;
+
+        std::vector<Entry> entries;
+        addBucket (index.mByActor, Misc::StringUtils::lowerCase (actor.getCellRef().getRefId()), entries);
+
+        // Creatures only ever use infos specific to their ID
+        if (actor.getTypeName() == typeid (ESM::NPC).name())
+        {
+            const ESM::NPC *npc = actor.get<ESM::NPC>()->mBase;
+
+            addBucket (index.mByFaction, Misc::StringUtils::lowerCase (actor.getClass().getPrimaryFaction (actor)), entries);
+            addBucket (index.mByClass, Misc::StringUtils::lowerCase (npc->mClass), entries);
+            addBucket (index.mByRace, Misc::StringUtils::lowerCase (npc->mRace), entries);
+
+            bool female = (npc->mFlags & ESM::NPC::Female) != 0;
+            const std::vector<Entry>& sameGender = index.mByGender[(female ? ESM::DialInfo::Female : ESM::DialInfo::Male) + 1];
+            const std::vector<Entry>& anyGender = index.mByGender[ESM::DialInfo::NA + 1];
+            entries.insert (entries.end(), sameGender.begin(), sameGender.end());
+            entries.insert (entries.end(), anyGender.begin(), anyGender.end());
+        }
+
+        std::sort (entries.begin(), entries.end());
+
+        candidates.reserve (candidates.size() + entries.size());
+        for (std::vector<Entry>::const_iterator iter = entries.begin(); iter != entries.end(); ++iter)
+            candidates.push_back (iter->mInfo);
+    }
+}
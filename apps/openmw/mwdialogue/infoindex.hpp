@@ -0,0 +1,62 @@
+#ifndef GAME_MWDIALOGUE_INFOINDEX_H
+#define GAME_MWDIALOGUE_INFOINDEX_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ESM
+{
+    struct DialInfo;
+    struct Dialogue;
+}
+
+namespace MWWorld
+{
+    class ConstPtr;
+    template <class T> class Store;
+}
+
+namespace MWDialogue
+{
+    /// \brief Groups the infos of each dialogue by the static properties of the speaker they are meant for
+    ///
+    /// An info can only be given by an actor matching its actor ID, faction, class, race and gender. None of these
+    /// change during a game, so they are looked up once here instead of being tested against every info of a
+    /// dialogue whenever a filter runs. The remaining conditions still have to be tested by the Filter.
+    class InfoIndex
+    {
+            struct Entry
+            {
+                int mPosition; ///< in ESM::Dialogue::mInfo, to restore the original order of the infos
+                const ESM::DialInfo *mInfo;
+
+                bool operator< (const Entry& other) const { return mPosition < other.mPosition; }
+            };
+
+            typedef std::map<std::string, std::vector<Entry> > Buckets;
+
+            struct DialogueIndex
+            {
+                Buckets mByActor;
+                Buckets mByFaction; ///< faction-less infos are stored with an empty faction
+                Buckets mByClass;
+                Buckets mByRace;
+                std::vector<Entry> mByGender[3]; ///< all other infos, indexed by ESM::DialInfo::Gender + 1
+            };
+
+            std::map<const ESM::Dialogue *, DialogueIndex> mDialogues;
+
+            static void addBucket (const Buckets& buckets, const std::string& key, std::vector<Entry>& entries);
+
+        public:
+
+            InfoIndex (const MWWorld::Store<ESM::Dialogue>& dialogues);
+
+            void getCandidates (const ESM::Dialogue& dialogue, const MWWorld::ConstPtr& actor,
+                std::vector<const ESM::DialInfo *>& candidates) const;
+            ///< Get the infos of \a dialogue that \a actor could give, in their original order.
+    };
+}
+
+#endif
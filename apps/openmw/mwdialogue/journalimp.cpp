@@ -13,6 +13,7 @@
 #include "../mwbase/environment.hpp"
 #include "../mwbase/world.hpp"
 #include "../mwbase/windowmanager.hpp"
+#include "../mwbase/dialoguemanager.hpp"
 
 #include "../mwgui/messagebox.hpp"
 
@@ -137,6 +138,8 @@ namespace MWDialogue
         Quest& quest = getQuest (id);
         quest.addEntry (entry); // we are doing slicing on purpose here
 
+        MWBase::Environment::get().getDialogueManager()->notifyJournalChanged (id);
+
         // there is no need to show empty entries in journal
         if (!entry.getText().empty())
         {
@@ -150,6 +153,8 @@ namespace MWDialogue
         Quest& quest = getQuest (id);
 
         quest.setIndex (index);
+
+        MWBase::Environment::get().getDialogueManager()->notifyJournalChanged (id);
     }
 
     void Journal::addTopic (const std::string& topicId, const std::string& infoId, const MWWorld::Ptr& actor)
@@ -5,13 +5,18 @@
 #include <cctype>
 #include <stdexcept>
 #include <vector>
-#include <algorithm>    // std::reverse
+#include <algorithm>
 
 #include <components/misc/stringops.hpp>
 
 namespace MWDialogue
 {
 
+/// \brief Finds keywords in a text, case-insensitively and only at the start of words
+///
+/// The keywords are compiled into an Aho-Corasick automaton the first time the search is used after seeding, so
+/// a text is scanned in a single pass regardless of how many keywords there are. The automaton is stored flat:
+/// the transitions of each state are a sorted range of one array.
 template <typename string_t, typename value_t>
 class KeywordSearch
 {
@@ -26,46 +31,45 @@ public:
         value_t mValue;
     };
 
+    KeywordSearch() : mBuilt (false) {}
+
     void seed (string_t keyword, value_t value)
     {
         if (keyword.empty())
             return;
-        seed_impl  (/*std::move*/ (keyword), /*std::move*/ (value), 0, mRoot);
+
+        Keyword entry;
+        entry.mKeyword = /*std::move*/ (keyword);
+        entry.mValue = /*std::move*/ (value);
+        mKeywords.push_back (entry);
+        mBuilt = false;
     }
 
     void clear ()
     {
-        mRoot.mChildren.clear ();
-        mRoot.mKeyword.clear ();
+        mKeywords.clear ();
+        mStates.clear ();
+        mEdges.clear ();
+        mRootTransitions.clear ();
+        mBuilt = false;
     }
 
     bool containsKeyword (string_t keyword, value_t& value)
     {
-        typename Entry::childen_t::iterator current;
-        typename Entry::childen_t::iterator next;
+        build ();
 
-        current = mRoot.mChildren.find (Misc::StringUtils::toLower (*keyword.begin()));
-        if (current == mRoot.mChildren.end())
+        if (keyword.empty())
             return false;
-        else if (current->second.mKeyword.size() && Misc::StringUtils::ciEqual(current->second.mKeyword, keyword))
-        {
-            value = current->second.mValue;
-            return true;
-        }
 
-        for (Point i = ++keyword.begin(); i != keyword.end(); ++i)
-        {
-            next = current->second.mChildren.find(Misc::StringUtils::toLower (*i));
-            if (next == current->second.mChildren.end())
-                return false;
-            if (Misc::StringUtils::ciEqual(next->second.mKeyword, keyword))
-            {
-                value = next->second.mValue;
-                return true;
-            }
-            current = next;
-        }
-        return false;
+        int state = 0;
+        for (Point i = keyword.begin(); i != keyword.end() && state != -1; ++i)
+            state = getChild (state, Misc::StringUtils::toLower (*i));
+
+        if (state == -1 || mStates[state].mKeyword == -1)
+            return false;
+
+        value = mKeywords[mStates[state].mKeyword].mValue;
+        return true;
     }
 
     static bool sortMatches(const Match& left, const Match& right)
@@ -75,86 +79,53 @@ public:
 
     void highlightKeywords (Point beg, Point end, std::vector<Match>& out)
     {
-        std::vector<Match> matches;
-        for (Point i = beg; i != end; ++i)
-        {
-            // check if previous character marked start of new word
-            if (i != beg)
-            {
-                Point prev = i;
-                --prev;
-                if(isalpha(*prev))
-                    continue;
-            }
-
+        build ();
 
-            // check first character
-            typename Entry::childen_t::iterator candidate = mRoot.mChildren.find (Misc::StringUtils::toLower (*i));
+        // state ending the longest keyword found at each position of the text, if it starts a word there
+        std::vector<int> longest (end - beg, -1);
 
-            // no match, on to next character
-            if (candidate == mRoot.mChildren.end ())
+        int state = 0;
+        for (Point i = beg; i != end; ++i)
+        {
+            // a keyword starting within a word would be discarded anyway
+            if (state == 0 && i != beg && isalpha(*(i - 1)))
                 continue;
 
-            // see how far the match goes
-            Point j = i;
+            state = getTransition (state, Misc::StringUtils::toLower (*i));
 
-            // some keywords might be longer variations of other keywords, so we definitely need a list of candidates
-            // the first element in the pair is length of the match, i.e. depth from the first character on
-            std::vector< typename std::pair<int, typename Entry::childen_t::iterator> > candidates;
-
-            while ((j + 1) != end)
+            // all keywords ending here, from the longest to the shortest
+            int found = mStates[state].mKeyword != -1 ? state : mStates[state].mOutput;
+            for (; found != -1; found = mStates[found].mOutput)
             {
-                typename Entry::childen_t::iterator next = candidate->second.mChildren.find (Misc::StringUtils::toLower (*++j));
+                Point keywordBeg = i - (mStates[found].mDepth - 1);
 
-                if (next == candidate->second.mChildren.end ())
+                // check if previous character marked start of new word
+                if (keywordBeg != beg)
                 {
-                    if (candidate->second.mKeyword.size() > 0)
-                        candidates.push_back(std::make_pair((j-i), candidate));
-                    break;
+                    Point prev = keywordBeg;
+                    --prev;
+                    if (isalpha(*prev))
+                        continue;
                 }
 
-                candidate = next;
-
-                if (candidate->second.mKeyword.size() > 0)
-                    candidates.push_back(std::make_pair((j-i), candidate));
+                // a keyword found later at the same position is always longer
+                longest[keywordBeg - beg] = found;
             }
+        }
 
-            if (candidates.empty())
-                continue; // didn't match enough to disambiguate, on to next character
-
-            // shorter candidates will be added to the vector first. however, we want to check against longer candidates first
-            std::reverse(candidates.begin(), candidates.end());
-
-            for (typename std::vector< std::pair<int, typename Entry::childen_t::iterator> >::iterator it = candidates.begin();
-                 it != candidates.end(); ++it)
-            {
-                candidate = it->second;
-                // try to match the rest of the keyword
-                Point k = i + it->first;
-                typename string_t::const_iterator t = candidate->second.mKeyword.begin () + (k - i);
-
-
-                while (k != end && t != candidate->second.mKeyword.end ())
-                {
-                    if (Misc::StringUtils::toLower (*k) != Misc::StringUtils::toLower (*t))
-                        break;
-
-                    ++k, ++t;
-                }
+        // there might still be longer keywords that start somewhere _within_ a keyword
+        std::vector<Match> matches;
+        for (size_t i = 0; i < longest.size(); ++i)
+        {
+            if (longest[i] == -1)
+                continue;
 
-                // didn't match full keyword, try the next candidate
-                if (t != candidate->second.mKeyword.end ())
-                    continue;
-
-                // found a keyword, but there might still be longer keywords that start somewhere _within_ this keyword
-                // we will resolve these overlapping keywords later, choosing the longest one in case of conflict
-                Match match;
-                match.mValue = candidate->second.mValue;
-                match.mBeg = i;
-                match.mEnd = k;
-                matches.push_back(match);
-                break;
-            }
+            const State& found = mStates[longest[i]];
+            Match match;
+            match.mValue = mKeywords[found.mKeyword].mValue;
+            match.mBeg = beg + i;
+            match.mEnd = match.mBeg + found.mDepth;
+            matches.push_back(match);
         }
 
         // resolve overlapping keywords
@@ -187,9 +158,10 @@ public:
             matches.erase(longestKeyword);
             out.push_back(keyword);
             // erase anything that overlaps with the keyword we just added to the output
-            for (typename std::vector<Match>::iterator it = matches.begin(); it != matches.end();)
+            // the matches are sorted, so none of those after the end of the keyword can overlap
+            for (typename std::vector<Match>::iterator it = matches.begin(); it != matches.end() && it->mBeg < keyword.mEnd;)
             {
-                if (it->mBeg < keyword.mEnd && it->mEnd > keyword.mBeg)
+                if (it->mEnd > keyword.mBeg)
                     it = matches.erase(it);
                 else
                     ++it;
@@ -201,54 +173,170 @@ public:
 
 private:
 
-    struct Entry
-    {
-        typedef std::map <wchar_t, Entry> childen_t;
+    typedef typename string_t::value_type char_t;
 
+    struct Keyword
+    {
         string_t mKeyword;
         value_t mValue;
-        childen_t mChildren;
     };
 
-    void seed_impl (string_t keyword, value_t value, size_t depth, Entry  & entry)
+    struct State
+    {
+        int mFirstEdge; ///< index of the first transition in mEdges
+        int mEdgeCount;
+        int mDepth;     ///< length of the text leading to this state
+        int mFailure;   ///< state for the longest proper suffix of that text, used when there is no transition
+        int mOutput;    ///< next state along the failure links that ends a keyword, or -1
+        int mKeyword;   ///< index of the keyword ending in this state, or -1
+    };
+
+    struct Edge
+    {
+        char_t mChar;
+        int mTarget;
+
+        bool operator< (const Edge& other) const { return mChar < other.mChar; }
+    };
+
+    /// @return state reached from \a state through character \a ch, or -1 if there is no such transition
+    int getChild (int state, char_t ch) const
+    {
+        if (state == 0 && isByte (ch))
+            return mRootTransitions[static_cast<unsigned char> (ch)];
+
+        typename std::vector<Edge>::const_iterator first = mEdges.begin() + mStates[state].mFirstEdge;
+        typename std::vector<Edge>::const_iterator last = first + mStates[state].mEdgeCount;
+
+        Edge edge;
+        edge.mChar = ch;
+        typename std::vector<Edge>::const_iterator found = std::lower_bound (first, last, edge);
+
+        return (found != last && found->mChar == ch) ? found->mTarget : -1;
+    }
+
+    static bool isByte (char_t ch)
+    {
+        return static_cast<unsigned char> (ch) == ch;
+    }
+
+    /// @return state of the automaton after reading character \a ch in \a state
+    int getTransition (int state, char_t ch) const
+    {
+        for (;;)
+        {
+            int next = getChild (state, ch);
+            if (next != -1)
+                return next;
+            if (state == 0)
+                return 0;
+            state = mStates[state].mFailure;
+        }
+    }
+
+    /// Compile the seeded keywords, unless this has already been done.
+    void build ()
     {
-        int ch = Misc::StringUtils::toLower (keyword.at (depth));
+        if (mBuilt)
+            return;
 
-        typename Entry::childen_t::iterator j = entry.mChildren.find (ch);
+        // build the trie, the transitions of a state can only be stored flat once they are all known
+        std::vector<std::map<char_t, int> > children (1);
+        std::vector<int> keywords (1, -1);
+        std::vector<int> depths (1, 0);
 
-        if (j == entry.mChildren.end ())
+        for (size_t i = 0; i < mKeywords.size(); ++i)
         {
-            entry.mChildren [ch].mValue = /*std::move*/ (value);
-            entry.mChildren [ch].mKeyword = /*std::move*/ (keyword);
+            const string_t& keyword = mKeywords[i].mKeyword;
+
+            int state = 0;
+            for (Point j = keyword.begin(); j != keyword.end(); ++j)
+            {
+                char_t ch = Misc::StringUtils::toLower (*j);
+                typename std::map<char_t, int>::const_iterator found = children[state].find (ch);
+
+                if (found != children[state].end())
+                    state = found->second;
+                else
+                {
+                    int child = static_cast<int> (children.size());
+                    children[state][ch] = child;
+                    children.push_back (std::map<char_t, int>());
+                    keywords.push_back (-1);
+                    depths.push_back (depths[state] + 1);
+                    state = child;
+                }
+            }
+
+            if (keywords[state] != -1)
+                throw std::runtime_error ("duplicate keyword inserted");
+
+            keywords[state] = static_cast<int> (i);
         }
-        else
+
+        mStates.resize (children.size());
+        mEdges.clear ();
+
+        for (size_t i = 0; i < children.size(); ++i)
         {
-            if (j->second.mKeyword.size () > 0)
+            State& state = mStates[i];
+            state.mFirstEdge = static_cast<int> (mEdges.size());
+            state.mEdgeCount = static_cast<int> (children[i].size());
+            state.mDepth = depths[i];
+            state.mFailure = 0;
+            state.mOutput = -1;
+            state.mKeyword = keywords[i];
+
+            for (typename std::map<char_t, int>::const_iterator iter = children[i].begin();
+                iter != children[i].end(); ++iter)
             {
-                if (keyword == j->second.mKeyword)
-                    throw std::runtime_error ("duplicate keyword inserted");
+                Edge edge;
+                edge.mChar = iter->first;
+                edge.mTarget = iter->second;
+                mEdges.push_back (edge);
+            }
+        }
+
+        // most characters of a text leave the automaton in the root state, look these up directly
+        mRootTransitions.assign (256, -1);
+        for (int i = 0; i < mStates[0].mEdgeCount; ++i)
+        {
+            const Edge& edge = mEdges[mStates[0].mFirstEdge + i];
+            if (isByte (edge.mChar))
+                mRootTransitions[static_cast<unsigned char> (edge.mChar)] = edge.mTarget;
+        }
 
-                value_t pushValue = /*std::move*/ (j->second.mValue);
-                string_t pushKeyword = /*std::move*/ (j->second.mKeyword);
+        // failure links, breadth-first so that the links of all shallower states are known already
+        std::vector<int> queue (1, 0);
+        for (size_t i = 0; i < queue.size(); ++i)
+        {
+            const State& state = mStates[queue[i]];
 
-                if (depth >= pushKeyword.size ())
-                    throw std::runtime_error ("unexpected");
+            for (int j = state.mFirstEdge; j < state.mFirstEdge + state.mEdgeCount; ++j)
+            {
+                const Edge& edge = mEdges[j];
+                State& child = mStates[edge.mTarget];
 
-                if (depth+1 < pushKeyword.size())
+                if (queue[i] != 0)
                 {
-                    seed_impl (/*std::move*/ (pushKeyword), /*std::move*/ (pushValue), depth+1, j->second);
-                    j->second.mKeyword.clear ();
+                    child.mFailure = getTransition (state.mFailure, edge.mChar);
+
+                    const State& failure = mStates[child.mFailure];
+                    child.mOutput = failure.mKeyword != -1 ? child.mFailure : failure.mOutput;
                 }
+
+                queue.push_back (edge.mTarget);
             }
-            if (depth+1 == keyword.size())
-                j->second.mKeyword = value;
-            else // depth+1 < keyword.size()
-                seed_impl (/*std::move*/ (keyword), /*std::move*/ (value), depth+1, j->second);
         }
 
+        mBuilt = true;
     }
 
-    Entry mRoot;
+    std::vector<Keyword> mKeywords;
+    std::vector<State> mStates; ///< state 0 is the root
+    std::vector<Edge> mEdges;
+    std::vector<int> mRootTransitions; ///< transitions of the root state for characters representable as a byte
+    bool mBuilt;
 };
 
 }
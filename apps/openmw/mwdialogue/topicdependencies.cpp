@@ -0,0 +1,134 @@
+#include "topicdependencies.hpp"
+
+#include <components/esm/loaddial.hpp>
+#include <components/misc/stringops.hpp>
+
+#include "../mwworld/store.hpp"
+
+#include "selectwrapper.hpp"
+
+namespace
+{
+    /// Globals the world advances by itself as time passes, without reporting the change
+    bool isTimeGlobal (const std::string& name)
+    {
+        return name == "gamehour" || name == "dayspassed" || name == "day" || name == "month" || name == "year";
+    }
+}
+
+namespace MWDialogue
+{
+    TopicDependencies::TopicDependencies (const MWWorld::Store<ESM::Dialogue>& dialogues)
+    {
+        for (MWWorld::Store<ESM::Dialogue>::iterator iter = dialogues.begin(); iter != dialogues.end(); ++iter)
+        {
+            if (iter->mType != ESM::Dialogue::Topic)
+                continue;
+
+            bool isVolatile = false;
+
+            for (ESM::Dialogue::InfoContainer::const_iterator infoIter = iter->mInfo.begin();
+                infoIter != iter->mInfo.end(); ++infoIter)
+            {
+                if (addInfo (&*iter, *infoIter))
+                    isVolatile = true;
+            }
+
+            if (isVolatile)
+                mVolatile.push_back (&*iter);
+        }
+    }
+
+    bool TopicDependencies::addInfo (const ESM::Dialogue *topic, const ESM::DialInfo& info)
+    {
+        // Faction ranks and the player's cell
+        bool isVolatile = !info.mPcFaction.empty() || info.mData.mPCrank != -1 || info.mData.mRank != -1 ||
+            !info.mCell.empty();
+
+        for (std::vector<ESM::DialInfo::SelectStruct>::const_iterator iter (info.mSelects.begin());
+            iter != info.mSelects.end(); ++iter)
+        {
+            SelectWrapper select (*iter);
+
+            switch (select.getFunction())
+            {
+                case SelectWrapper::Function_Global:
+
+                    if (isTimeGlobal (select.getName()))
+                        isVolatile = true;
+                    else
+                        addReader (mGlobals, select.getName(), topic);
+                    break;
+
+                case SelectWrapper::Function_Journal:
+
+                    addReader (mJournals, select.getName(), topic);
+                    break;
+
+                case SelectWrapper::Function_Item:
+
+                    addReader (mItems, select.getName(), topic);
+                    break;
+
+                // Fixed for the duration of a conversation
+                case SelectWrapper::Function_None:
+                case SelectWrapper::Function_False:
+                case SelectWrapper::Function_Choice:
+                case SelectWrapper::Function_TalkedToPc:
+                case SelectWrapper::Function_NotId:
+                case SelectWrapper::Function_NotFaction:
+                case SelectWrapper::Function_NotClass:
+                case SelectWrapper::Function_NotRace:
+                case SelectWrapper::Function_SameGender:
+                case SelectWrapper::Function_SameRace:
+                case SelectWrapper::Function_PcGender:
+
+                    break;
+
+                default:
+
+                    isVolatile = true;
+                    break;
+            }
+        }
+
+        return isVolatile;
+    }
+
+    void TopicDependencies::addReader (Readers& readers, const std::string& key, const ESM::Dialogue *topic)
+    {
+        std::vector<const ESM::Dialogue *>& topics = readers[key];
+
+        // Infos of the same topic are added one after another
+        if (topics.empty() || topics.back() != topic)
+            topics.push_back (topic);
+    }
+
+    void TopicDependencies::getReaders (const Readers& readers, const std::string& key,
+        std::set<const ESM::Dialogue *>& topics)
+    {
+        Readers::const_iterator iter = readers.find (Misc::StringUtils::lowerCase (key));
+        if (iter != readers.end())
+            topics.insert (iter->second.begin(), iter->second.end());
+    }
+
+    void TopicDependencies::getGlobalReaders (const std::string& name, std::set<const ESM::Dialogue *>& topics) const
+    {
+        getReaders (mGlobals, name, topics);
+    }
+
+    void TopicDependencies::getJournalReaders (const std::string& id, std::set<const ESM::Dialogue *>& topics) const
+    {
+        getReaders (mJournals, id, topics);
+    }
+
+    void TopicDependencies::getItemReaders (const std::string& id, std::set<const ESM::Dialogue *>& topics) const
+    {
+        getReaders (mItems, id, topics);
+    }
+
+    void TopicDependencies::getVolatileTopics (std::set<const ESM::Dialogue *>& topics) const
+    {
+        topics.insert (mVolatile.begin(), mVolatile.end());
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef GAME_MWDIALOGUE_TOPICDEPENDENCIES_H
+#define GAME_MWDIALOGUE_TOPICDEPENDENCIES_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ESM
+{
+    struct DialInfo;
+    struct Dialogue;
+}
+
+namespace MWWorld
+{
+    template <class T> class Store;
+}
+
+namespace MWDialogue
+{
+    /// \brief Records which mutable inputs the infos of each topic read
+    ///
+    /// Whether a topic is available to the current actor only changes when one of the inputs its infos test
+    /// changes. Global variables, journal indices and the player's item counts report their changes to the
+    /// dialogue manager, so topics only depending on these (and on the static properties of the speaker) need
+    /// to be tested again only when one of them is changed. Topics reading any other mutable input (stats,
+    /// faction ranks, local variables, ...) are volatile and have to be tested again after anything that could
+    /// have changed it.
+    class TopicDependencies
+    {
+            typedef std::map<std::string, std::vector<const ESM::Dialogue *> > Readers;
+
+            Readers mGlobals;
+            Readers mJournals;
+            Readers mItems;
+            std::vector<const ESM::Dialogue *> mVolatile;
+
+            /// Add the inputs read by \a info to the dependencies of \a topic.
+            /// \return Does \a info read an input without change notification?
+            bool addInfo (const ESM::Dialogue *topic, const ESM::DialInfo& info);
+
+            static void addReader (Readers& readers, const std::string& key, const ESM::Dialogue *topic);
+
+            static void getReaders (const Readers& readers, const std::string& key,
+                std::set<const ESM::Dialogue *>& topics);
+
+        public:
+
+            TopicDependencies (const MWWorld::Store<ESM::Dialogue>& dialogues);
+
+            void getGlobalReaders (const std::string& name, std::set<const ESM::Dialogue *>& topics) const;
+            ///< Add the topics testing global variable \a name to \a topics.
+
+            void getJournalReaders (const std::string& id, std::set<const ESM::Dialogue *>& topics) const;
+            ///< Add the topics testing the index of journal \a id to \a topics.
+
+            void getItemReaders (const std::string& id, std::set<const ESM::Dialogue *>& topics) const;
+            ///< Add the topics testing how many items \a id the player has to \a topics.
+
+            void getVolatileTopics (std::set<const ESM::Dialogue *>& topics) const;
+            ///< Add the topics reading inputs that do not report their changes to \a topics.
+    };
+}
+
+#endif
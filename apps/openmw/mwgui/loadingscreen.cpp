@@ -321,6 +321,10 @@ namespace MWGui
         if (mVisible && !needToDrawLoadingScreen())
             return;
 
+        // Nothing to draw into without a graphics context (headless benchmark runs)
+        if (!mViewer->getCamera()->getGraphicsContext())
+            return;
+
         if (mShowWallpaper && mTimer.time_m() > mLastWallpaperChangeTime + 5000*1)
         {
             mLastWallpaperChangeTime = mTimer.time_m();
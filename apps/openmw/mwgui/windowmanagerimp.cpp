@@ -257,17 +257,21 @@ namespace MWGui
         mLoadingScreen = new LoadingScreen(mResourceSystem->getVFS(), mViewer);
         mWindows.push_back(mLoadingScreen);
 
-        //set up the hardware cursor manager
-        mCursorManager = new SDLUtil::SDLCursorManager();
+        //set up the hardware cursor manager, unless there is no window to show it in (headless benchmark runs)
+        if (mViewer->getCamera()->getGraphicsContext())
+            mCursorManager = new SDLUtil::SDLCursorManager();
 
         MyGUI::PointerManager::getInstance().eventChangeMousePointer += MyGUI::newDelegate(this, &WindowManager::onCursorChange);
 
         MyGUI::InputManager::getInstance().eventChangeKeyFocus += MyGUI::newDelegate(this, &WindowManager::onKeyFocusChanged);
 
         // Create all cursors in advance
-        createCursors();
-        onCursorChange(MyGUI::PointerManager::getInstance().getDefaultPointer());
-        mCursorManager->setEnabled(true);
+        if (mCursorManager)
+        {
+            createCursors();
+            onCursorChange(MyGUI::PointerManager::getInstance().getDefaultPointer());
+            mCursorManager->setEnabled(true);
+        }
 
         // hide mygui's pointer
         MyGUI::PointerManager::getInstance().setVisible(false);
@@ -799,7 +803,8 @@ namespace MWGui
         mMessageBoxManager->createInteractiveMessageBox(message, buttons);
         updateVisible();
 
-        if (block)
+        // Nobody can answer the box in a headless benchmark run, so it behaves as if no button was pressed
+        if (block && mViewer->getCamera()->getGraphicsContext())
         {
             osg::Timer frameTimer;
             while (mMessageBoxManager->readPressedButton(false) == -1
@@ -1213,7 +1218,8 @@ namespace MWGui
 
     void WindowManager::onCursorChange(const std::string &name)
     {
-        mCursorManager->cursorChanged(name);
+        if (mCursorManager)
+            mCursorManager->cursorChanged(name);
     }
 
     void WindowManager::pushGuiMode(GuiMode mode)
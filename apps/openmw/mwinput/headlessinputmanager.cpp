@@ -0,0 +1,111 @@
+#include "headlessinputmanager.hpp"
+
+#include <components/esm/esmwriter.hpp>
+#include <components/esm/esmreader.hpp>
+#include <components/esm/controlsstate.hpp>
+
+#include "../mwbase/world.hpp"
+#include "../mwbase/windowmanager.hpp"
+#include "../mwbase/statemanager.hpp"
+#include "../mwbase/environment.hpp"
+
+#include "../mwworld/player.hpp"
+
+namespace MWInput
+{
+    HeadlessInputManager::HeadlessInputManager()
+    {
+        mControlSwitch["playercontrols"]      = true;
+        mControlSwitch["playerfighting"]      = true;
+        mControlSwitch["playerjumping"]       = true;
+        mControlSwitch["playerlooking"]       = true;
+        mControlSwitch["playermagic"]         = true;
+        mControlSwitch["playerviewswitch"]    = true;
+        mControlSwitch["vanitymode"]          = true;
+    }
+
+    void HeadlessInputManager::clear()
+    {
+        // Enable all controls
+        for (std::map<std::string, bool>::iterator it = mControlSwitch.begin(); it != mControlSwitch.end(); ++it)
+            it->second = true;
+    }
+
+    void HeadlessInputManager::update(float dt, bool disableControls, bool disableEvents)
+    {
+        if (disableControls)
+            return;
+
+        // Disable movement in Gui mode, same as the real input manager
+        if (MWBase::Environment::get().getWindowManager()->isGuiMode()
+            || MWBase::Environment::get().getStateManager()->getState() != MWBase::StateManager::State_Running)
+            return;
+
+        if (!mControlSwitch["playercontrols"])
+            return;
+
+        MWWorld::Player& player = MWBase::Environment::get().getWorld()->getPlayer();
+        player.setAutoMove(true);
+        player.setForwardBackward(1);
+    }
+
+    bool HeadlessInputManager::getControlSwitch (const std::string& sw)
+    {
+        return mControlSwitch[sw];
+    }
+
+    void HeadlessInputManager::toggleControlSwitch (const std::string& sw, bool value)
+    {
+        if (mControlSwitch[sw] == value)
+            return;
+
+        if (sw == "playercontrols" && !value)
+        {
+            MWWorld::Player& player = MWBase::Environment::get().getWorld()->getPlayer();
+            player.setLeftRight(0);
+            player.setForwardBackward(0);
+            player.setAutoMove(false);
+            player.setUpDown(0);
+        }
+
+        mControlSwitch[sw] = value;
+    }
+
+    int HeadlessInputManager::countSavedGameRecords() const
+    {
+        return 1;
+    }
+
+    void HeadlessInputManager::write(ESM::ESMWriter& writer, Loading::Listener& /*progress*/)
+    {
+        ESM::ControlsState controls;
+        controls.mViewSwitchDisabled = !getControlSwitch("playerviewswitch");
+        controls.mControlsDisabled = !getControlSwitch("playercontrols");
+        controls.mJumpingDisabled = !getControlSwitch("playerjumping");
+        controls.mLookingDisabled = !getControlSwitch("playerlooking");
+        controls.mVanityModeDisabled = !getControlSwitch("vanitymode");
+        controls.mWeaponDrawingDisabled = !getControlSwitch("playerfighting");
+        controls.mSpellDrawingDisabled = !getControlSwitch("playermagic");
+
+        writer.startRecord (ESM::REC_INPU);
+        controls.save(writer);
+        writer.endRecord (ESM::REC_INPU);
+    }
+
+    void HeadlessInputManager::readRecord(ESM::ESMReader& reader, uint32_t type)
+    {
+        if (type == ESM::REC_INPU)
+        {
+            ESM::ControlsState controls;
+            controls.load(reader);
+
+            toggleControlSwitch("playerviewswitch", !controls.mViewSwitchDisabled);
+            toggleControlSwitch("playercontrols", !controls.mControlsDisabled);
+            toggleControlSwitch("playerjumping", !controls.mJumpingDisabled);
+            toggleControlSwitch("playerlooking", !controls.mLookingDisabled);
+            toggleControlSwitch("vanitymode", !controls.mVanityModeDisabled);
+            toggleControlSwitch("playerfighting", !controls.mWeaponDrawingDisabled);
+            toggleControlSwitch("playermagic", !controls.mSpellDrawingDisabled);
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef MWINPUT_HEADLESSINPUTMANAGER_H
+#define MWINPUT_HEADLESSINPUTMANAGER_H
+
+#include <map>
+
+#include "../mwbase/inputmanager.hpp"
+
+namespace MWInput
+{
+    /**
+    * @brief Input manager for runs without a window, such as --benchmark-frames.
+    *
+    * There are no input devices: the player just keeps walking forward, as with the auto move key.
+    * The control switches are kept and saved like in the real input manager, so scripts and saved games behave the same.
+    */
+    class HeadlessInputManager : public MWBase::InputManager
+    {
+    public:
+        HeadlessInputManager();
+
+        virtual bool isWindowVisible() { return false; }
+
+        /// Clear all savegame-specific data
+        virtual void clear();
+
+        virtual void update(float dt, bool disableControls=false, bool disableEvents=false);
+
+        virtual void changeInputMode(bool guiMode) {}
+
+        virtual void processChangedSettings(const std::set< std::pair<std::string, std::string> >& changed) {}
+
+        virtual void setDragDrop(bool dragDrop) {}
+
+        virtual void toggleControlSwitch (const std::string& sw, bool value);
+        virtual bool getControlSwitch (const std::string& sw);
+
+        virtual std::string getActionDescription (int action) { return std::string(); }
+        virtual std::string getActionKeyBindingName (int action) { return std::string(); }
+        virtual std::string getActionControllerBindingName (int action) { return std::string(); }
+        virtual std::string sdlControllerAxisToString(int axis) { return std::string(); }
+        virtual std::string sdlControllerButtonToString(int button) { return std::string(); }
+        virtual std::vector<int> getActionKeySorting() { return std::vector<int>(); }
+        virtual std::vector<int> getActionControllerSorting() { return std::vector<int>(); }
+        virtual int getNumActions() { return 0; }
+        virtual void enableDetectingBindingMode (int action, bool keyboard) {}
+        virtual void resetToDefaultKeyBindings() {}
+        virtual void resetToDefaultControllerBindings() {}
+
+        virtual bool joystickLastUsed() { return false; }
+
+        virtual int countSavedGameRecords() const;
+        virtual void write(ESM::ESMWriter& writer, Loading::Listener& progress);
+        virtual void readRecord(ESM::ESMReader& reader, uint32_t type);
+
+    private:
+        std::map<std::string, bool> mControlSwitch;
+    };
+}
+
+#endif
@@ -57,6 +57,7 @@
 #include "summoning.hpp"
 #include "combat.hpp"
 #include "actorutil.hpp"
+#include "aischeduler.hpp"
 
 namespace
 {
@@ -161,6 +162,20 @@ void getRestorationPerHourOfSleep (const MWWorld::Ptr& ptr, float& health, float
     }
 }
 
+/// The target of the actor's Follow or Escort package, if it is the current package or there are only Combat
+/// packages before it
+MWWorld::Ptr getSideWithTarget (const MWMechanics::CreatureStats& stats)
+{
+    for (std::list<MWMechanics::AiPackage*>::const_iterator it = stats.getAiSequence().begin(); it != stats.getAiSequence().end(); ++it)
+    {
+        if ((*it)->sideWithTarget() && !(*it)->getTarget().isEmpty())
+            return (*it)->getTarget();
+        else if ((*it)->getTypeId() != MWMechanics::AiPackage::TypeIdCombat)
+            break;
+    }
+    return MWWorld::Ptr();
+}
+
 }
 
 namespace MWMechanics
@@ -178,6 +193,9 @@ namespace MWMechanics
     */
     const float sqrAiProcessingDistance = aiProcessingDistance*aiProcessingDistance;
 
+    // A quarter of an exterior cell, so head tracking and sneak detection only visit a few cells of the actor grid
+    const float actorGridCellSize = 2048;
+
     class SoulTrap : public MWMechanics::EffectSourceVisitor
     {
         MWWorld::Ptr mCreature;
@@ -1250,7 +1268,10 @@ namespace MWMechanics
         }
     }
 
-    Actors::Actors() {
+    Actors::Actors()
+        : mActorGrid(actorGridCellSize)
+        , mActorGridValid(false)
+    {
         mTimerDisposeSummonsCorpses = 0.2f; // We should add a delay between summoned creature death and its corpse despawning
     }
 
@@ -1262,6 +1283,7 @@ namespace MWMechanics
     void Actors::addActor (const MWWorld::Ptr& ptr, bool updateImmediately)
     {
         removeActor(ptr);
+        mActorGridValid = false;
 
         MWRender::Animation *anim = MWBase::Environment::get().getWorld()->getAnimation(ptr);
         if (!anim)
@@ -1278,6 +1300,7 @@ namespace MWMechanics
         {
             delete iter->second;
             mActors.erase(iter);
+            mActorGridValid = false;
         }
     }
 
@@ -1321,6 +1344,30 @@ namespace MWMechanics
         return false;
     }
 
+    void Actors::buildActorGrid()
+    {
+        mActorGrid.clear();
+        for (PtrActorMap::const_iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
+            mActorGrid.insert(iter->first, iter->first.getRefData().getPosition().asVec3());
+        mActorGrid.build();
+        mActorGridValid = true;
+    }
+
+    void Actors::buildSidingIndex()
+    {
+        mSidingIndex.clear();
+        for (PtrActorMap::const_iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
+        {
+            const CreatureStats &stats = iter->first.getClass().getCreatureStats(iter->first);
+            if (stats.isDead())
+                continue;
+
+            MWWorld::Ptr target = getSideWithTarget(stats);
+            if (!target.isEmpty())
+                mSidingIndex[target].push_back(iter->first);
+        }
+    }
+
     void Actors::updateActor(const MWWorld::Ptr &old, const MWWorld::Ptr &ptr)
     {
         PtrActorMap::iterator iter = mActors.find(old);
@@ -1331,6 +1378,7 @@ namespace MWMechanics
 
             actor->updatePtr(ptr);
             mActors.insert(std::make_pair(ptr, actor));
+            mActorGridValid = false;
         }
     }
 
@@ -1343,6 +1391,7 @@ namespace MWMechanics
             {
                 delete iter->second;
                 mActors.erase(iter++);
+                mActorGridValid = false;
             }
             else
                 ++iter;
@@ -1354,21 +1403,17 @@ namespace MWMechanics
         MWWorld::Ptr player = getPlayer();
         int hostilesCount = 0; // need to know this to play Battle music
 
-        for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+        if (MWBase::Environment::get().getMechanicsManager()->isAIActive())
         {
-            if (!iter->first.getClass().getCreatureStats(iter->first).isDead())
+            std::vector<MWWorld::Ptr> neighbors;
+            getObjectsInRange(player.getRefData().getPosition().asVec3(), aiProcessingDistance, neighbors);
+            for(std::vector<MWWorld::Ptr>::const_iterator iter(neighbors.begin()); iter != neighbors.end(); ++iter)
             {
-                bool inProcessingRange = (player.getRefData().getPosition().asVec3() - iter->first.getRefData().getPosition().asVec3()).length2()
-                        <= sqrAiProcessingDistance;
+                if (*iter == player)
+                    continue;
 
-                if (MWBase::Environment::get().getMechanicsManager()->isAIActive() && inProcessingRange)
-                {
-                    if (iter->first != player)
-                    {
-                        MWMechanics::CreatureStats& stats = iter->first.getClass().getCreatureStats(iter->first);
-                        if (stats.getAiSequence().isInCombat() && !stats.isDead()) hostilesCount++;
-                    }
-                }
+                MWMechanics::CreatureStats& stats = iter->getClass().getCreatureStats(*iter);
+                if (stats.getAiSequence().isInCombat() && !stats.isDead()) hostilesCount++;
             }
         }
 
@@ -1413,6 +1458,24 @@ namespace MWMechanics
 
             std::map<const MWWorld::Ptr, const std::set<MWWorld::Ptr> > cachedAllies; // will be filled as engageCombat iterates
 
+            AiScheduler::startFrame();
+
+            // Target updates deferred by the AI scheduler are done by the next regular update anyway
+            if (timerUpdateAITargets == 0)
+                mDeferredTargetUpdates.clear();
+
+            buildActorGrid();
+            if (timerUpdateAITargets == 0 || !mDeferredTargetUpdates.empty())
+                buildSidingIndex();
+
+            static const float fMaxHeadTrackDistance = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
+                    .find("fMaxHeadTrackDistance")->getFloat();
+            static const float fInteriorHeadTrackMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
+                    .find("fInteriorHeadTrackMult")->getFloat();
+            const float headTrackQueryRadius = fMaxHeadTrackDistance * std::max(1.f, fInteriorHeadTrackMult);
+
+            std::vector<MWWorld::Ptr> neighbors;
+
              // AI and magic effects update
             for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
             {
@@ -1505,6 +1568,8 @@ namespace MWMechanics
                     updateActor(actor, duration);
                     if (!cellChanged && MWBase::Environment::get().getWorld()->hasCellChanged())
                     {
+                        mActorGridValid = false;
+                        mSidingIndex.clear();
                         return; // for now abort update of the old cell when cell changes by teleportation magic effect
                                 // a better solution might be to apply cell changes at the end of the frame
                     }
@@ -1522,16 +1587,26 @@ namespace MWMechanics
 
                     if (inProcessingRange && (isAIActive || isLocalActor || isDedicatedActor))
                     {
-                        if (timerUpdateAITargets == 0 && (isLocalActor || isAIActive))
+                        bool updateTargets = mDeferredTargetUpdates.erase(iter->first) > 0 || timerUpdateAITargets == 0;
+                        if (updateTargets && !isPlayer && (isLocalActor || isAIActive)) // player is not AI-controlled
                         {
-                            if (!isPlayer)
+                            if (!AiScheduler::mayRun(iter->first))
+                                mDeferredTargetUpdates.insert(iter->first);
+                            else
+                            {
+                                AiScheduler::Slice slice;
+
                                 adjustCommandedActor(iter->first);
 
-                            for(PtrActorMap::iterator it(mActors.begin()); it != mActors.end(); ++it)
-                            {
-                                if (it->first == iter->first || isPlayer) // player is not AI-controlled
-                                    continue;
-                                engageCombat(iter->first, it->first, cachedAllies, it->first == player);
+                                // engageCombat ignores actors beyond the AI processing distance
+                                neighbors.clear();
+                                getObjectsInRange(iter->first.getRefData().getPosition().asVec3(), aiProcessingDistance, neighbors);
+                                for(std::vector<MWWorld::Ptr>::const_iterator it(neighbors.begin()); it != neighbors.end(); ++it)
+                                {
+                                    if (*it == iter->first)
+                                        continue;
+                                    engageCombat(iter->first, *it, cachedAllies, *it == player);
+                                }
                             }
                         }
                         if (timerUpdateHeadTrack == 0)
@@ -1550,11 +1625,14 @@ namespace MWMechanics
                                 !stats.getAiSequence().hasPackage(AiPackage::TypeIdPursue) &&
                                 !firstPersonPlayer)
                             {
-                                for(PtrActorMap::iterator it(mActors.begin()); it != mActors.end(); ++it)
+                                // updateHeadTracking ignores actors beyond the head tracking distance
+                                neighbors.clear();
+                                getObjectsInRange(iter->first.getRefData().getPosition().asVec3(), headTrackQueryRadius, neighbors);
+                                for(std::vector<MWWorld::Ptr>::const_iterator it(neighbors.begin()); it != neighbors.end(); ++it)
                                 {
-                                    if (it->first == iter->first)
+                                    if (*it == iter->first)
                                         continue;
-                                    updateHeadTracking(iter->first, it->first, headTrackTarget, sqrHeadTrackDistance);
+                                    updateHeadTracking(iter->first, *it, headTrackTarget, sqrHeadTrackDistance);
                                 }
                             }
 
@@ -1681,19 +1759,20 @@ namespace MWMechanics
 
                     bool detected = false;
 
-                    for (PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+                    std::vector<MWWorld::Ptr> observers;
+                    getObjectsInRange(player.getRefData().getPosition().asVec3(), static_cast<float>(radius), observers);
+                    for (std::vector<MWWorld::Ptr>::const_iterator iter(observers.begin()); iter != observers.end(); ++iter)
                     {
-                        MWWorld::Ptr observer = iter->first;
+                        MWWorld::Ptr observer = *iter;
 
-                        if (iter->first == player)  // not the player
+                        if (observer == player)  // not the player
                             continue;
 
                         if (observer.getClass().getCreatureStats(observer).isDead())
                             continue;
 
                         // is the player in range and can they be detected
-                        if ((observer.getRefData().getPosition().asVec3() - player.getRefData().getPosition().asVec3()).length2() <= radius*radius
-                            && MWBase::Environment::get().getWorld()->getLOS(player, observer))
+                        if (MWBase::Environment::get().getWorld()->getLOS(player, observer))
                         {
                             if (MWBase::Environment::get().getMechanicsManager()->awarenessCheck(player, observer))
                             {
@@ -1727,6 +1806,9 @@ namespace MWMechanics
         }
 
         updateCombatMusic();
+
+        mActorGridValid = false;
+        mSidingIndex.clear();
     }
 
     void Actors::killDeadActors()
@@ -2002,6 +2084,16 @@ namespace MWMechanics
 
     void Actors::getObjectsInRange(const osg::Vec3f& position, float radius, std::vector<MWWorld::Ptr>& out)
     {
+        // Queries as large as the AI processing distance usually cover all actors, which are already in order here
+        if (mActorGridValid && !mActorGrid.coversAll(position, radius))
+        {
+            std::size_t first = out.size();
+            mActorGrid.getInRange(position, radius, out);
+            // Keep the order of mActors, some callers act on the first actors found
+            std::sort(out.begin() + first, out.end());
+            return;
+        }
+
         for (PtrActorMap::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
         {
             if ((iter->first.getRefData().getPosition().asVec3() - position).length2() <= radius*radius)
@@ -2011,6 +2103,13 @@ namespace MWMechanics
 
     bool Actors::isAnyObjectInRange(const osg::Vec3f& position, float radius)
     {
+        if (mActorGridValid && !mActorGrid.coversAll(position, radius))
+        {
+            bool found = false;
+            mActorGrid.forEachInRange(position, radius, [&found] (const MWWorld::Ptr&) { found = true; });
+            return found;
+        }
+
         for (PtrActorMap::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
         {
             if ((iter->first.getRefData().getPosition().asVec3() - position).length2() <= radius*radius)
@@ -2103,7 +2202,18 @@ namespace MWMechanics
             out.insert(search->second.begin(), search->second.end());
         else
         {
-            std::list<MWWorld::Ptr> followers = getActorsSidingWith(actor);
+            std::list<MWWorld::Ptr> followers;
+            std::map<MWWorld::Ptr, std::list<MWWorld::Ptr> >::const_iterator indexed = mSidingIndex.find(actor);
+            if (indexed != mSidingIndex.end())
+                followers = indexed->second;
+            // Same as getActorsSidingWith, which adds the actor being followed or escorted by this actor as well
+            if (actor != getPlayer())
+            {
+                MWWorld::Ptr target = getSideWithTarget(actor.getClass().getCreatureStats(actor));
+                if (!target.isEmpty())
+                    followers.push_back(target);
+            }
+
             for (std::list<MWWorld::Ptr>::iterator it = followers.begin(); it != followers.end(); ++it)
                 if (out.insert(*it).second)
                     getActorsSidingWith(*it, out, cachedAllies);
@@ -2222,6 +2332,9 @@ namespace MWMechanics
         }
         mActors.clear();
         mDeathCount.clear();
+        mActorGridValid = false;
+        mSidingIndex.clear();
+        mDeferredTargetUpdates.clear();
     }
 
     void Actors::updateMagicEffects(const MWWorld::Ptr &ptr)
@@ -9,6 +9,7 @@
 #include "../mwbase/world.hpp"
 
 #include "movement.hpp"
+#include "spatialgrid.hpp"
 
 namespace MWWorld
 {
@@ -49,6 +50,12 @@ namespace MWMechanics
 
             void purgeSpellEffects (int casterActorId);
 
+            void buildActorGrid();
+            ///< Index the current positions of all actors, for the range queries made during update().
+
+            void buildSidingIndex();
+            ///< Index the actors siding with each actor, for engageCombat().
+
         public:
 
             Actors();
@@ -181,6 +188,13 @@ namespace MWMechanics
         PtrActorMap mActors;
         float mTimerDisposeSummonsCorpses;
 
+        SpatialGrid<MWWorld::Ptr> mActorGrid;
+        bool mActorGridValid; ///< Only during update(), and until the first actor is added, removed or replaced
+
+        std::map<MWWorld::Ptr, std::list<MWWorld::Ptr> > mSidingIndex; ///< Rebuilt along with the AI targets
+
+        std::set<MWWorld::Ptr> mDeferredTargetUpdates; ///< Actors whose AI targets the AI scheduler left for a later frame
+
     };
 }
 
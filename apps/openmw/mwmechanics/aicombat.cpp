@@ -28,6 +28,7 @@
 
 #include "pathgrid.hpp"
 #include "creaturestats.hpp"
+#include "aischeduler.hpp"
 #include "steering.hpp"
 #include "movement.hpp"
 #include "character.hpp"
@@ -173,9 +174,10 @@ namespace MWMechanics
         {
             timerReact += duration;
         }
-        else
+        else if (AiScheduler::mayRun(actor)) // otherwise react in a later frame
         {
             timerReact = 0;
+            AiScheduler::Slice slice;
             if (attack(actor, target, storage, characterController))
                 return true;
         }
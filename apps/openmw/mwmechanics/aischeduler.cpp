@@ -0,0 +1,78 @@
+#include "aischeduler.hpp"
+
+#include <components/settings/settings.hpp>
+
+/*
+    Start of tes3mp addition
+
+    Include additional headers for multiplayer purposes
+*/
+#include "../mwmp/PlayerList.hpp"
+/*
+    End of tes3mp addition
+*/
+
+#include "../mwworld/class.hpp"
+
+#include "actorutil.hpp"
+#include "aisequence.hpp"
+#include "creaturestats.hpp"
+
+namespace
+{
+    bool isFightingPlayer (const MWWorld::Ptr& actor)
+    {
+        std::vector<MWWorld::Ptr> targets;
+        if (!actor.getClass().getCreatureStats(actor).getAiSequence().getCombatTargets(targets))
+            return false;
+
+        const MWWorld::Ptr player = MWMechanics::getPlayer();
+        for (std::vector<MWWorld::Ptr>::const_iterator it = targets.begin(); it != targets.end(); ++it)
+        {
+            if (*it == player)
+                return true;
+
+            /*
+                Start of tes3mp addition
+
+                Fights with the players of other clients are just as visible
+            */
+            if (mwmp::PlayerList::isDedicatedPlayer(*it))
+                return true;
+            /*
+                End of tes3mp addition
+            */
+        }
+        return false;
+    }
+}
+
+namespace MWMechanics
+{
+    double AiScheduler::sSpent = 0;
+
+    void AiScheduler::startFrame()
+    {
+        sSpent = 0;
+    }
+
+    bool AiScheduler::mayRun (const MWWorld::Ptr& actor)
+    {
+        static const float budget = Settings::Manager::getFloat("ai time budget", "Game");
+
+        if (budget <= 0 || sSpent < budget)
+            return true;
+
+        return isFightingPlayer(actor);
+    }
+
+    AiScheduler::Slice::Slice()
+        : mStart(osg::Timer::instance()->tick())
+    {
+    }
+
+    AiScheduler::Slice::~Slice()
+    {
+        sSpent += osg::Timer::instance()->delta_m(mStart, osg::Timer::instance()->tick());
+    }
+}
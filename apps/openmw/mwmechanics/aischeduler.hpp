@@ -0,0 +1,44 @@
+#ifndef GAME_MWMECHANICS_AISCHEDULER_H
+#define GAME_MWMECHANICS_AISCHEDULER_H
+
+#include <osg/Timer>
+
+namespace MWWorld
+{
+    class Ptr;
+}
+
+namespace MWMechanics
+{
+    /// \brief Spreads AI work that can wait a frame over several frames, under a time budget
+    ///
+    /// Before doing such work (choosing the next combat action, a wander destination, re-evaluating combat
+    /// targets) the AI asks mayRun() and, if allowed, measures the work with a Slice. Once the work measured in
+    /// the current frame exceeds the "ai time budget" setting, mayRun() refuses the work of actors that are
+    /// not fighting a player until the next frame, and the AI tries again then.
+    class AiScheduler
+    {
+            static double sSpent; // ms of AI work measured since startFrame()
+
+        public:
+
+            static void startFrame();
+            ///< Reset the time spent. Called by Actors::update before the AI runs.
+
+            static bool mayRun (const MWWorld::Ptr& actor);
+            ///< May the work of \a actor run in this frame? Always true for actors fighting a player.
+
+            /// Adds the time until its destruction to the time spent this frame
+            class Slice
+            {
+                    osg::Timer_t mStart;
+
+                public:
+
+                    Slice();
+                    ~Slice();
+            };
+    };
+}
+
+#endif
@@ -23,6 +23,7 @@
 #include "movement.hpp"
 #include "coordinateconverter.hpp"
 #include "actorutil.hpp"
+#include "aischeduler.hpp"
 
 
 
@@ -169,9 +170,10 @@ namespace MWMechanics
 
         float& lastReaction = storage.mReaction;
         lastReaction += duration;
-        if (AI_REACTION_TIME <= lastReaction)
+        if (AI_REACTION_TIME <= lastReaction && AiScheduler::mayRun(actor)) // otherwise react in a later frame
         {
             lastReaction = 0;
+            AiScheduler::Slice slice;
             return reactionTimeActions(actor, storage, currentCell, cellChange, pos, duration);
         }
         else
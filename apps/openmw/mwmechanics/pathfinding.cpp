@@ -229,7 +229,9 @@ namespace MWMechanics
         }
         else
         {
-            mPath = pathgridGraph.aStarSearch(startNode, endNode.first);
+            std::vector<int> path = pathgridGraph.aStarSearch(startNode, endNode.first);
+            for (std::vector<int>::const_iterator iter(path.begin()); iter != path.end(); ++iter)
+                mPath.push_back(mPathgrid->mPoints[*iter]);
 
             // If nearest path node is in opposite direction from second, remove it from path.
             // Especially useful for wandering actors, if the nearest node is blocked for some reason.
@@ -1,5 +1,7 @@
 #include "pathgrid.hpp"
 
+#include <algorithm>
+
 #include "../mwbase/world.hpp"
 #include "../mwbase/environment.hpp"
 
@@ -45,6 +47,21 @@ namespace
         //return distance(a, b);
         return manhattan(a, b);
     }
+
+    // Paths are small, but a large pathgrid has a lot of start/end pairs
+    const std::size_t maxCachedPaths = 1024;
+
+    // std heap functions build a max heap, so this puts the lowest fScore on top
+    struct OpenPointCompare
+    {
+        template <class T>
+        bool operator() (const T& a, const T& b) const
+        {
+            if (a.fScore != b.fScore)
+                return a.fScore > b.fScore;
+            return a.order > b.order;
+        }
+    };
 }
 
 namespace MWMechanics
@@ -57,6 +74,7 @@ namespace MWMechanics
         , mIsGraphConstructed(false)
         , mSCCId(0)
         , mSCCIndex(0)
+        , mSearchId(0)
     {
         load(cell);
     }
@@ -127,6 +145,16 @@ namespace MWMechanics
             //mGraph[mPathgrid->mEdges[i].mV1].edges.push_back(neighbour);
         }
         buildConnectedPoints();
+
+        SearchPoint unvisited;
+        unvisited.searchId = 0;
+        unvisited.closed = false;
+        unvisited.parent = -1;
+        unvisited.gScore = 0;
+        mSearchPoints.assign(mGraph.size(), unvisited);
+        mSearchId = 0;
+        mPathCache.clear();
+
         mIsGraphConstructed = true;
         return true;
     }
@@ -230,6 +258,24 @@ namespace MWMechanics
         }
     }
 
+    std::vector<int> PathgridGraph::aStarSearch(const int start, const int goal) const
+    {
+        if(!isPointConnected(start, goal))
+            return std::vector<int>(); // there is no path, return an empty path
+
+        const std::pair<int, int> key (start, goal);
+        PathCache::const_iterator cached = mPathCache.find(key);
+        if(cached != mPathCache.end())
+            return cached->second;
+
+        if(mPathCache.size() >= maxCachedPaths)
+            mPathCache.clear();
+
+        std::vector<int>& path = mPathCache[key];
+        findPath(start, goal, path);
+        return path;
+    }
+
     /*
      * NOTE: Based on buildPath2(), please check git history if interested
      *       Should consider using a 3rd party library version (e.g. boost)
@@ -238,106 +284,103 @@ namespace MWMechanics
      * Uses mGraph which has pre-computed costs for allowed edges.  It is assumed
      * that mGraph is already constructed.
      *
-     * Should be possible to make this MT safe.
-     *
-     * Returns path which may be empty.  path contains pathgrid points in local
-     * cell coordinates (indoors) or world coordinates (external).
+     * The heuristic is consistent (the Manhattan distance to the goal can't
+     * drop by more than the Manhattan length of an edge), so a point never has
+     * to be opened again once it is closed.
      *
      * Input params:
      *   start, goal - pathgrid point indexes (for this cell)
      *
      * Variables:
-     *   openset - point indexes to be traversed, lowest cost at the front
-     *   closedset - point indexes already traversed
-     *   gScore - past accumulated costs vector indexed by point index
-     *   fScore - future estimated costs vector indexed by point index
+     *   mOpenSet - binary heap of point indexes to be traversed, lowest fScore
+     *              on top; a point improved while in the heap is pushed again
+     *              and its older entry skipped when popped, as it is closed
+     *   mSearchPoints - past accumulated costs (gScore), parents and closed
+     *                   flags, indexed by point index
      *
-     * TODO: An intersting exercise might be to cache the paths created for a
-     *       start/goal pair.  To cache the results the paths need to be in
-     *       pathgrid points form (currently they are converted to world
-     *       coordinates).  Essentially trading speed w/ memory.
+     * Output param:
+     *   path - point indexes from start to goal, empty if no path was found
      */
-    std::list<ESM::Pathgrid::Point> PathgridGraph::aStarSearch(const int start,
-                                                               const int goal) const
+    void PathgridGraph::findPath(const int start, const int goal, std::vector<int>& path) const
     {
-        std::list<ESM::Pathgrid::Point> path;
-        if(!isPointConnected(start, goal))
+        path.clear();
+
+        if(++mSearchId == 0)
         {
-            return path; // there is no path, return an empty path
+            // wrapped around, the ids left from older searches could be taken for current ones
+            for(std::vector<SearchPoint>::iterator it = mSearchPoints.begin(); it != mSearchPoints.end(); ++it)
+                it->searchId = 0;
+            mSearchId = 1;
         }
 
-        int graphSize = static_cast<int> (mGraph.size());
-        std::vector<float> gScore (graphSize, -1);
-        std::vector<float> fScore (graphSize, -1);
-        std::vector<int> graphParent (graphSize, -1);
+        unsigned int order = 0;
+        mOpenSet.clear();
 
-        // gScore & fScore keep costs for each pathgrid point in mPoints
-        gScore[start] = 0;
-        fScore[start] = costAStar(mPathgrid->mPoints[start], mPathgrid->mPoints[goal]);
+        SearchPoint& startPoint = mSearchPoints[start];
+        startPoint.searchId = mSearchId;
+        startPoint.closed = false;
+        startPoint.parent = -1;
+        startPoint.gScore = 0;
 
-        std::list<int> openset;
-        std::list<int> closedset;
-        openset.push_back(start);
+        OpenPoint open;
+        open.fScore = costAStar(mPathgrid->mPoints[start], mPathgrid->mPoints[goal]);
+        open.order = order++;
+        open.index = start;
+        mOpenSet.push_back(open);
 
-        int current = -1;
+        bool found = false;
 
-        while(!openset.empty())
+        while(!mOpenSet.empty())
         {
-            current = openset.front(); // front has the lowest cost
-            openset.pop_front();
+            std::pop_heap(mOpenSet.begin(), mOpenSet.end(), OpenPointCompare());
+            const int current = mOpenSet.back().index;
+            mOpenSet.pop_back();
+
+            SearchPoint& currentPoint = mSearchPoints[current];
+            if(currentPoint.closed)
+                continue; // an outdated entry, the point was reached by a cheaper path
 
             if(current == goal)
+            {
+                found = true;
                 break;
+            }
 
-            closedset.push_back(current); // remember we've been here
+            currentPoint.closed = true; // remember we've been here
 
             // check all edges for the current point index
-            for(int j = 0; j < static_cast<int> (mGraph[current].edges.size()); j++)
+            const std::vector<ConnectedPoint>& edges = mGraph[current].edges;
+            for(std::vector<ConnectedPoint>::const_iterator edge = edges.begin(); edge != edges.end(); ++edge)
             {
-                if(std::find(closedset.begin(), closedset.end(), mGraph[current].edges[j].index) ==
-                   closedset.end())
+                SearchPoint& dest = mSearchPoints[edge->index];
+                const bool visited = dest.searchId == mSearchId;
+                if(visited && dest.closed)
+                    continue; // traversed this edge destination already, try the next edge
+
+                const float tentative_g = currentPoint.gScore + edge->cost;
+                if(!visited || tentative_g < dest.gScore)
                 {
-                    // not in closedset - i.e. have not traversed this edge destination
-                    int dest = mGraph[current].edges[j].index;
-                    float tentative_g = gScore[current] + mGraph[current].edges[j].cost;
-                    bool isInOpenSet = std::find(openset.begin(), openset.end(), dest) != openset.end();
-                    if(!isInOpenSet
-                        || tentative_g < gScore[dest])
-                    {
-                        graphParent[dest] = current;
-                        gScore[dest] = tentative_g;
-                        fScore[dest] = tentative_g + costAStar(mPathgrid->mPoints[dest],
-                                                               mPathgrid->mPoints[goal]);
-                        if(!isInOpenSet)
-                        {
-                            // add this edge to openset, lowest cost goes to the front
-                            // TODO: if this causes performance problems a hash table may help
-                            std::list<int>::iterator it = openset.begin();
-                            for(it = openset.begin(); it!= openset.end(); ++it)
-                            {
-                                if(fScore[*it] > fScore[dest])
-                                    break;
-                            }
-                            openset.insert(it, dest);
-                        }
-                    }
-                } // if in closedset, i.e. traversed this edge already, try the next edge
+                    dest.searchId = mSearchId;
+                    dest.closed = false;
+                    dest.parent = current;
+                    dest.gScore = tentative_g;
+
+                    open.fScore = tentative_g + costAStar(mPathgrid->mPoints[edge->index],
+                                                          mPathgrid->mPoints[goal]);
+                    open.order = order++;
+                    open.index = edge->index;
+                    mOpenSet.push_back(open);
+                    std::push_heap(mOpenSet.begin(), mOpenSet.end(), OpenPointCompare());
+                }
             }
         }
 
-        if(current != goal)
-            return path; // for some reason couldn't build a path
+        if(!found)
+            return; // for some reason couldn't build a path
 
-        // reconstruct path to return, using local coordinates
-        while(graphParent[current] != -1)
-        {
-            path.push_front(mPathgrid->mPoints[current]);
-            current = graphParent[current];
-        }
-
-        // add first node to path explicitly
-        path.push_front(mPathgrid->mPoints[start]);
-        return path;
+        // reconstruct path to return, from the goal back to the start
+        for(int current = goal; current != -1; current = mSearchPoints[current].parent)
+            path.push_back(current);
+        std::reverse(path.begin(), path.end());
     }
 }
-
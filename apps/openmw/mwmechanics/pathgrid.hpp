@@ -1,7 +1,9 @@
 #ifndef GAME_MWMECHANICS_PATHGRID_H
 #define GAME_MWMECHANICS_PATHGRID_H
 
-#include <list>
+#include <map>
+#include <utility>
+#include <vector>
 
 #include <components/esm/loadpgrd.hpp>
 
@@ -34,12 +36,12 @@ namespace MWMechanics
             void getNeighbouringPoints(const int index, ESM::Pathgrid::PointList &nodes) const;
 
             // the input parameters are pathgrid point indexes
-            // the output list is in local (internal cells) or world (external
-            // cells) coordinates
+            // the output path is the pathgrid point indexes from start to end,
+            // both included, or empty if there is no path
             //
-            // NOTE: if start equals end an empty path is returned
-            std::list<ESM::Pathgrid::Point> aStarSearch(const int start,
-                                                        const int end) const;
+            // NOTE: not thread safe, all searches on a graph share its buffers
+            //       and its path cache
+            std::vector<int> aStarSearch(const int start, const int end) const;
         private:
 
             const ESM::Cell *mCell;
@@ -79,6 +81,35 @@ namespace MWMechanics
             // methods used to calculate connected components
             void recursiveStrongConnect(int v);
             void buildConnectedPoints();
+
+            // per point state of aStarSearch, only valid if searchId is the
+            // id of the current search, so it doesn't need to be cleared
+            // between searches
+            struct SearchPoint
+            {
+                unsigned int searchId;
+                bool closed;
+                int parent;
+                float gScore;
+            };
+
+            struct OpenPoint
+            {
+                float fScore;
+                unsigned int order; // ties go to the point opened first
+                int index;
+            };
+
+            mutable std::vector<SearchPoint> mSearchPoints;
+            mutable std::vector<OpenPoint> mOpenSet; // binary heap
+            mutable unsigned int mSearchId;
+
+            // paths found by aStarSearch, keyed by start and end point
+            // index; cleared whenever the graph is (re)built
+            typedef std::map<std::pair<int, int>, std::vector<int> > PathCache;
+            mutable PathCache mPathCache;
+
+            void findPath(const int start, const int goal, std::vector<int>& path) const;
     };
 }
 
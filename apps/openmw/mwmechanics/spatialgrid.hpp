@@ -0,0 +1,147 @@
+#ifndef GAME_MWMECHANICS_SPATIALGRID_H
+#define GAME_MWMECHANICS_SPATIALGRID_H
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <osg/Vec3f>
+
+namespace MWMechanics
+{
+    /// \brief Uniform grid over the horizontal positions of a set of objects
+    ///
+    /// The grid is meant to be rebuilt from scratch whenever the positions may have changed: call clear(),
+    /// insert() every object and then build(). The objects are kept in a single vector sorted by their cell, so
+    /// rebuilding does not allocate once the vector has grown to its final size, and the cells of one grid row
+    /// that overlap a query are a contiguous range of that vector.
+    template <class T>
+    class SpatialGrid
+    {
+            typedef uint64_t Key;
+
+            struct Entry
+            {
+                Key mKey;
+                T mObject;
+                osg::Vec3f mPosition;
+
+                bool operator< (const Entry& other) const { return mKey < other.mKey; }
+            };
+
+            struct KeyCompare
+            {
+                bool operator() (const Entry& entry, Key key) const { return entry.mKey < key; }
+                bool operator() (Key key, const Entry& entry) const { return key < entry.mKey; }
+            };
+
+            float mCellSize;
+            std::vector<Entry> mEntries;
+            bool mBuilt;
+
+            // Horizontal bounds of the inserted positions
+            float mMinX, mMaxX, mMinY, mMaxY;
+
+            int getCell (float coordinate) const
+            {
+                return static_cast<int>(std::floor(coordinate / mCellSize));
+            }
+
+            /// Rows are ordered by y, and cells within a row by x. The sign bits are flipped, so that the unsigned
+            /// order of the key matches the signed order of the coordinates.
+            static Key getKey (int x, int y)
+            {
+                return (static_cast<Key>(static_cast<uint32_t>(y) ^ 0x80000000u) << 32)
+                    | (static_cast<uint32_t>(x) ^ 0x80000000u);
+            }
+
+        public:
+
+            SpatialGrid (float cellSize) : mCellSize (cellSize) { clear(); }
+
+            void clear()
+            {
+                mEntries.clear();
+                mBuilt = true;
+                mMinX = mMinY = std::numeric_limits<float>::max();
+                mMaxX = mMaxY = -std::numeric_limits<float>::max();
+            }
+
+            void insert (const T& object, const osg::Vec3f& position)
+            {
+                Entry entry;
+                entry.mKey = getKey (getCell (position.x()), getCell (position.y()));
+                entry.mObject = object;
+                entry.mPosition = position;
+                mEntries.push_back (entry);
+                mBuilt = false;
+
+                mMinX = std::min (mMinX, position.x());
+                mMaxX = std::max (mMaxX, position.x());
+                mMinY = std::min (mMinY, position.y());
+                mMaxY = std::max (mMaxY, position.y());
+            }
+
+            void build()
+            {
+                std::stable_sort (mEntries.begin(), mEntries.end());
+                mBuilt = true;
+            }
+            ///< Sort the inserted objects into their cells. Must be called before querying the grid.
+
+            std::size_t size() const { return mEntries.size(); }
+
+            bool coversAll (const osg::Vec3f& position, float radius) const
+            {
+                return position.x() - radius <= mMinX && position.x() + radius >= mMaxX
+                    && position.y() - radius <= mMinY && position.y() + radius >= mMaxY;
+            }
+            ///< Does a query around \a position reach every cell with objects in it? The grid does not narrow such
+            /// a query down, so testing all objects directly is just as good.
+
+            template <class Function>
+            void forEachInRange (const osg::Vec3f& position, float radius, Function function) const
+            {
+                assert (mBuilt);
+
+                const float sqrRadius = radius * radius;
+
+                const int minX = getCell (position.x() - radius);
+                const int maxX = getCell (position.x() + radius);
+                const int minY = getCell (position.y() - radius);
+                const int maxY = getCell (position.y() + radius);
+
+                // Looking up every row costs a binary search; when the query covers more rows than there are
+                // objects, just test all of them
+                if (static_cast<std::size_t>(maxY) - static_cast<std::size_t>(minY) >= mEntries.size())
+                {
+                    for (typename std::vector<Entry>::const_iterator iter (mEntries.begin()); iter != mEntries.end(); ++iter)
+                        if ((iter->mPosition - position).length2() <= sqrRadius)
+                            function (iter->mObject);
+                    return;
+                }
+
+                typename std::vector<Entry>::const_iterator iter = mEntries.begin();
+                for (int y = minY; y <= maxY; ++y)
+                {
+                    iter = std::lower_bound (iter, mEntries.end(), getKey (minX, y), KeyCompare());
+                    const Key maxKey = getKey (maxX, y);
+                    for (; iter != mEntries.end() && iter->mKey <= maxKey; ++iter)
+                        if ((iter->mPosition - position).length2() <= sqrRadius)
+                            function (iter->mObject);
+                }
+            }
+            ///< Call \a function with every object within \a radius of \a position, as of the last rebuild.
+
+            void getInRange (const osg::Vec3f& position, float radius, std::vector<T>& out) const
+            {
+                forEachInRange (position, radius, [&out] (const T& object) { out.push_back (object); });
+            }
+            ///< Append the objects within \a radius of \a position to \a out, in no particular order.
+    };
+}
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef OPENMW_ACTORINDEX_HPP
+#define OPENMW_ACTORINDEX_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include <components/openmw-mp/Utils.hpp>
+
+namespace mwmp
+{
+    // Uniquely identifies an actor by its refNum and mpNum packed into a single integer, so actor
+    // lookups don't need to build and compare strings
+    typedef uint64_t ActorIndex;
+
+    inline ActorIndex generateActorIndex(unsigned int refNum, unsigned int mpNum)
+    {
+        return (static_cast<ActorIndex>(refNum) << 32) | mpNum;
+    }
+
+    inline unsigned int getActorIndexRefNum(ActorIndex actorIndex)
+    {
+        return static_cast<unsigned int>(actorIndex >> 32);
+    }
+
+    inline unsigned int getActorIndexMpNum(ActorIndex actorIndex)
+    {
+        return static_cast<unsigned int>(actorIndex & 0xFFFFFFFF);
+    }
+
+    // Human-readable version of an ActorIndex for use in logging, matching the old "refNum-mpNum" string indexes
+    inline std::string getActorIndexDescription(ActorIndex actorIndex)
+    {
+        return Utils::toString(static_cast<int>(getActorIndexRefNum(actorIndex))) + "-" +
+            Utils::toString(static_cast<int>(getActorIndexMpNum(actorIndex)));
+    }
+
+    // Records the cell that each actor is currently held by. Every record pointing at a cell has to be dropped
+    // through removeCell() before that cell is deleted
+    template <class CellType>
+    class ActorCellRecords
+    {
+    public:
+
+        void set(ActorIndex actorIndex, CellType *cell)
+        {
+            records[actorIndex] = cell;
+        }
+
+        void remove(ActorIndex actorIndex)
+        {
+            records.erase(actorIndex);
+        }
+
+        void removeCell(const CellType *cell)
+        {
+            for (auto it = records.begin(); it != records.end();)
+            {
+                if (it->second == cell)
+                    it = records.erase(it);
+                else
+                    ++it;
+            }
+        }
+
+        bool has(ActorIndex actorIndex) const
+        {
+            return records.count(actorIndex) > 0;
+        }
+
+        // Throws std::out_of_range if there is no record for the actor
+        CellType *get(ActorIndex actorIndex) const
+        {
+            return records.at(actorIndex);
+        }
+
+        size_t size() const
+        {
+            return records.size();
+        }
+
+    private:
+        std::unordered_map<ActorIndex, CellType *> records;
+    };
+}
+
+#endif //OPENMW_ACTORINDEX_HPP
@@ -21,9 +21,6 @@ mwmp::Cell::Cell(MWWorld::CellStore* cellStore)
     store = cellStore;
     shouldInitializeActors = false;
 
-    std::map<std::string, LocalActor *> localActors;
-    std::map<std::string, DedicatedActor *> dedicatedActors;
-
     updateTimer = 0;
 }
 
@@ -59,21 +56,21 @@ void Cell::updateLocal(bool forceUpdate)
         if (newStore != store)
         {
             actor->updateCell();
-            std::string mapIndex = it->first;
+            ActorIndex mapIndex = it->first;
 
             // If the cell this actor has moved to is under our authority, move them to it
             if (cellController->hasLocalAuthority(actor->cell))
             {
                 LOG_APPEND(Log::LOG_VERBOSE, "- Moving LocalActor %s to our authority in %s",
-                    mapIndex.c_str(), actor->cell.getDescription().c_str());
+                    getActorIndexDescription(mapIndex).c_str(), actor->cell.getDescription().c_str());
                 Cell *newCell = cellController->getCell(actor->cell);
                 newCell->localActors[mapIndex] = actor;
-                cellController->setLocalActorRecord(mapIndex, newCell->getDescription());
+                cellController->setLocalActorRecord(mapIndex, newCell);
             }
             else
             {
                 LOG_APPEND(Log::LOG_VERBOSE, "- Deleting LocalActor %s which is no longer under our authority",
-                    mapIndex.c_str(), getDescription().c_str());
+                    getActorIndexDescription(mapIndex).c_str(), getDescription().c_str());
                 cellController->removeLocalActorRecord(mapIndex);
                 delete actor;
             }
@@ -123,7 +120,7 @@ void Cell::readPositions(ActorList& actorList)
     
     for (const auto &baseActor : actorList.baseActors)
     {
-        std::string mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
+        ActorIndex mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
 
         if (dedicatedActors.count(mapIndex) > 0)
         {
@@ -150,7 +147,7 @@ void Cell::readAnimFlags(ActorList& actorList)
 {
     for (const auto &baseActor : actorList.baseActors)
     {
-        std::string mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
+        ActorIndex mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
 
         if (dedicatedActors.count(mapIndex) > 0)
         {
@@ -166,7 +163,7 @@ void Cell::readAnimPlay(ActorList& actorList)
 {
     for (const auto &baseActor : actorList.baseActors)
     {
-        std::string mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
+        ActorIndex mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
 
         if (dedicatedActors.count(mapIndex) > 0)
         {
@@ -188,7 +185,7 @@ void Cell::readStatsDynamic(ActorList& actorList)
 
     for (const auto &baseActor : actorList.baseActors)
     {
-        std::string mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
+        ActorIndex mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
 
         if (dedicatedActors.count(mapIndex) > 0)
         {
@@ -226,7 +223,7 @@ void Cell::readEquipment(ActorList& actorList)
 
     for (const auto &baseActor : actorList.baseActors)
     {
-        std::string mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
+        ActorIndex mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
 
         if (dedicatedActors.count(mapIndex) > 0)
         {
@@ -251,7 +248,7 @@ void Cell::readSpeech(ActorList& actorList)
 
     for (const auto &baseActor : actorList.baseActors)
     {
-        std::string mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
+        ActorIndex mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
 
         if (dedicatedActors.count(mapIndex) > 0)
         {
@@ -273,7 +270,7 @@ void Cell::readAi(ActorList& actorList)
 
     for (const auto &baseActor : actorList.baseActors)
     {
-        std::string mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
+        ActorIndex mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
 
         if (dedicatedActors.count(mapIndex) > 0)
         {
@@ -297,11 +294,11 @@ void Cell::readAttack(ActorList& actorList)
 {
     for (const auto &baseActor : actorList.baseActors)
     {
-        std::string mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
+        ActorIndex mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
 
         if (dedicatedActors.count(mapIndex) > 0)
         {
-            LOG_MESSAGE_SIMPLE(Log::LOG_INFO, "Reading ActorAttack about %s", mapIndex.c_str());
+            LOG_MESSAGE_SIMPLE(Log::LOG_INFO, "Reading ActorAttack about %s", getActorIndexDescription(mapIndex).c_str());
 
             DedicatedActor *actor = dedicatedActors[mapIndex];
             actor->attack = baseActor.attack;
@@ -336,13 +333,13 @@ void Cell::readCellChange(ActorList& actorList)
 
     for (const auto &baseActor : actorList.baseActors)
     {
-        std::string mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
+        ActorIndex mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
 
         // Is a packet mistakenly moving the actor to the cell it's already in? If so, ignore it
         if (Misc::StringUtils::ciEqual(getDescription(), baseActor.cell.getDescription()))
         {
             LOG_MESSAGE_SIMPLE(Log::LOG_WARN, "Server says DedicatedActor %s moved to %s, but it was already there",
-                mapIndex.c_str(), getDescription().c_str());
+                getActorIndexDescription(mapIndex).c_str(), getDescription().c_str());
             continue;
         }
 
@@ -354,7 +351,7 @@ void Cell::readCellChange(ActorList& actorList)
             dedicatedActor->direction = baseActor.direction;
 
             LOG_MESSAGE_SIMPLE(Log::LOG_VERBOSE, "Server says DedicatedActor %s moved to %s",
-                mapIndex.c_str(), dedicatedActor->cell.getDescription().c_str());
+                getActorIndexDescription(mapIndex).c_str(), dedicatedActor->cell.getDescription().c_str());
 
             MWWorld::CellStore *newStore = cellController->getCellStore(dedicatedActor->cell);
             dedicatedActor->setCell(newStore);
@@ -363,18 +360,18 @@ void Cell::readCellChange(ActorList& actorList)
             if (cellController->isActiveWorldCell(dedicatedActor->cell) && !cellController->hasLocalAuthority(dedicatedActor->cell))
             {
                 LOG_APPEND(Log::LOG_VERBOSE, "- Moving DedicatedActor %s to our active cell %s",
-                    mapIndex.c_str(), dedicatedActor->cell.getDescription().c_str());
+                    getActorIndexDescription(mapIndex).c_str(), dedicatedActor->cell.getDescription().c_str());
                 cellController->initializeCell(dedicatedActor->cell);
                 Cell *newCell = cellController->getCell(dedicatedActor->cell);
                 newCell->dedicatedActors[mapIndex] = dedicatedActor;
-                cellController->setDedicatedActorRecord(mapIndex, newCell->getDescription());
+                cellController->setDedicatedActorRecord(mapIndex, newCell);
             }
             else
             {
                 if (cellController->hasLocalAuthority(dedicatedActor->cell))
                 {
                     LOG_APPEND(Log::LOG_VERBOSE, "- Creating new LocalActor based on %s in %s",
-                        mapIndex.c_str(), dedicatedActor->cell.getDescription().c_str());
+                        getActorIndexDescription(mapIndex).c_str(), dedicatedActor->cell.getDescription().c_str());
                     Cell *newCell = cellController->getCell(dedicatedActor->cell);
                     LocalActor *localActor = new LocalActor();
                     localActor->cell = dedicatedActor->cell;
@@ -387,11 +384,11 @@ void Cell::readCellChange(ActorList& actorList)
                     localActor->creatureStats = dedicatedActor->creatureStats;
 
                     newCell->localActors[mapIndex] = localActor;
-                    cellController->setLocalActorRecord(mapIndex, newCell->getDescription());
+                    cellController->setLocalActorRecord(mapIndex, newCell);
                 }
 
                 LOG_APPEND(Log::LOG_VERBOSE, "- Deleting DedicatedActor %s which is no longer needed",
-                    mapIndex.c_str(), getDescription().c_str());
+                    getActorIndexDescription(mapIndex).c_str(), getDescription().c_str());
                 cellController->removeDedicatedActorRecord(mapIndex);
                 delete dedicatedActor;
             }
@@ -403,8 +400,8 @@ void Cell::readCellChange(ActorList& actorList)
 
 void Cell::initializeLocalActor(const MWWorld::Ptr& ptr)
 {
-    std::string mapIndex = Main::get().getCellController()->generateMapIndex(ptr);
-    LOG_APPEND(Log::LOG_VERBOSE, "- Initializing LocalActor %s in %s", mapIndex.c_str(), getDescription().c_str());
+    ActorIndex mapIndex = Main::get().getCellController()->generateMapIndex(ptr);
+    LOG_APPEND(Log::LOG_VERBOSE, "- Initializing LocalActor %s in %s", getActorIndexDescription(mapIndex).c_str(), getDescription().c_str());
 
     LocalActor *actor = new LocalActor();
     actor->cell = *store->getCell();
@@ -417,9 +414,9 @@ void Cell::initializeLocalActor(const MWWorld::Ptr& ptr)
 
     localActors[mapIndex] = actor;
 
-    Main::get().getCellController()->setLocalActorRecord(mapIndex, getDescription());
+    Main::get().getCellController()->setLocalActorRecord(mapIndex, this);
 
-    LOG_APPEND(Log::LOG_VERBOSE, "- Successfully initialized LocalActor %s in %s", mapIndex.c_str(), getDescription().c_str());
+    LOG_APPEND(Log::LOG_VERBOSE, "- Successfully initialized LocalActor %s in %s", getActorIndexDescription(mapIndex).c_str(), getDescription().c_str());
 }
 
 void Cell::initializeLocalActors()
@@ -435,7 +432,7 @@ void Cell::initializeLocalActors()
             // If this Ptr is lacking a unique index, ignore it
             if (ptr.getCellRef().getRefNum().mIndex == 0 && ptr.getCellRef().getMpNum() == 0) continue;
 
-            std::string mapIndex = Main::get().getCellController()->generateMapIndex(ptr);
+            ActorIndex mapIndex = Main::get().getCellController()->generateMapIndex(ptr);
 
             // Only initialize this actor if it isn't already initialized
             if (localActors.count(mapIndex) == 0)
@@ -448,8 +445,8 @@ void Cell::initializeLocalActors()
 
 void Cell::initializeDedicatedActor(const MWWorld::Ptr& ptr)
 {
-    std::string mapIndex = Main::get().getCellController()->generateMapIndex(ptr);
-    LOG_APPEND(Log::LOG_VERBOSE, "- Initializing DedicatedActor %s in %s", mapIndex.c_str(), getDescription().c_str());
+    ActorIndex mapIndex = Main::get().getCellController()->generateMapIndex(ptr);
+    LOG_APPEND(Log::LOG_VERBOSE, "- Initializing DedicatedActor %s in %s", getActorIndexDescription(mapIndex).c_str(), getDescription().c_str());
 
     DedicatedActor *actor = new DedicatedActor();
     actor->cell = *store->getCell();
@@ -457,16 +454,16 @@ void Cell::initializeDedicatedActor(const MWWorld::Ptr& ptr)
 
     dedicatedActors[mapIndex] = actor;
 
-    Main::get().getCellController()->setDedicatedActorRecord(mapIndex, getDescription());
+    Main::get().getCellController()->setDedicatedActorRecord(mapIndex, this);
 
-    LOG_APPEND(Log::LOG_VERBOSE, "- Successfully initialized DedicatedActor %s in %s", mapIndex.c_str(), getDescription().c_str());
+    LOG_APPEND(Log::LOG_VERBOSE, "- Successfully initialized DedicatedActor %s in %s", getActorIndexDescription(mapIndex).c_str(), getDescription().c_str());
 }
 
 void Cell::initializeDedicatedActors(ActorList& actorList)
 {
     for (const auto &baseActor : actorList.baseActors)
     {
-        std::string mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
+        ActorIndex mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
 
         // If this key doesn't exist, create it
         if (dedicatedActors.count(mapIndex) == 0)
@@ -495,7 +492,7 @@ void Cell::uninitializeDedicatedActors(ActorList& actorList)
 {
     for (const auto &baseActor : actorList.baseActors)
     {
-        std::string mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
+        ActorIndex mapIndex = Main::get().getCellController()->generateMapIndex(baseActor);
         Main::get().getCellController()->removeDedicatedActorRecord(mapIndex);
         delete dedicatedActors.at(mapIndex);
         dedicatedActors.erase(mapIndex);
@@ -513,12 +510,12 @@ void Cell::uninitializeDedicatedActors()
     dedicatedActors.clear();
 }
 
-LocalActor *Cell::getLocalActor(std::string actorIndex)
+LocalActor *Cell::getLocalActor(ActorIndex actorIndex)
 {
     return localActors.at(actorIndex);
 }
 
-DedicatedActor *Cell::getDedicatedActor(std::string actorIndex)
+DedicatedActor *Cell::getDedicatedActor(ActorIndex actorIndex)
 {
     return dedicatedActors.at(actorIndex);
 }
@@ -1,6 +1,9 @@
 #ifndef OPENMW_MPCELL_HPP
 #define OPENMW_MPCELL_HPP
 
+#include <unordered_map>
+
+#include "ActorIndex.hpp"
 #include "ActorList.hpp"
 #include "LocalActor.hpp"
 #include "DedicatedActor.hpp"
@@ -38,8 +41,8 @@ namespace mwmp
         void uninitializeDedicatedActors(ActorList& actorList);
         void uninitializeDedicatedActors();
 
-        virtual LocalActor *getLocalActor(std::string actorIndex);
-        virtual DedicatedActor *getDedicatedActor(std::string actorIndex);
+        virtual LocalActor *getLocalActor(ActorIndex actorIndex);
+        virtual DedicatedActor *getDedicatedActor(ActorIndex actorIndex);
 
         bool hasLocalAuthority();
         void setAuthority(const RakNet::RakNetGUID& guid);
@@ -53,8 +56,8 @@ namespace mwmp
         MWWorld::CellStore* store;
         RakNet::RakNetGUID authorityGuid;
 
-        std::map<std::string, LocalActor *> localActors;
-        std::map<std::string, DedicatedActor *> dedicatedActors;
+        std::unordered_map<ActorIndex, LocalActor *> localActors;
+        std::unordered_map<ActorIndex, DedicatedActor *> dedicatedActors;
 
         float updateTimer;
     };
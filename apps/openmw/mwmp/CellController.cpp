@@ -15,8 +15,8 @@
 using namespace mwmp;
 
 std::map<std::string, mwmp::Cell *> CellController::cellsInitialized;
-std::map<std::string, std::string> CellController::localActorsToCells;
-std::map<std::string, std::string> CellController::dedicatedActorsToCells;
+ActorCellRecords<mwmp::Cell> CellController::localActorsToCells;
+ActorCellRecords<mwmp::Cell> CellController::dedicatedActorsToCells;
 
 mwmp::CellController::CellController()
 {
@@ -39,6 +39,11 @@ void CellController::updateLocal(bool forceUpdate)
         {
             mpCell->uninitializeLocalActors();
             mpCell->uninitializeDedicatedActors();
+
+            // Drop any record still pointing at this Cell, so that none can outlive it
+            localActorsToCells.removeCell(mpCell);
+            dedicatedActorsToCells.removeCell(mpCell);
+
             delete it->second;
             cellsInitialized.erase(it++);
         }
@@ -189,14 +194,14 @@ void CellController::readCellChange(ActorList& actorList)
         cellsInitialized[mapIndex]->readCellChange(actorList);
 }
 
-void CellController::setLocalActorRecord(std::string actorIndex, std::string cellIndex)
+void CellController::setLocalActorRecord(ActorIndex actorIndex, Cell *cell)
 {
-    localActorsToCells[actorIndex] = cellIndex;
+    localActorsToCells.set(actorIndex, cell);
 }
 
-void CellController::removeLocalActorRecord(std::string actorIndex)
+void CellController::removeLocalActorRecord(ActorIndex actorIndex)
 {
-    localActorsToCells.erase(actorIndex);
+    localActorsToCells.remove(actorIndex);
 }
 
 bool CellController::isLocalActor(MWWorld::Ptr ptr)
@@ -204,42 +209,36 @@ bool CellController::isLocalActor(MWWorld::Ptr ptr)
     if (ptr.mRef == nullptr)
         return false;
 
-    std::string actorIndex = generateMapIndex(ptr);
-
-    return localActorsToCells.count(actorIndex) > 0;
+    return localActorsToCells.has(generateMapIndex(ptr));
 }
 
 bool CellController::isLocalActor(int refNum, int mpNum)
 {
-    std::string actorIndex = generateMapIndex(refNum, mpNum);
-
-    return localActorsToCells.count(actorIndex) > 0;
+    return localActorsToCells.has(generateMapIndex(refNum, mpNum));
 }
 
 LocalActor *CellController::getLocalActor(MWWorld::Ptr ptr)
 {
-    std::string actorIndex = generateMapIndex(ptr);
-    std::string cellIndex = localActorsToCells.at(actorIndex);
+    ActorIndex actorIndex = generateMapIndex(ptr);
 
-    return cellsInitialized.at(cellIndex)->getLocalActor(actorIndex);
+    return localActorsToCells.get(actorIndex)->getLocalActor(actorIndex);
 }
 
 LocalActor *CellController::getLocalActor(int refNum, int mpNum)
 {
-    std::string actorIndex = generateMapIndex(refNum, mpNum);
-    std::string cellIndex = localActorsToCells.at(actorIndex);
+    ActorIndex actorIndex = generateMapIndex(refNum, mpNum);
 
-    return cellsInitialized.at(cellIndex)->getLocalActor(actorIndex);
+    return localActorsToCells.get(actorIndex)->getLocalActor(actorIndex);
 }
 
-void CellController::setDedicatedActorRecord(std::string actorIndex, std::string cellIndex)
+void CellController::setDedicatedActorRecord(ActorIndex actorIndex, Cell *cell)
 {
-    dedicatedActorsToCells[actorIndex] = cellIndex;
+    dedicatedActorsToCells.set(actorIndex, cell);
 }
 
-void CellController::removeDedicatedActorRecord(std::string actorIndex)
+void CellController::removeDedicatedActorRecord(ActorIndex actorIndex)
 {
-    dedicatedActorsToCells.erase(actorIndex);
+    dedicatedActorsToCells.remove(actorIndex);
 }
 
 bool CellController::isDedicatedActor(MWWorld::Ptr ptr)
@@ -247,47 +246,39 @@ bool CellController::isDedicatedActor(MWWorld::Ptr ptr)
     if (ptr.mRef == nullptr)
         return false;
 
-    std::string actorIndex = generateMapIndex(ptr);
-
-    return dedicatedActorsToCells.count(actorIndex) > 0;
+    return dedicatedActorsToCells.has(generateMapIndex(ptr));
 }
 
 bool CellController::isDedicatedActor(int refNum, int mpNum)
 {
-    std::string actorIndex = generateMapIndex(refNum, mpNum);
-
-    return dedicatedActorsToCells.count(actorIndex) > 0;
+    return dedicatedActorsToCells.has(generateMapIndex(refNum, mpNum));
 }
 
 DedicatedActor *CellController::getDedicatedActor(MWWorld::Ptr ptr)
 {
-    std::string actorIndex = generateMapIndex(ptr);
-    std::string cellIndex = dedicatedActorsToCells.at(actorIndex);
+    ActorIndex actorIndex = generateMapIndex(ptr);
 
-    return cellsInitialized.at(cellIndex)->getDedicatedActor(actorIndex);
+    return dedicatedActorsToCells.get(actorIndex)->getDedicatedActor(actorIndex);
 }
 
 DedicatedActor *CellController::getDedicatedActor(int refNum, int mpNum)
 {
-    std::string actorIndex = generateMapIndex(refNum, mpNum);
-    std::string cellIndex = dedicatedActorsToCells.at(actorIndex);
+    ActorIndex actorIndex = generateMapIndex(refNum, mpNum);
 
-    return cellsInitialized.at(cellIndex)->getDedicatedActor(actorIndex);
+    return dedicatedActorsToCells.get(actorIndex)->getDedicatedActor(actorIndex);
 }
 
-std::string CellController::generateMapIndex(int refNum, int mpNum)
+ActorIndex CellController::generateMapIndex(int refNum, int mpNum)
 {
-    std::string mapIndex = "";
-    mapIndex = Utils::toString(refNum) + "-" + Utils::toString(mpNum);
-    return mapIndex;
+    return generateActorIndex(refNum, mpNum);
 }
 
-std::string CellController::generateMapIndex(MWWorld::Ptr ptr)
+ActorIndex CellController::generateMapIndex(const MWWorld::Ptr& ptr)
 {
-    return generateMapIndex(ptr.getCellRef().getRefNum().mIndex, ptr.getCellRef().getMpNum());
+    return generateActorIndex(ptr.getCellRef().getRefNum().mIndex, ptr.getCellRef().getMpNum());
 }
 
-std::string CellController::generateMapIndex(BaseActor baseActor)
+ActorIndex CellController::generateMapIndex(const BaseActor& baseActor)
 {
     return generateMapIndex(baseActor.refNum, baseActor.mpNum);
 }
@@ -31,25 +31,25 @@ namespace mwmp
         void readAttack(mwmp::ActorList& actorList);
         void readCellChange(mwmp::ActorList& actorList);
 
-        void setLocalActorRecord(std::string actorIndex, std::string cellIndex);
-        void removeLocalActorRecord(std::string actorIndex);
+        void setLocalActorRecord(ActorIndex actorIndex, Cell *cell);
+        void removeLocalActorRecord(ActorIndex actorIndex);
         
         bool isLocalActor(MWWorld::Ptr ptr);
         bool isLocalActor(int refNum, int mpNum);
         virtual LocalActor *getLocalActor(MWWorld::Ptr ptr);
         virtual LocalActor *getLocalActor(int refNum, int mpNum);
 
-        void setDedicatedActorRecord(std::string actorIndex, std::string cellIndex);
-        void removeDedicatedActorRecord(std::string actorIndex);
+        void setDedicatedActorRecord(ActorIndex actorIndex, Cell *cell);
+        void removeDedicatedActorRecord(ActorIndex actorIndex);
         
         bool isDedicatedActor(MWWorld::Ptr ptr);
         bool isDedicatedActor(int refNum, int mpNum);
         virtual DedicatedActor *getDedicatedActor(MWWorld::Ptr ptr);
         virtual DedicatedActor *getDedicatedActor(int refNum, int mpNum);
 
-        std::string generateMapIndex(int refNumindex, int mpNum);
-        std::string generateMapIndex(MWWorld::Ptr ptr);
-        std::string generateMapIndex(mwmp::BaseActor baseActor);
+        ActorIndex generateMapIndex(int refNum, int mpNum);
+        ActorIndex generateMapIndex(const MWWorld::Ptr& ptr);
+        ActorIndex generateMapIndex(const mwmp::BaseActor& baseActor);
 
         bool hasLocalAuthority(const ESM::Cell& cell);
         bool isInitializedCell(const std::string& cellDescription);
@@ -65,8 +65,8 @@ namespace mwmp
 
     private:
         static std::map<std::string, mwmp::Cell *> cellsInitialized;
-        static std::map<std::string, std::string> localActorsToCells;
-        static std::map<std::string, std::string> dedicatedActorsToCells;
+        static ActorCellRecords<mwmp::Cell> localActorsToCells;
+        static ActorCellRecords<mwmp::Cell> dedicatedActorsToCells;
     };
 }
 
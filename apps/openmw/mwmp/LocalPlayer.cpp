@@ -772,7 +772,10 @@ void LocalPlayer::addTopics()
         env.getDialogueManager()->addTopic(topicId);
 
         if (env.getWindowManager()->containsMode(MWGui::GM_Dialogue))
+        {
+            env.getDialogueManager()->invalidateVolatileTopics();
             env.getDialogueManager()->updateActorKnownTopics();
+        }
     }
 }
 
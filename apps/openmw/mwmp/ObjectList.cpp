@@ -369,6 +369,7 @@ void ObjectList::placeObjects(MWWorld::CellStore* cellStore)
 
                 // Because gold automatically gets replaced with a new object, make sure we set the mpNum at the end
                 newPtr.getCellRef().setMpNum(baseObject.mpNum);
+                newPtr.getCell()->updateUniqueIndex(newPtr);
 
                 if (guid == Main::get().getLocalPlayer()->guid && baseObject.droppedByPlayer)
                     world->PCDropped(newPtr);
@@ -6,6 +6,9 @@
 #include "PlayerProcessor.hpp"
 #include "../Main.hpp"
 
+#include "../../mwbase/environment.hpp"
+#include "../../mwbase/dialoguemanager.hpp"
+
 using namespace mwmp;
 
 template<class T>
@@ -44,6 +47,12 @@ bool PlayerProcessor::Process(RakNet::Packet &packet)
             }
 
             processor.second->Do(*myPacket, player);
+
+            // Server updates to the local player (stats, factions, inventory resets, ...) can change what dialogue
+            // filters read without going through the notifications the dialogue manager relies on
+            if (!request && player != 0 && guid == myGuid)
+                MWBase::Environment::get().getDialogueManager()->invalidateVolatileTopics();
+
             return true;
         }
     }
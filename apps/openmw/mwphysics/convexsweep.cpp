@@ -0,0 +1,65 @@
+#include "convexsweep.hpp"
+
+#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
+#include <BulletCollision/CollisionShapes/btConvexShape.h>
+
+namespace
+{
+    class SweepCallback : public btDbvt::ICollide
+    {
+    public:
+        SweepCallback(const btConvexShape* castShape, const btTransform& from, const btTransform& to,
+                      btCollisionWorld::ConvexResultCallback& resultCallback)
+            : mCastShape(castShape)
+            , mFrom(from)
+            , mTo(to)
+            , mResultCallback(resultCallback)
+        {
+        }
+
+        virtual void Process(const btDbvtNode* leaf)
+        {
+            if (mResultCallback.m_closestHitFraction == btScalar(0.f))
+                return;
+
+            const btBroadphaseProxy* proxy = static_cast<const btBroadphaseProxy*>(leaf->data);
+            const btCollisionObject* collisionObject = static_cast<const btCollisionObject*>(proxy->m_clientObject);
+            if (mResultCallback.needsCollision(collisionObject->getBroadphaseHandle()))
+                btCollisionWorld::objectQuerySingle(mCastShape, mFrom, mTo, collisionObject, collisionObject->getCollisionShape(),
+                                                    collisionObject->getWorldTransform(), mResultCallback, btScalar(0.f));
+        }
+
+    private:
+        const btConvexShape* mCastShape;
+        const btTransform& mFrom;
+        const btTransform& mTo;
+        btCollisionWorld::ConvexResultCallback& mResultCallback;
+    };
+}
+
+namespace MWPhysics
+{
+    void convexSweepTest(const btCollisionWorld* world, const btConvexShape* castShape, const btTransform& from,
+                         const btTransform& to, btCollisionWorld::ConvexResultCallback& resultCallback)
+    {
+        const btDbvtBroadphase* broadphase = dynamic_cast<const btDbvtBroadphase*>(world->getBroadphase());
+        if (!broadphase)
+        {
+            world->convexSweepTest(castShape, from, to, resultCallback);
+            return;
+        }
+
+        // The swept volume of a translated shape is bounded by its bounding boxes at both ends
+        btVector3 fromMin, fromMax, toMin, toMax;
+        castShape->getAabb(from, fromMin, fromMax);
+        castShape->getAabb(to, toMin, toMax);
+        fromMin.setMin(toMin);
+        fromMax.setMax(toMax);
+        const btDbvtVolume bounds = btDbvtVolume::FromMM(fromMin, fromMax);
+
+        // collideTV() keeps its traversal stack on the stack, unlike btDbvtBroadphase::rayTest()
+        SweepCallback callback(castShape, from, to, resultCallback);
+        for (int i = 0; i < 2; ++i)
+            broadphase->m_sets[i].collideTV(broadphase->m_sets[i].m_root, bounds, callback);
+    }
+}
@@ -0,0 +1,19 @@
+#ifndef OPENMW_MWPHYSICS_CONVEXSWEEP_H
+#define OPENMW_MWPHYSICS_CONVEXSWEEP_H
+
+#include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
+
+class btConvexShape;
+
+namespace MWPhysics
+{
+    /// Sweep \a castShape from \a from to \a to through \a world and report the hits to \a resultCallback.
+    ///
+    /// Equivalent to btCollisionWorld::convexSweepTest(), except that the broadphase traversal keeps its state
+    /// on the stack instead of in the broadphase, so several threads may query the same world at once, provided
+    /// that nothing modifies the world meanwhile. Hits that are equally close may be reported in a different order.
+    void convexSweepTest(const btCollisionWorld* world, const btConvexShape* castShape, const btTransform& from,
+                         const btTransform& to, btCollisionWorld::ConvexResultCallback& resultCallback);
+}
+
+#endif
@@ -0,0 +1,116 @@
+#include "parallelmovement.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include <components/sceneutil/workqueue.hpp>
+
+namespace
+{
+    class MoveWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        MoveWorkItem(MWPhysics::ParallelMovement::Mover& mover, std::size_t begin, std::size_t end)
+            : mMover(mover)
+            , mBegin(begin)
+            , mEnd(end)
+        {
+        }
+
+        virtual void doWork()
+        {
+            try
+            {
+                for (std::size_t i=mBegin; i<mEnd; ++i)
+                    mMover.move(i);
+            }
+            catch (std::exception& e)
+            {
+                mError = e.what();
+            }
+        }
+
+        /// The error that interrupted the work, if any
+        const std::string& getError() const
+        {
+            return mError;
+        }
+
+    private:
+        MWPhysics::ParallelMovement::Mover& mMover;
+        std::size_t mBegin;
+        std::size_t mEnd;
+        std::string mError;
+    };
+}
+
+namespace MWPhysics
+{
+    ParallelMovement::ParallelMovement(int numThreads)
+        : mWorkQueue(new SceneUtil::WorkQueue(numThreads))
+        // Several work items per thread, so that threads finishing early can take over some of the work
+        , mNumWorkItems(numThreads * 4)
+    {
+    }
+
+    ParallelMovement::~ParallelMovement()
+    {
+    }
+
+    std::size_t ParallelMovement::move(Mover& mover, std::size_t numActors)
+    {
+        // Gather the bounds before anything moves, the reach depends on the actors' state before moving
+        mBounds.resize(numActors);
+        mReach.resize(numActors);
+        for (std::size_t i=0; i<numActors; ++i)
+        {
+            mBounds[i] = mover.getBounds(i);
+            mReach[i] = mover.getReach(i);
+        }
+
+        const std::size_t numItems = std::min(numActors, mNumWorkItems);
+        std::vector<osg::ref_ptr<MoveWorkItem> > workItems;
+        for (std::size_t item=0; item<numItems; ++item)
+        {
+            workItems.push_back(new MoveWorkItem(mover, numActors * item / numItems, numActors * (item+1) / numItems));
+            mWorkQueue->addWorkItem(workItems.back());
+        }
+
+        std::string error;
+        for (std::vector<osg::ref_ptr<MoveWorkItem> >::const_iterator it = workItems.begin(); it != workItems.end(); ++it)
+        {
+            (*it)->waitTillDone();
+            if (error.empty())
+                error = (*it)->getError();
+        }
+        if (!error.empty())
+            throw std::runtime_error(error);
+
+        std::size_t numMovedAgain = 0;
+        mMovedBounds.clear();
+        for (std::size_t i=0; i<numActors; ++i)
+        {
+            for (std::vector<osg::BoundingBox>::const_iterator it = mMovedBounds.begin(); it != mMovedBounds.end(); ++it)
+            {
+                if (mReach[i].intersects(*it))
+                {
+                    mover.moveAgain(i);
+                    ++numMovedAgain;
+                    break;
+                }
+            }
+
+            mover.apply(i);
+
+            const osg::BoundingBox bounds = mover.getBounds(i);
+            if (bounds != mBounds[i])
+            {
+                osg::BoundingBox movedBounds = mBounds[i];
+                movedBounds.expandBy(bounds);
+                mMovedBounds.push_back(movedBounds);
+            }
+        }
+        return numMovedAgain;
+    }
+}
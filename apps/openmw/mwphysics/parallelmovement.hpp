@@ -0,0 +1,69 @@
+#ifndef OPENMW_MWPHYSICS_PARALLELMOVEMENT_H
+#define OPENMW_MWPHYSICS_PARALLELMOVEMENT_H
+
+#include <vector>
+
+#include <osg/BoundingBox>
+#include <osg/ref_ptr>
+
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
+namespace MWPhysics
+{
+    /// @brief Moves a list of actors on worker threads, with the same results as moving them one after another in list order.
+    /// @par First, every actor is moved on a worker thread against the collision world as it was before any actor moved.
+    /// Then the results are applied on the calling thread, in list order. Moving an actor only looks at the collision objects
+    /// within its reach, so the result of the worker thread is the one the serial solver would have found, unless an actor that
+    /// was moved before it had its old or new bounds within that reach. Such an actor is moved again on the calling thread,
+    /// against the world that holds the new positions of all actors before it. The results do not depend on the number of
+    /// threads or on the order in which the work completes.
+    class ParallelMovement
+    {
+    public:
+        /// The actors to move.
+        class Mover
+        {
+        public:
+            virtual ~Mover() {}
+
+            /// Move actor \a index. Called on the worker threads for all actors at once, so this must only read the collision
+            /// world and only write the state of this actor.
+            virtual void move(std::size_t index) = 0;
+
+            /// Restore the state actor \a index had before move() and move it again. Called on the calling thread.
+            virtual void moveAgain(std::size_t index) = 0;
+
+            /// Update the actor's collision object to the result of the last move() or moveAgain(). Called on the calling thread.
+            virtual void apply(std::size_t index) = 0;
+
+            /// The bounds that collision queries use for the actor's collision object.
+            virtual osg::BoundingBox getBounds(std::size_t index) const = 0;
+
+            /// Bounds of all collision queries that moving the actor can make.
+            virtual osg::BoundingBox getReach(std::size_t index) const = 0;
+        };
+
+        ParallelMovement(int numThreads);
+        ~ParallelMovement();
+
+        /// Move actors 0 to \a numActors-1 of \a mover.
+        /// @return The number of actors that had to be moved again on the calling thread.
+        /// @note Rethrows the first error thrown by Mover::move(), after all worker threads are done.
+        std::size_t move(Mover& mover, std::size_t numActors);
+
+    private:
+        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+        std::size_t mNumWorkItems;
+
+        std::vector<osg::BoundingBox> mBounds;
+        std::vector<osg::BoundingBox> mReach;
+
+        /// Old and new bounds of the actors that were applied with a different position
+        std::vector<osg::BoundingBox> mMovedBounds;
+    };
+}
+
+#endif
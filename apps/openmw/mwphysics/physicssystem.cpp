@@ -24,6 +24,7 @@
 #include <components/esm/loadgmst.hpp>
 #include <components/sceneutil/positionattitudetransform.hpp>
 #include <components/sceneutil/unrefqueue.hpp>
+#include <components/settings/settings.hpp>
 
 #include <components/nifosg/particle.hpp> // FindRecIndexVisitor
 
@@ -48,6 +49,7 @@
 #include "actor.hpp"
 #include "convert.hpp"
 #include "trace.h"
+#include "parallelmovement.hpp"
 
 namespace MWPhysics
 {
@@ -276,7 +278,7 @@ namespace MWPhysics
 
         static osg::Vec3f move(osg::Vec3f position, const MWWorld::Ptr &ptr, Actor* physicActor, const osg::Vec3f &movement, float time,
                                   bool isFlying, float waterlevel, float slowFall, const btCollisionWorld* collisionWorld,
-                               std::map<MWWorld::Ptr, MWWorld::Ptr>& standingCollisionTracker)
+                               CollisionMap& standingCollisionTracker)
         {
             const ESM::Position& refpos = ptr.getRefData().getPosition();
             // Early-out for totally static creatures
@@ -505,6 +507,32 @@ namespace MWPhysics
     };
 
 
+    /// State of one actor's movement during the physics steps of a frame
+    struct ActorMovement
+    {
+        MWWorld::Ptr mPtr;
+        Actor* mActor;
+        osg::Vec3f mVelocity;
+        float mWaterlevel;
+        float mSlowFall;
+        bool mFlying;
+        float mOldHeight;
+
+        /// State of the actor before moving
+        bool mWasOnGround;
+        bool mWasOnSlope;
+        osg::Vec3f mInertia;
+
+        /// Position after the last applied step
+        osg::Vec3f mPosition;
+        bool mPositionChanged;
+
+        /// Positions found for each step on the movement threads, before they are applied
+        std::vector<osg::Vec3f> mSteps;
+        CollisionMap mStandingCollisions;
+    };
+
+
     // ---------------------------------------------------------------
 
     class HeightField
@@ -682,6 +710,7 @@ namespace MWPhysics
         : mShapeManager(new Resource::BulletShapeManager(resourceSystem->getVFS(), resourceSystem->getSceneManager(), resourceSystem->getNifFileManager()))
         , mResourceSystem(resourceSystem)
         , mDebugDrawEnabled(false)
+        , mStandingActorsDirty(true)
         , mTimeAccum(0.0f)
         , mWaterHeight(0)
         , mWaterEnabled(false)
@@ -690,6 +719,18 @@ namespace MWPhysics
     {
         mResourceSystem->addResourceManager(mShapeManager.get());
 
+        int numMovementThreads = Settings::Manager::getInt("movement threads", "Physics");
+#ifndef OPENMW_BULLET_PROFILER_THREAD_SAFE
+        if (numMovementThreads > 0)
+        {
+            std::cerr << "Warning: 'movement threads' is ignored, because Bullet's profiler is not thread-safe. "
+                      << "Bullet 2.87 or newer, or Bullet built with BT_NO_PROFILE, is required." << std::endl;
+            numMovementThreads = 0;
+        }
+#endif
+        if (numMovementThreads > 0)
+            mParallelMovement.reset(new ParallelMovement(numMovementThreads));
+
         mCollisionConfiguration = new btDefaultCollisionConfiguration();
         mDispatcher = new btCollisionDispatcher(mCollisionConfiguration);
         mBroadphase = new btDbvtBroadphase();
@@ -1239,8 +1280,10 @@ namespace MWPhysics
         CollisionMap::iterator found = map.find(old);
         if (found != map.end())
         {
-            map[updated] = found->second;
+            // inserting may rehash, so erase first
+            MWWorld::Ptr collided = found->second;
             map.erase(found);
+            map[updated] = collided;
         }
 
         for (CollisionMap::iterator it = map.begin(); it != map.end(); ++it)
@@ -1271,6 +1314,7 @@ namespace MWPhysics
         }
 
         updateCollisionMapPtr(mStandingCollisions, old, updated);
+        mStandingActorsDirty = true;
     }
 
     Actor *PhysicsSystem::getActor(const MWWorld::Ptr &ptr)
@@ -1398,6 +1442,188 @@ namespace MWPhysics
     {
         mMovementQueue.clear();
         mStandingCollisions.clear();
+        mStandingActorsDirty = true;
+    }
+
+    /// Moves the queued actors for ParallelMovement
+    class PhysicsSystem::ActorMover : public ParallelMovement::Mover
+    {
+    public:
+        ActorMover(PhysicsSystem& physics, std::vector<ActorMovement>& movements, int numSteps)
+            : mPhysics(physics)
+            , mMovements(movements)
+            , mNumSteps(numSteps)
+        {
+        }
+
+        virtual void move(std::size_t index)
+        {
+            ActorMovement& movement = mMovements[index];
+            movement.mSteps.clear();
+            movement.mStandingCollisions.clear();
+
+            osg::Vec3f position = movement.mPosition;
+            for (int i=0; i<mNumSteps; ++i)
+            {
+                position = MovementSolver::move(position, movement.mActor->getPtr(), movement.mActor, movement.mVelocity,
+                                                mPhysics.mPhysicsDt, movement.mFlying, movement.mWaterlevel, movement.mSlowFall,
+                                                mPhysics.mCollisionWorld, movement.mStandingCollisions);
+                movement.mSteps.push_back(position);
+            }
+        }
+
+        virtual void moveAgain(std::size_t index)
+        {
+            const ActorMovement& movement = mMovements[index];
+            Actor* physicActor = movement.mActor;
+            physicActor->setInertialForce(movement.mInertia);
+            physicActor->setOnGround(movement.mWasOnGround);
+            physicActor->setOnSlope(movement.mWasOnSlope);
+            move(index);
+        }
+
+        virtual void apply(std::size_t index)
+        {
+            ActorMovement& movement = mMovements[index];
+            for (std::vector<osg::Vec3f>::const_iterator it = movement.mSteps.begin(); it != movement.mSteps.end(); ++it)
+                mPhysics.applyMovementStep(movement, *it);
+
+            // The actors moved again after this one have to find it at its new position
+            if (movement.mPositionChanged)
+                mPhysics.mCollisionWorld->updateSingleAabb(movement.mActor->getCollisionObject());
+
+            for (CollisionMap::const_iterator it = movement.mStandingCollisions.begin(); it != movement.mStandingCollisions.end(); ++it)
+                mPhysics.mStandingCollisions[it->first] = it->second;
+        }
+
+        virtual osg::BoundingBox getBounds(std::size_t index) const
+        {
+            const btCollisionObject* object = mMovements[index].mActor->getCollisionObject();
+            btVector3 aabbMin, aabbMax;
+            object->getCollisionShape()->getAabb(object->getWorldTransform(), aabbMin, aabbMax);
+            osg::BoundingBox bounds (toOsg(aabbMin), toOsg(aabbMax));
+
+            // The broadphase bounds lag behind if the position was set without updating them
+            if (const btBroadphaseProxy* proxy = object->getBroadphaseHandle())
+                bounds.expandBy(osg::BoundingBox(toOsg(proxy->m_aabbMin), toOsg(proxy->m_aabbMax)));
+            return bounds;
+        }
+
+        virtual osg::BoundingBox getReach(std::size_t index) const
+        {
+            const ActorMovement& movement = mMovements[index];
+            const Actor* physicActor = movement.mActor;
+            const float time = mPhysics.mPhysicsDt;
+
+            // Bound on the speed of MovementSolver::move(): the movement plus the inertia, which gains speed from gravity and is
+            // set to 100 when sliding off another actor. Dead actors float up at 25.
+            float speed = movement.mVelocity.length() + std::max(movement.mInertia.length(), 100.f) + mNumSteps * time * 627.2f;
+            speed = std::max(speed, 25.f);
+
+            // Each step traces at most sMaxIterations times, each trace covering at most one step's distance plus a small back off,
+            // and possibly stepping up or down. Then it traces down to the ground.
+            const float distance = speed * time + physicActor->getHalfExtents().length() * 1E-2f;
+            const float horizontal = mNumSteps * sMaxIterations * distance;
+            const float up = mNumSteps * sMaxIterations * (distance + sStepSizeUp);
+            const float down = mNumSteps * (sMaxIterations * (distance + sStepSizeDown) + sStepSizeDown + 2*sGroundOffset);
+
+            // MovementSolver::move() sweeps the shape from the position raised by its half height
+            osg::Vec3f position = movement.mPosition;
+            position.z() += physicActor->getHalfExtents().z();
+            btTransform transform = physicActor->getCollisionObject()->getWorldTransform();
+            transform.setOrigin(toBullet(position));
+            btVector3 aabbMin, aabbMax;
+            physicActor->getConvexShape()->getAabb(transform, aabbMin, aabbMax);
+
+            return osg::BoundingBox(toOsg(aabbMin) - osg::Vec3f(horizontal, horizontal, down),
+                                    toOsg(aabbMax) + osg::Vec3f(horizontal, horizontal, up));
+        }
+
+    private:
+        PhysicsSystem& mPhysics;
+        std::vector<ActorMovement>& mMovements;
+        int mNumSteps;
+    };
+
+    bool PhysicsSystem::prepareMovement(const MWWorld::Ptr& ptr, const osg::Vec3f& velocity, ActorMovement& movement)
+    {
+        ActorMap::iterator foundActor = mActors.find(ptr);
+        if (foundActor == mActors.end()) // actor was already removed from the scene
+            return false;
+        Actor* physicActor = foundActor->second;
+
+        const MWBase::World *world = MWBase::Environment::get().getWorld();
+
+        float waterlevel = -std::numeric_limits<float>::max();
+        const MWWorld::CellStore *cell = ptr.getCell();
+        if(cell->getCell()->hasWater())
+            waterlevel = cell->getWaterLevel();
+
+        const MWMechanics::MagicEffects& effects = ptr.getClass().getCreatureStats(ptr).getMagicEffects();
+
+        bool waterCollision = false;
+        if (cell->getCell()->hasWater() && effects.get(ESM::MagicEffect::WaterWalking).getMagnitude())
+        {
+            if (!world->isUnderwater(ptr.getCell(), osg::Vec3f(ptr.getRefData().getPosition().asVec3())))
+                waterCollision = true;
+            else if (physicActor->getCollisionMode() && canMoveToWaterSurface(ptr, waterlevel))
+            {
+                const osg::Vec3f actorPosition = physicActor->getPosition();
+                physicActor->setPosition(osg::Vec3f(actorPosition.x(), actorPosition.y(), waterlevel));
+                waterCollision = true;
+            }
+        }
+        physicActor->setCanWaterWalk(waterCollision);
+
+        movement.mPtr = ptr;
+        movement.mActor = physicActor;
+        movement.mVelocity = velocity;
+        movement.mWaterlevel = waterlevel;
+
+        // Slow fall reduces fall speed by a factor of (effect magnitude / 200)
+        movement.mSlowFall = 1.f - std::max(0.f, std::min(1.f, effects.get(ESM::MagicEffect::SlowFall).getMagnitude() * 0.005f));
+
+        movement.mFlying = world->isFlying(ptr);
+
+        movement.mWasOnGround = physicActor->getOnGround();
+        movement.mWasOnSlope = physicActor->getOnSlope();
+        movement.mInertia = physicActor->getInertialForce();
+        movement.mPosition = physicActor->getPosition();
+        movement.mOldHeight = movement.mPosition.z();
+        movement.mPositionChanged = false;
+        return true;
+    }
+
+    void PhysicsSystem::applyMovementStep(ActorMovement& movement, const osg::Vec3f& position)
+    {
+        movement.mPosition = position;
+        if (position != movement.mActor->getPosition())
+            movement.mPositionChanged = true;
+        movement.mActor->setPosition(position); // always set even if unchanged to make sure interpolation is correct
+    }
+
+    void PhysicsSystem::finishMovement(const ActorMovement& movement)
+    {
+        Actor* physicActor = movement.mActor;
+        const osg::Vec3f& position = movement.mPosition;
+
+        if (movement.mPositionChanged)
+            mCollisionWorld->updateSingleAabb(physicActor->getCollisionObject());
+
+        float interpolationFactor = mTimeAccum / mPhysicsDt;
+        osg::Vec3f interpolated = position * interpolationFactor + physicActor->getPreviousPosition() * (1.f - interpolationFactor);
+
+        float heightDiff = position.z() - movement.mOldHeight;
+
+        const MWWorld::Ptr& ptr = movement.mPtr;
+        MWMechanics::CreatureStats& stats = ptr.getClass().getCreatureStats(ptr);
+        if ((movement.mWasOnGround && physicActor->getOnGround()) || movement.mFlying
+                || MWBase::Environment::get().getWorld()->isSwimming(ptr) || movement.mSlowFall < 1)
+            stats.land();
+        else if (heightDiff < 0)
+            stats.addToFallHeight(-heightDiff);
+
+        mMovementResults.push_back(std::make_pair(ptr, interpolated));
     }
 
     const PtrVelocityList& PhysicsSystem::applyQueuedMovement(float dt)
@@ -1418,71 +1644,44 @@ namespace MWPhysics
             mStandingCollisions.clear();
         }
 
-        const MWBase::World *world = MWBase::Environment::get().getWorld();
-        PtrVelocityList::iterator iter = mMovementQueue.begin();
-        for(;iter != mMovementQueue.end();++iter)
+        if (mParallelMovement && numSteps > 0 && mMovementQueue.size() > 1)
         {
-            ActorMap::iterator foundActor = mActors.find(iter->first);
-            if (foundActor == mActors.end()) // actor was already removed from the scene
-                continue;
-            Actor* physicActor = foundActor->second;
-
-            float waterlevel = -std::numeric_limits<float>::max();
-            const MWWorld::CellStore *cell = iter->first.getCell();
-            if(cell->getCell()->hasWater())
-                waterlevel = cell->getWaterLevel();
-
-            const MWMechanics::MagicEffects& effects = iter->first.getClass().getCreatureStats(iter->first).getMagicEffects();
-
-            bool waterCollision = false;
-            if (cell->getCell()->hasWater() && effects.get(ESM::MagicEffect::WaterWalking).getMagnitude())
+            std::vector<ActorMovement> movements (mMovementQueue.size());
+            std::vector<ActorMovement>::iterator movement = movements.begin();
+            for (PtrVelocityList::iterator iter = mMovementQueue.begin(); iter != mMovementQueue.end(); ++iter)
             {
-                if (!world->isUnderwater(iter->first.getCell(), osg::Vec3f(iter->first.getRefData().getPosition().asVec3())))
-                    waterCollision = true;
-                else if (physicActor->getCollisionMode() && canMoveToWaterSurface(iter->first, waterlevel))
-                {
-                    const osg::Vec3f actorPosition = physicActor->getPosition();
-                    physicActor->setPosition(osg::Vec3f(actorPosition.x(), actorPosition.y(), waterlevel));
-                    waterCollision = true;
-                }
+                if (prepareMovement(iter->first, iter->second, *movement))
+                    ++movement;
             }
-            physicActor->setCanWaterWalk(waterCollision);
+            movements.erase(movement, movements.end());
 
-            // Slow fall reduces fall speed by a factor of (effect magnitude / 200)
-            float slowFall = 1.f - std::max(0.f, std::min(1.f, effects.get(ESM::MagicEffect::SlowFall).getMagnitude() * 0.005f));
+            ActorMover mover (*this, movements, numSteps);
+            mParallelMovement->move(mover, movements.size());
 
-            bool flying = world->isFlying(iter->first);
-
-            bool wasOnGround = physicActor->getOnGround();
-            osg::Vec3f position = physicActor->getPosition();
-            float oldHeight = position.z();
-            bool positionChanged = false;
-            for (int i=0; i<numSteps; ++i)
+            for (movement = movements.begin(); movement != movements.end(); ++movement)
+                finishMovement(*movement);
+        }
+        else
+        {
+            ActorMovement movement;
+            for (PtrVelocityList::iterator iter = mMovementQueue.begin(); iter != mMovementQueue.end(); ++iter)
             {
-                position = MovementSolver::move(position, physicActor->getPtr(), physicActor, iter->second, mPhysicsDt,
-                                                flying, waterlevel, slowFall, mCollisionWorld, mStandingCollisions);
-                if (position != physicActor->getPosition())
-                    positionChanged = true;
-                physicActor->setPosition(position); // always set even if unchanged to make sure interpolation is correct
-            }
-            if (positionChanged)
-                mCollisionWorld->updateSingleAabb(physicActor->getCollisionObject());
+                if (!prepareMovement(iter->first, iter->second, movement))
+                    continue;
 
-            float interpolationFactor = mTimeAccum / mPhysicsDt;
-            osg::Vec3f interpolated = position * interpolationFactor + physicActor->getPreviousPosition() * (1.f - interpolationFactor);
-
-            float heightDiff = position.z() - oldHeight;
-
-            MWMechanics::CreatureStats& stats = iter->first.getClass().getCreatureStats(iter->first);
-            if ((wasOnGround && physicActor->getOnGround()) || flying || world->isSwimming(iter->first) || slowFall < 1)
-                stats.land();
-            else if (heightDiff < 0)
-                stats.addToFallHeight(-heightDiff);
+                for (int i=0; i<numSteps; ++i)
+                {
+                    applyMovementStep(movement, MovementSolver::move(movement.mPosition, movement.mActor->getPtr(), movement.mActor,
+                                                                     movement.mVelocity, mPhysicsDt, movement.mFlying, movement.mWaterlevel,
+                                                                     movement.mSlowFall, mCollisionWorld, mStandingCollisions));
+                }
 
-            mMovementResults.push_back(std::make_pair(iter->first, interpolated));
+                finishMovement(movement);
+            }
         }
 
         mMovementQueue.clear();
+        mStandingActorsDirty = true;
 
         return mMovementResults;
     }
@@ -1506,21 +1705,23 @@ namespace MWPhysics
 
     bool PhysicsSystem::isActorStandingOn(const MWWorld::Ptr &actor, const MWWorld::ConstPtr &object) const
     {
-        for (CollisionMap::const_iterator it = mStandingCollisions.begin(); it != mStandingCollisions.end(); ++it)
-        {
-            if (it->first == actor && it->second == object)
-                return true;
-        }
-        return false;
+        CollisionMap::const_iterator found = mStandingCollisions.find(actor);
+        return found != mStandingCollisions.end() && found->second == object;
     }
 
     void PhysicsSystem::getActorsStandingOn(const MWWorld::ConstPtr &object, std::vector<MWWorld::Ptr> &out) const
     {
-        for (CollisionMap::const_iterator it = mStandingCollisions.begin(); it != mStandingCollisions.end(); ++it)
+        if (mStandingActorsDirty)
         {
-            if (it->second == object)
-                out.push_back(it->first);
+            mStandingActors.clear();
+            for (CollisionMap::const_iterator it = mStandingCollisions.begin(); it != mStandingCollisions.end(); ++it)
+                mStandingActors[it->second].push_back(it->first);
+            mStandingActorsDirty = false;
         }
+
+        StandingActorsMap::const_iterator found = mStandingActors.find(object);
+        if (found != mStandingActors.end())
+            out.insert(out.end(), found->second.begin(), found->second.end());
     }
 
     bool PhysicsSystem::isActorCollidingWith(const MWWorld::Ptr &actor, const MWWorld::ConstPtr &object) const
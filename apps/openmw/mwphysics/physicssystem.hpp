@@ -4,6 +4,7 @@
 #include <memory>
 #include <map>
 #include <set>
+#include <unordered_map>
 
 #include <osg/Quat>
 #include <osg/ref_ptr>
@@ -45,9 +46,14 @@ namespace MWPhysics
 {
     typedef std::vector<std::pair<MWWorld::Ptr,osg::Vec3f> > PtrVelocityList;
 
+    /// <actor handle, collided handle>
+    typedef std::unordered_map<MWWorld::Ptr, MWWorld::Ptr, MWWorld::PtrHash> CollisionMap;
+
     class HeightField;
     class Object;
     class Actor;
+    class ParallelMovement;
+    struct ActorMovement;
 
     class PhysicsSystem
     {
@@ -184,8 +190,23 @@ namespace MWPhysics
 
             void updateWater();
 
+            class ActorMover;
+
+            /// Gather the inputs for moving \a ptr by \a velocity this frame.
+            /// \return false if the actor is no longer in the scene.
+            bool prepareMovement(const MWWorld::Ptr& ptr, const osg::Vec3f& velocity, ActorMovement& movement);
+
+            /// Move the actor to the \a position found for one physics step.
+            void applyMovementStep(ActorMovement& movement, const osg::Vec3f& position);
+
+            /// Update the actor's collision bounds and fall height after the frame's physics steps.
+            void finishMovement(const ActorMovement& movement);
+
             osg::ref_ptr<SceneUtil::UnrefQueue> mUnrefQueue;
 
+            /// Set if actors are moved on movement threads
+            std::unique_ptr<ParallelMovement> mParallelMovement;
+
             btBroadphaseInterface* mBroadphase;
             btDefaultCollisionConfiguration* mCollisionConfiguration;
             btCollisionDispatcher* mDispatcher;
@@ -194,12 +215,12 @@ namespace MWPhysics
             std::unique_ptr<Resource::BulletShapeManager> mShapeManager;
             Resource::ResourceSystem* mResourceSystem;
 
-            typedef std::map<MWWorld::ConstPtr, Object*> ObjectMap;
+            typedef std::unordered_map<MWWorld::ConstPtr, Object*, MWWorld::PtrHash> ObjectMap;
             ObjectMap mObjects;
 
             std::set<Object*> mAnimatedObjects; // stores pointers to elements in mObjects
 
-            typedef std::map<MWWorld::ConstPtr, Actor*> ActorMap;
+            typedef std::unordered_map<MWWorld::ConstPtr, Actor*, MWWorld::PtrHash> ActorMap;
             ActorMap mActors;
 
             typedef std::map<std::pair<int, int>, HeightField*> HeightFieldMap;
@@ -207,11 +228,15 @@ namespace MWPhysics
 
             bool mDebugDrawEnabled;
 
-            // Tracks standing collisions happening during a single frame. <actor handle, collided handle>
+            // Tracks standing collisions happening during a single frame.
             // This will detect standing on an object, but won't detect running e.g. against a wall.
-            typedef std::map<MWWorld::Ptr, MWWorld::Ptr> CollisionMap;
             CollisionMap mStandingCollisions;
 
+            // The actors standing on each object, built from mStandingCollisions when first needed
+            typedef std::unordered_map<MWWorld::ConstPtr, std::vector<MWWorld::Ptr>, MWWorld::PtrHash> StandingActorsMap;
+            mutable StandingActorsMap mStandingActors;
+            mutable bool mStandingActorsDirty;
+
             // replaces all occurrences of 'old' in the map by 'updated', no matter if it's a key or value
             void updateCollisionMapPtr(CollisionMap& map, const MWWorld::Ptr &old, const MWWorld::Ptr &updated);
 
@@ -8,6 +8,7 @@
 #include "collisiontype.hpp"
 #include "actor.hpp"
 #include "convert.hpp"
+#include "convexsweep.hpp"
 
 namespace MWPhysics
 {
@@ -67,8 +68,7 @@ void ActorTracer::doTrace(const btCollisionObject *actor, const osg::Vec3f& star
 
     const btCollisionShape *shape = actor->getCollisionShape();
     assert(shape->isConvex());
-    world->convexSweepTest(static_cast<const btConvexShape*>(shape),
-                                               from, to, newTraceCallback);
+    convexSweepTest(world, static_cast<const btConvexShape*>(shape), from, to, newTraceCallback);
 
     // Copy the hit data over to our trace results struct:
     if(newTraceCallback.hasHit())
@@ -105,7 +105,7 @@ void ActorTracer::findGround(const Actor* actor, const osg::Vec3f& start, const
     newTraceCallback.m_collisionFilterMask = actor->getCollisionObject()->getBroadphaseHandle()->m_collisionFilterMask;
     newTraceCallback.m_collisionFilterMask &= ~CollisionType_Actor;
 
-    world->convexSweepTest(actor->getConvexShape(), from, to, newTraceCallback);
+    convexSweepTest(world, actor->getConvexShape(), from, to, newTraceCallback);
     if(newTraceCallback.hasHit())
     {
         const btVector3& tracehitnormal = newTraceCallback.m_hitNormalWorld;
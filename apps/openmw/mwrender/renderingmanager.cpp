@@ -229,7 +229,8 @@ namespace MWRender
 
         mObjects.reset(new Objects(mResourceSystem, sceneRoot, mUnrefQueue.get()));
 
-        if (getenv("OPENMW_DONT_PRECOMPILE") == NULL)
+        // Without a graphics context (headless benchmark runs) nothing would ever be compiled
+        if (getenv("OPENMW_DONT_PRECOMPILE") == NULL && mViewer->getCamera()->getGraphicsContext())
         {
             mViewer->setIncrementalCompileOperation(new osgUtil::IncrementalCompileOperation);
             mViewer->getIncrementalCompileOperation()->setTargetFrameRate(Settings::Manager::getFloat("target framerate", "Cells"));
@@ -845,6 +846,10 @@ namespace MWRender
 
     void RenderingManager::renderCameraToImage(osg::Camera *camera, osg::Image *image, int w, int h)
     {
+        // Headless benchmark runs have no graphics context, so the draw would never complete; leave the image empty
+        if (!mViewer->getCamera()->getGraphicsContext())
+            return;
+
         camera->setNodeMask(Mask_RenderToTexture);
         camera->attach(osg::Camera::COLOR_BUFFER, image);
         camera->setRenderOrder(osg::Camera::PRE_RENDER);
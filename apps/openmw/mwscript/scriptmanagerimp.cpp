@@ -79,7 +79,7 @@ namespace MWScript
             {
                 std::vector<Interpreter::Type_Code> code;
                 mParser.getCode (code);
-                mScripts.insert (std::make_pair (name, std::make_pair (code, mParser.getLocals())));
+                mScripts.insert (std::make_pair (name, std::make_pair (Interpreter::Program (code), mParser.getLocals())));
 
                 return true;
             }
@@ -98,8 +98,7 @@ namespace MWScript
             if (!compile (name))
             {
                 // failed -> ignore script from now on.
-                std::vector<Interpreter::Type_Code> empty;
-                mScripts.insert (std::make_pair (name, std::make_pair (empty, Compiler::Locals())));
+                mScripts.insert (std::make_pair (name, std::make_pair (Interpreter::Program(), Compiler::Locals())));
                 return;
             }
 
@@ -117,7 +116,7 @@ namespace MWScript
                     mOpcodesInstalled = true;
                 }
 
-                mInterpreter.run (&iter->second.first[0], iter->second.first.size(), interpreterContext);
+                mInterpreter.run (iter->second.first, interpreterContext);
             }
             catch (const std::exception& e)
             {
@@ -53,6 +53,10 @@ namespace MWState
             ///
             /// \attention The \a slot pointer will be invalidated by this call.
 
+            void setSlotScreenshot (const Slot *slot, const std::vector<char>& screenshot);
+            ///< Set the screenshot of \a slot, e.g. once it has been encoded after saving.
+            /// \note Slot must belong to this character.
+
             SlotIterator begin() const;
             ///<  Any call to createSlot and updateSlot can invalidate the returned iterator.
 
@@ -1,8 +1,11 @@
 #include "statemanagerimp.hpp"
 
+#include <algorithm>
+
 #include <components/esm/esmwriter.hpp>
 #include <components/esm/esmreader.hpp>
 #include <components/esm/cellid.hpp>
+#include <components/esm/compressedrecords.hpp>
 #include <components/esm/loadcell.hpp>
 
 #include <components/loadinglistener/loadinglistener.hpp>
@@ -16,6 +19,8 @@
 #include <boost/filesystem/fstream.hpp>
 #include <boost/filesystem/operations.hpp>
 
+#include <components/sceneutil/workqueue.hpp>
+
 #include "../mwbase/environment.hpp"
 #include "../mwbase/world.hpp"
 #include "../mwbase/journal.hpp"
@@ -39,6 +44,142 @@
 
 #include "quicksavemanager.hpp"
 
+namespace
+{
+    void encodeScreenshot(const osg::Image& screenshot, std::vector<char>& imageData)
+    {
+        // Nothing was rendered, e.g. in headless benchmark runs
+        if (!screenshot.data())
+            return;
+
+        osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("jpg");
+        if (!readerwriter)
+        {
+            std::cerr << "Error: Unable to write screenshot, can't find a jpg ReaderWriter" << std::endl;
+            return;
+        }
+
+        std::ostringstream ostream;
+        osgDB::ReaderWriter::WriteResult result = readerwriter->writeImage(screenshot, ostream);
+        if (!result.success())
+        {
+            std::cerr << "Error: Unable to write screenshot: " << result.message() << " code " << result.status() << std::endl;
+            return;
+        }
+
+        std::string data = ostream.str();
+        imageData = std::vector<char>(data.begin(), data.end());
+    }
+}
+
+namespace MWState
+{
+    /// Encodes the screenshot and writes an already serialized game to the save file, on the save thread
+    class WriteSaveGameItem : public SceneUtil::WorkItem
+    {
+    public:
+        WriteSaveGameItem(const ESM::SavedGame& profile, osg::ref_ptr<osg::Image> screenshot,
+                          const std::string& records, int recordCount, int compressionLevel,
+                          const boost::filesystem::path& path)
+            : mProfile(profile)
+            , mScreenshot(screenshot)
+            , mRecords(records)
+            , mRecordCount(recordCount)
+            , mCompressionLevel(compressionLevel)
+            , mPath(path)
+        {
+        }
+
+        virtual void doWork()
+        {
+            // Write to a temporary file first. If there is an exception during the save process, we don't want to trash the
+            // existing save file we are overwriting.
+            boost::filesystem::path tempPath (mPath.string() + ".tmp");
+
+            try
+            {
+                encodeScreenshot(*mScreenshot, mProfile.mScreenshot);
+
+                std::vector<ESM::CompressedRecords> blocks;
+                if (mCompressionLevel > 0)
+                    ESM::CompressedRecords::compress(mRecords, mCompressionLevel, blocks);
+
+                ESM::ESMWriter writer;
+
+                for (std::vector<std::string>::const_iterator iter (mProfile.mContentFiles.begin());
+                    iter!=mProfile.mContentFiles.end(); ++iter)
+                    writer.addMaster (*iter, 0); // not using the size information anyway -> use value of 0
+
+                writer.setFormat (ESM::SavedGame::sCurrentFormat);
+
+                // all unused
+                writer.setVersion(0);
+                writer.setType(0);
+                writer.setAuthor("");
+                writer.setDescription("");
+
+                // 1 extra for the saved game header
+                writer.setRecordCount (1 + (mCompressionLevel > 0 ? static_cast<int>(blocks.size()) : mRecordCount));
+
+                {
+                    boost::filesystem::ofstream filestream (tempPath, std::ios::binary);
+
+                    writer.save (filestream);
+
+                    writer.startRecord (ESM::REC_SAVE);
+                    mProfile.save (writer);
+                    writer.endRecord (ESM::REC_SAVE);
+
+                    if (mCompressionLevel > 0)
+                    {
+                        for (std::vector<ESM::CompressedRecords>::const_iterator it = blocks.begin(); it != blocks.end(); ++it)
+                        {
+                            writer.startRecord (ESM::CompressedRecords::sRecordId);
+                            it->save (writer);
+                            writer.endRecord (ESM::CompressedRecords::sRecordId);
+                        }
+                    }
+                    else
+                        writer.write (mRecords.data(), mRecords.size());
+
+                    writer.close();
+
+                    filestream.flush();
+                    if (filestream.fail())
+                        throw std::runtime_error("Write operation failed (file stream)");
+                }
+
+                // All good, replace the old file
+                boost::filesystem::rename (tempPath, mPath);
+            }
+            catch (const std::exception& e)
+            {
+                mError = e.what();
+
+                boost::system::error_code ec;
+                boost::filesystem::remove (tempPath, ec);
+            }
+
+            mRecords.clear();
+        }
+
+        /// Error message if writing failed, empty otherwise. Only valid once the item is done.
+        const std::string& getError() const { return mError; }
+
+        /// The encoded screenshot. Only valid once the item is done.
+        const std::vector<char>& getScreenshot() const { return mProfile.mScreenshot; }
+
+    private:
+        ESM::SavedGame mProfile;
+        osg::ref_ptr<osg::Image> mScreenshot;
+        std::string mRecords;
+        int mRecordCount;
+        int mCompressionLevel; // zlib level, 0 to write the records uncompressed
+        boost::filesystem::path mPath;
+        std::string mError;
+    };
+}
+
 void MWState::StateManager::cleanup (bool force)
 {
     if (mState!=State_NoGame || force)
@@ -87,10 +228,18 @@ std::map<int, int> MWState::StateManager::buildContentFileIndexMap (const ESM::E
 
 MWState::StateManager::StateManager (const boost::filesystem::path& saves, const std::string& game)
 : mQuitRequest (false), mAskLoadRecent(false), mState (State_NoGame), mCharacterManager (saves, game), mTimePlayed (0)
+, mSaveQueue (new SceneUtil::WorkQueue(1)), mPendingSaveCharacter (NULL), mPendingSaveSlot (NULL)
 {
 
 }
 
+MWState::StateManager::~StateManager()
+{
+    // Don't quit with a half-written save
+    if (mPendingSave)
+        mPendingSave->waitTillDone();
+}
+
 void MWState::StateManager::requestQuit()
 {
     mQuitRequest = true;
@@ -180,6 +329,9 @@ void MWState::StateManager::resumeGame()
 
 void MWState::StateManager::saveGame (const std::string& description, const Slot *slot)
 {
+    // Let the previous save finish first, it could be writing the same file
+    finishPendingSave (true);
+
     MWState::Character* character = getCurrentCharacter();
 
     try
@@ -219,7 +371,8 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         profile.mTimePlayed = mTimePlayed;
         profile.mDescription = description;
 
-        writeScreenshot(profile.mScreenshot);
+        // Only capture the screenshot here, it is encoded along with writing the file
+        osg::ref_ptr<osg::Image> screenshot = takeScreenshot();
 
         if (!slot)
             slot = character->createSlot (profile);
@@ -229,38 +382,20 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         // Make sure the animation state held by references is up to date before saving the game.
         MWBase::Environment::get().getMechanicsManager()->persistAnimationStates();
 
-        // Write to a memory stream first. If there is an exception during the save process, we don't want to trash the
-        // existing save file we are overwriting.
-        std::stringstream stream;
+        // Serialize the game state into memory. This has to happen on the main thread, as it reads the live
+        // game objects, but writing the file is left to the save thread.
+        std::ostringstream stream;
 
         ESM::ESMWriter writer;
+        writer.startRecords (stream);
 
-        const std::vector<std::string>& current =
-            MWBase::Environment::get().getWorld()->getContentFiles();
-
-        for (std::vector<std::string>::const_iterator iter (current.begin()); iter!=current.end();
-            ++iter)
-            writer.addMaster (*iter, 0); // not using the size information anyway -> use value of 0
-
-        writer.setFormat (ESM::SavedGame::sCurrentFormat);
-
-        // all unused
-        writer.setVersion(0);
-        writer.setType(0);
-        writer.setAuthor("");
-        writer.setDescription("");
-
-        int recordCount =         1 // saved game header
-                +MWBase::Environment::get().getJournal()->countSavedGameRecords()
+        int recordCount =         MWBase::Environment::get().getJournal()->countSavedGameRecords()
                 +MWBase::Environment::get().getWorld()->countSavedGameRecords()
                 +MWBase::Environment::get().getScriptManager()->getGlobalScripts().countSavedGameRecords()
                 +MWBase::Environment::get().getDialogueManager()->countSavedGameRecords()
                 +MWBase::Environment::get().getWindowManager()->countSavedGameRecords()
                 +MWBase::Environment::get().getMechanicsManager()->countSavedGameRecords()
                 +MWBase::Environment::get().getInputManager()->countSavedGameRecords();
-        writer.setRecordCount (recordCount);
-
-        writer.save (stream);
 
         Loading::Listener& listener = *MWBase::Environment::get().getWindowManager()->getLoadingScreen();
         // Using only Cells for progress information, since they typically have the largest records by far
@@ -269,10 +404,6 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
 
         Loading::ScopedLoad load(&listener);
 
-        writer.startRecord (ESM::REC_SAVE);
-        slot->mProfile.save (writer);
-        writer.endRecord (ESM::REC_SAVE);
-
         MWBase::Environment::get().getJournal()->write (writer, listener);
         MWBase::Environment::get().getDialogueManager()->write (writer, listener);
         MWBase::Environment::get().getWorld()->write (writer, listener);
@@ -282,41 +413,69 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         MWBase::Environment::get().getInputManager()->write(writer, listener);
 
         // Ensure we have written the number of records that was estimated
-        if (writer.getRecordCount() != recordCount+1) // 1 extra for TES3 record
-            std::cerr << "Warning: number of written savegame records does not match. Estimated: " << recordCount+1 << ", written: " << writer.getRecordCount() << std::endl;
+        if (writer.getRecordCount() != recordCount)
+            std::cerr << "Warning: number of written savegame records does not match. Estimated: " << recordCount << ", written: " << writer.getRecordCount() << std::endl;
 
         writer.close();
 
         if (stream.fail())
             throw std::runtime_error("Write operation failed (memory stream)");
 
-        // All good, write to file
-        boost::filesystem::ofstream filestream (slot->mPath, std::ios::binary);
-        filestream << stream.rdbuf();
+        int compressionLevel = std::max(0, std::min(9, Settings::Manager::getInt ("compression level", "Saves")));
 
-        if (filestream.fail())
-            throw std::runtime_error("Write operation failed (file stream)");
+        mPendingSave = new WriteSaveGameItem (slot->mProfile, screenshot, stream.str(), writer.getRecordCount(),
+                                              compressionLevel, slot->mPath);
+        mPendingSaveCharacter = character;
+        mPendingSaveSlot = slot;
+        mSaveQueue->addWorkItem (mPendingSave);
 
         Settings::Manager::setString ("character", "Saves",
             slot->mPath.parent_path().filename().string());
     }
     catch (const std::exception& e)
     {
-        std::stringstream error;
-        error << "Failed to save game: " << e.what();
+        reportSaveError (e.what(), character, slot);
+    }
+}
 
-        std::cerr << error.str() << std::endl;
+void MWState::StateManager::finishPendingSave (bool wait)
+{
+    if (!mPendingSave)
+        return;
 
-        std::vector<std::string> buttons;
-        buttons.push_back("#{sOk}");
-        MWBase::Environment::get().getWindowManager()->interactiveMessageBox(error.str(), buttons);
+    if (wait)
+        mPendingSave->waitTillDone();
+    else if (!mPendingSave->isDone())
+        return;
 
-        // If no file was written, clean up the slot
-        if (character && slot && !boost::filesystem::exists(slot->mPath))
-        {
-            character->deleteSlot(slot);
-            character->cleanup();
-        }
+    osg::ref_ptr<WriteSaveGameItem> item = mPendingSave;
+    mPendingSave = NULL;
+
+    if (!item->getError().empty())
+        reportSaveError (item->getError(), mPendingSaveCharacter, mPendingSaveSlot);
+    else
+        mPendingSaveCharacter->setSlotScreenshot (mPendingSaveSlot, item->getScreenshot());
+
+    mPendingSaveCharacter = NULL;
+    mPendingSaveSlot = NULL;
+}
+
+void MWState::StateManager::reportSaveError (const std::string& message, Character* character, const Slot* slot)
+{
+    std::stringstream error;
+    error << "Failed to save game: " << message;
+
+    std::cerr << error.str() << std::endl;
+
+    std::vector<std::string> buttons;
+    buttons.push_back("#{sOk}");
+    MWBase::Environment::get().getWindowManager()->interactiveMessageBox(error.str(), buttons);
+
+    // If no file was written, clean up the slot
+    if (character && slot && !boost::filesystem::exists(slot->mPath))
+    {
+        character->deleteSlot(slot);
+        character->cleanup();
     }
 }
 
@@ -352,6 +511,81 @@ void MWState::StateManager::quickSave (std::string name)
     saveGame(name, saveFinder.getNextQuickSaveSlot());
 }
 
+void MWState::StateManager::readRecord (ESM::ESMReader& reader, const ESM::NAME& name, const std::map<int, int>& contentFileMap,
+    bool& firstPersonCam)
+{
+    switch (name.intval)
+    {
+        case ESM::REC_JOUR:
+        case ESM::REC_JOUR_LEGACY:
+        case ESM::REC_QUES:
+
+            MWBase::Environment::get().getJournal()->readRecord (reader, name.intval);
+            break;
+
+        case ESM::REC_DIAS:
+
+            MWBase::Environment::get().getDialogueManager()->readRecord (reader, name.intval);
+            break;
+
+        case ESM::REC_ALCH:
+        case ESM::REC_ARMO:
+        case ESM::REC_BOOK:
+        case ESM::REC_CLAS:
+        case ESM::REC_CLOT:
+        case ESM::REC_ENCH:
+        case ESM::REC_NPC_:
+        case ESM::REC_SPEL:
+        case ESM::REC_WEAP:
+        case ESM::REC_GLOB:
+        case ESM::REC_PLAY:
+        case ESM::REC_CSTA:
+        case ESM::REC_WTHR:
+        case ESM::REC_DYNA:
+        case ESM::REC_ACTC:
+        case ESM::REC_PROJ:
+        case ESM::REC_MPRJ:
+        case ESM::REC_ENAB:
+        case ESM::REC_LEVC:
+        case ESM::REC_LEVI:
+            MWBase::Environment::get().getWorld()->readRecord(reader, name.intval, contentFileMap);
+            break;
+
+        case ESM::REC_CAM_:
+            reader.getHNT(firstPersonCam, "FIRS");
+            break;
+
+        case ESM::REC_GSCR:
+
+            MWBase::Environment::get().getScriptManager()->getGlobalScripts().readRecord (reader, name.intval);
+            break;
+
+        case ESM::REC_GMAP:
+        case ESM::REC_KEYS:
+        case ESM::REC_ASPL:
+        case ESM::REC_MARK:
+
+            MWBase::Environment::get().getWindowManager()->readRecord(reader, name.intval);
+            break;
+
+        case ESM::REC_DCOU:
+        case ESM::REC_STLN:
+
+            MWBase::Environment::get().getMechanicsManager()->readRecord(reader, name.intval);
+            break;
+
+        case ESM::REC_INPU:
+            MWBase::Environment::get().getInputManager()->readRecord(reader, name.intval);
+            break;
+
+        default:
+
+            // ignore invalid records
+            std::cerr << "Warning: Ignoring unknown record: " << name.toString() << std::endl;
+            reader.skipRecord();
+    }
+}
+
 void MWState::StateManager::loadGame(const std::string& filepath)
 {
     for (CharacterIterator it = mCharacterManager.begin(); it != mCharacterManager.end(); ++it)
@@ -374,6 +608,8 @@ void MWState::StateManager::loadGame(const std::string& filepath)
 
 void MWState::StateManager::loadGame (const Character *character, const std::string& filepath)
 {
+    finishPendingSave (true);
+
     try
     {
         cleanup();
@@ -418,73 +654,27 @@ void MWState::StateManager::loadGame (const Character *character, const std::str
                     }
                     break;
 
-                case ESM::REC_JOUR:
-                case ESM::REC_JOUR_LEGACY:
-                case ESM::REC_QUES:
-
-                    MWBase::Environment::get().getJournal()->readRecord (reader, n.intval);
-                    break;
-
-                case ESM::REC_DIAS:
-
-                    MWBase::Environment::get().getDialogueManager()->readRecord (reader, n.intval);
-                    break;
-
-                case ESM::REC_ALCH:
-                case ESM::REC_ARMO:
-                case ESM::REC_BOOK:
-                case ESM::REC_CLAS:
-                case ESM::REC_CLOT:
-                case ESM::REC_ENCH:
-                case ESM::REC_NPC_:
-                case ESM::REC_SPEL:
-                case ESM::REC_WEAP:
-                case ESM::REC_GLOB:
-                case ESM::REC_PLAY:
-                case ESM::REC_CSTA:
-                case ESM::REC_WTHR:
-                case ESM::REC_DYNA:
-                case ESM::REC_ACTC:
-                case ESM::REC_PROJ:
-                case ESM::REC_MPRJ:
-                case ESM::REC_ENAB:
-                case ESM::REC_LEVC:
-                case ESM::REC_LEVI:
-                    MWBase::Environment::get().getWorld()->readRecord(reader, n.intval, contentFileMap);
-                    break;
-
-                case ESM::REC_CAM_:
-                    reader.getHNT(firstPersonCam, "FIRS");
-                    break;
-
-                case ESM::REC_GSCR:
-
-                    MWBase::Environment::get().getScriptManager()->getGlobalScripts().readRecord (reader, n.intval);
-                    break;
-
-                case ESM::REC_GMAP:
-                case ESM::REC_KEYS:
-                case ESM::REC_ASPL:
-                case ESM::REC_MARK:
-
-                    MWBase::Environment::get().getWindowManager()->readRecord(reader, n.intval);
-                    break;
-
-                case ESM::REC_DCOU:
-                case ESM::REC_STLN:
+                case ESM::REC_ZBLK:
+                    {
+                        // Inflate one block at a time and read its records as if they were stored in the file
+                        ESM::CompressedRecords block;
+                        block.load(reader);
 
-                    MWBase::Environment::get().getMechanicsManager()->readRecord(reader, n.intval);
-                    break;
+                        ESM::ESMReader blockReader;
+                        blockReader.openBlock(Files::IStreamPtr(new std::istringstream(block.decompress())), reader);
 
-                case ESM::REC_INPU:
-                    MWBase::Environment::get().getInputManager()->readRecord(reader, n.intval);
+                        while (blockReader.hasMoreRecs())
+                        {
+                            ESM::NAME blockName = blockReader.getRecName();
+                            blockReader.getRecHeader();
+                            readRecord(blockReader, blockName, contentFileMap, firstPersonCam);
+                        }
+                    }
                     break;
 
                 default:
 
-                    // ignore invalid records
-                    std::cerr << "Warning: Ignoring unknown record: " << n.toString() << std::endl;
-                    reader.skipRecord();
+                    readRecord(reader, n, contentFileMap, firstPersonCam);
             }
             int progressPercent = static_cast<int>(float(reader.getFileOffset())/total*100);
             if (progressPercent > currentPercent)
@@ -572,6 +762,8 @@ void MWState::StateManager::quickLoad()
 
 void MWState::StateManager::deleteGame(const MWState::Character *character, const MWState::Slot *slot)
 {
+    finishPendingSave (true);
+
     mCharacterManager.deleteSlot(character, slot);
 }
 
@@ -594,6 +786,8 @@ void MWState::StateManager::update (float duration)
 {
     mTimePlayed += duration;
 
+    finishPendingSave (false);
+
     // Note: It would be nicer to trigger this from InputManager, i.e. the very beginning of the frame update.
     if (mAskLoadRecent)
     {
@@ -642,7 +836,7 @@ bool MWState::StateManager::verifyProfile(const ESM::SavedGame& profile) const
     return true;
 }
 
-void MWState::StateManager::writeScreenshot(std::vector<char> &imageData) const
+osg::ref_ptr<osg::Image> MWState::StateManager::takeScreenshot() const
 {
     int screenshotW = 259*2, screenshotH = 133*2; // *2 to get some nice antialiasing
 
@@ -650,22 +844,5 @@ void MWState::StateManager::writeScreenshot(std::vector<char> &imageData) const
 
     MWBase::Environment::get().getWorld()->screenshot(screenshot.get(), screenshotW, screenshotH);
 
-    osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("jpg");
-    if (!readerwriter)
-    {
-        std::cerr << "Error: Unable to write screenshot, can't find a jpg ReaderWriter" << std::endl;
-        return;
-    }
-
-    std::ostringstream ostream;
-    osgDB::ReaderWriter::WriteResult result = readerwriter->writeImage(*screenshot, ostream);
-    if (!result.success())
-    {
-        std::cerr << "Error: Unable to write screenshot: " << result.message() << " code " << result.status() << std::endl;
-        return;
-    }
-
-    std::string data = ostream.str();
-    imageData = std::vector<char>(data.begin(), data.end());
-
+    return screenshot;
 }
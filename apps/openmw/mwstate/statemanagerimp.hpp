@@ -3,14 +3,30 @@
 
 #include <map>
 
+#include <osg/ref_ptr>
+
 #include "../mwbase/statemanager.hpp"
 
 #include <boost/filesystem/path.hpp>
 
+#include <components/esm/esmcommon.hpp>
+
 #include "charactermanager.hpp"
 
+namespace osg
+{
+    class Image;
+}
+
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace MWState
 {
+    class WriteSaveGameItem;
+
     class StateManager : public MWBase::StateManager
     {
             bool mQuitRequest;
@@ -19,20 +35,38 @@ namespace MWState
             CharacterManager mCharacterManager;
             double mTimePlayed;
 
+            osg::ref_ptr<SceneUtil::WorkQueue> mSaveQueue;
+            osg::ref_ptr<WriteSaveGameItem> mPendingSave;
+            Character* mPendingSaveCharacter;
+            const Slot* mPendingSaveSlot;
+
         private:
 
             void cleanup (bool force = false);
 
             bool verifyProfile (const ESM::SavedGame& profile) const;
 
-            void writeScreenshot (std::vector<char>& imageData) const;
+            osg::ref_ptr<osg::Image> takeScreenshot() const;
+
+            void finishPendingSave (bool wait);
+            ///< Report the outcome of the save that is being written on the save thread, if it is done.
+            ///
+            /// \param wait Block until the save is written
+
+            void reportSaveError (const std::string& message, Character* character, const Slot* slot);
 
             std::map<int, int> buildContentFileIndexMap (const ESM::ESMReader& reader) const;
 
+            void readRecord (ESM::ESMReader& reader, const ESM::NAME& name, const std::map<int, int>& contentFileMap,
+                bool& firstPersonCam);
+            ///< Hand a saved game record over to the subsystem it belongs to.
+
         public:
 
             StateManager (const boost::filesystem::path& saves, const std::string& game);
 
+            virtual ~StateManager();
+
             virtual void requestQuit();
 
             virtual bool hasQuitRequest() const;
@@ -56,6 +90,8 @@ namespace MWState
             virtual void saveGame (const std::string& description, const Slot *slot = 0);
             ///< Write a saved game to \a slot or create a new slot if \a slot == 0.
             ///
+            /// The game state is serialized right away, but the file is written on a background thread.
+            ///
             /// \note Slot must belong to the current character.
 
             ///Saves a file, using supplied filename, overwritting if needed
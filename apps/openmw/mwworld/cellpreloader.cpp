@@ -225,7 +225,7 @@ namespace MWWorld
         mPreloadCells.clear();
     }
 
-    void CellPreloader::preload(CellStore *cell, double timestamp)
+    void CellPreloader::preload(CellStore *cell, double timestamp, bool urgent)
     {
         if (!mWorkQueue)
         {
@@ -243,6 +243,10 @@ namespace MWWorld
         {
             // already preloaded, nothing to do other than updating the timestamp
             found->second.mTimeStamp = timestamp;
+
+            // the cell is about to be inserted, so don't leave its preload waiting behind the others
+            if (urgent && found->second.mWorkItem && !found->second.mWorkItem->isDone())
+                mWorkQueue->moveToFront(found->second.mWorkItem.get());
             return;
         }
 
@@ -271,11 +275,18 @@ namespace MWWorld
         }
 
         osg::ref_ptr<PreloadItem> item (new PreloadItem(cell, mResourceSystem->getSceneManager(), mBulletShapeManager, mResourceSystem->getKeyframeManager(), mTerrain, mLandManager, mPreloadInstances));
-        mWorkQueue->addWorkItem(item);
+        mWorkQueue->addWorkItem(item, urgent);
 
         mPreloadCells[cell] = PreloadEntry(timestamp, item);
     }
 
+    void CellPreloader::waitForPreload(const CellStore *cell)
+    {
+        PreloadMap::iterator found = mPreloadCells.find(cell);
+        if (found != mPreloadCells.end() && found->second.mWorkItem)
+            found->second.mWorkItem->waitTillDone();
+    }
+
     void CellPreloader::notifyLoaded(CellStore *cell)
     {
         PreloadMap::iterator found = mPreloadCells.find(cell);
@@ -39,8 +39,12 @@ namespace MWWorld
         ~CellPreloader();
 
         /// Ask a background thread to preload rendering meshes and collision shapes for objects in this cell.
+        /// @param urgent Put the work in front of other queued preloads, for cells that are about to be inserted into the scene.
         /// @note The cell itself must be in State_Loaded or State_Preloaded.
-        void preload(MWWorld::CellStore* cell, double timestamp);
+        void preload(MWWorld::CellStore* cell, double timestamp, bool urgent=false);
+
+        /// Block until the background work for this cell has finished, if there is any.
+        void waitForPreload(const MWWorld::CellStore* cell);
 
         void notifyLoaded(MWWorld::CellStore* cell);
 
@@ -17,6 +17,7 @@ namespace MWWorld
 
     void CellRef::unsetRefNum()
     {
+        mChangedSinceSave = true;
         mCellRef.mRefNum.unset();
     }
 
@@ -29,6 +30,7 @@ namespace MWWorld
     */
     void CellRef::setRefNum(unsigned int index)
     {
+        mChangedSinceSave = true;
         mCellRef.mRefNum.mIndex = index;
     }
     /*
@@ -55,6 +57,7 @@ namespace MWWorld
     */
     void CellRef::setMpNum(unsigned int index)
     {
+        mChangedSinceSave = true;
         mCellRef.mMpNum = index;
     }
     /*
@@ -78,6 +81,7 @@ namespace MWWorld
     */
     void CellRef::setTeleport(bool teleportState)
     {
+        mChangedSinceSave = true;
         mCellRef.mTeleport = teleportState;
     }
     /*
@@ -96,6 +100,7 @@ namespace MWWorld
     */
     void CellRef::setDoorDest(const ESM::Position& position)
     {
+        mChangedSinceSave = true;
         mCellRef.mDoorDest = position;
     }
     /*
@@ -114,6 +119,7 @@ namespace MWWorld
     */
     void CellRef::setDestCell(const std::string& cellDescription)
     {
+        mChangedSinceSave = true;
         mCellRef.mDestCell = cellDescription;
     }
     /*
@@ -127,6 +133,7 @@ namespace MWWorld
 
     void CellRef::setScale(float scale)
     {
+        mChangedSinceSave = true;
         if (scale != mCellRef.mScale)
         {
             mChanged = true;
@@ -141,6 +148,7 @@ namespace MWWorld
 
     void CellRef::setPosition(const ESM::Position &position)
     {
+        mChangedSinceSave = true;
         mChanged = true;
         mCellRef.mPos = position;
     }
@@ -152,6 +160,7 @@ namespace MWWorld
 
     void CellRef::setEnchantmentCharge(float charge)
     {
+        mChangedSinceSave = true;
         if (charge != mCellRef.mEnchantmentCharge)
         {
             mChanged = true;
@@ -166,6 +175,7 @@ namespace MWWorld
 
     void CellRef::setCharge(int charge)
     {
+        mChangedSinceSave = true;
         if (charge != mCellRef.mChargeInt)
         {
             mChanged = true;
@@ -175,6 +185,7 @@ namespace MWWorld
 
     void CellRef::applyChargeRemainderToBeSubtracted(float chargeRemainder)
     {
+        mChangedSinceSave = true;
         mCellRef.mChargeIntRemainder += std::abs(chargeRemainder);
         if (mCellRef.mChargeIntRemainder > 1.0f)
         {
@@ -198,6 +209,7 @@ namespace MWWorld
 
     void CellRef::setChargeFloat(float charge)
     {
+        mChangedSinceSave = true;
         if (charge != mCellRef.mChargeFloat)
         {
             mChanged = true;
@@ -217,6 +229,7 @@ namespace MWWorld
 
     void CellRef::resetGlobalVariable()
     {
+        mChangedSinceSave = true;
         if (!mCellRef.mGlobalVariable.empty())
         {
             mChanged = true;
@@ -226,6 +239,7 @@ namespace MWWorld
 
     void CellRef::setFactionRank(int factionRank)
     {
+        mChangedSinceSave = true;
         if (factionRank != mCellRef.mFactionRank)
         {
             mChanged = true;
@@ -240,6 +254,7 @@ namespace MWWorld
 
     void CellRef::setOwner(const std::string &owner)
     {
+        mChangedSinceSave = true;
         if (owner != mCellRef.mOwner)
         {
             mChanged = true;
@@ -254,6 +269,7 @@ namespace MWWorld
 
     void CellRef::setSoul(const std::string &soul)
     {
+        mChangedSinceSave = true;
         if (soul != mCellRef.mSoul)
         {
             mChanged = true;
@@ -268,6 +284,7 @@ namespace MWWorld
 
     void CellRef::setFaction(const std::string &faction)
     {
+        mChangedSinceSave = true;
         if (faction != mCellRef.mFaction)
         {
             mChanged = true;
@@ -282,6 +299,7 @@ namespace MWWorld
 
     void CellRef::setLockLevel(int lockLevel)
     {
+        mChangedSinceSave = true;
         if (lockLevel != mCellRef.mLockLevel)
         {
             mChanged = true;
@@ -301,6 +319,7 @@ namespace MWWorld
 
     void CellRef::setTrap(const std::string& trap)
     {
+        mChangedSinceSave = true;
         if (trap != mCellRef.mTrap)
         {
             mChanged = true;
@@ -315,6 +334,7 @@ namespace MWWorld
 
     void CellRef::setGoldValue(int value)
     {
+        mChangedSinceSave = true;
         if (value != mCellRef.mGoldValue)
         {
             mChanged = true;
@@ -332,4 +352,14 @@ namespace MWWorld
         return mChanged;
     }
 
+    bool CellRef::hasChangedSinceSave() const
+    {
+        return mChangedSinceSave;
+    }
+
+    void CellRef::resetChangedSinceSave()
+    {
+        mChangedSinceSave = false;
+    }
+
 }
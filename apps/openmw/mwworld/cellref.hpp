@@ -20,6 +20,7 @@ namespace MWWorld
             : mCellRef(ref)
         {
             mChanged = false;
+            mChangedSinceSave = true;
         }
 
         // Note: Currently unused for items in containers
@@ -173,8 +174,15 @@ namespace MWWorld
         // Has this CellRef changed since it was originally loaded?
         bool hasChanged() const;
 
+        // Could this CellRef have changed since resetChangedSinceSave() was last called? Every setter counts as a change.
+        bool hasChangedSinceSave() const;
+
+        // Called once the state of this CellRef has been written to a saved game
+        void resetChangedSinceSave();
+
     private:
         bool mChanged;
+        bool mChangedSinceSave;
         ESM::CellRef mCellRef;
     };
 
@@ -1,7 +1,7 @@
 #ifndef GAME_MWWORLD_CELLREFLIST_H
 #define GAME_MWWORLD_CELLREFLIST_H
 
-#include <list>
+#include <components/misc/stablevector.hpp>
 
 #include "livecellref.hpp"
 
@@ -12,7 +12,9 @@ namespace MWWorld
     struct CellRefList
     {
         typedef LiveCellRef<X> LiveRef;
-        typedef std::list<LiveRef> List;
+        /// References are stored in chunks of contiguous memory for cache-friendly iteration. Their addresses stay
+        /// stable on insertion, so Ptrs to them remain valid like they would with a std::list.
+        typedef Misc::StableVector<LiveRef> List;
         List mList;
 
         /// Search for the given reference in the given reclist from
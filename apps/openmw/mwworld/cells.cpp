@@ -1,6 +1,8 @@
 #include "cells.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <sstream>
 
 #include <components/esm/esmreader.hpp>
 #include <components/esm/esmwriter.hpp>
@@ -53,6 +55,7 @@ void MWWorld::Cells::clear()
     mExteriors.clear();
     std::fill(mIdCache.begin(), mIdCache.end(), std::make_pair("", (MWWorld::CellStore*)0));
     mIdCacheIndex = 0;
+    mSavedCellsSize = 0;
 }
 
 MWWorld::Ptr MWWorld::Cells::getPtrAndCache (const std::string& name, CellStore& cellStore)
@@ -72,6 +75,14 @@ MWWorld::Ptr MWWorld::Cells::getPtrAndCache (const std::string& name, CellStore&
 
 void MWWorld::Cells::writeCell (ESM::ESMWriter& writer, CellStore& cell) const
 {
+    // Most cells with state haven't been touched since the last save, so write their
+    // record from that save again instead of serializing all of their references
+    if (!cell.getSavedState().empty() && !cell.hasChangedSinceSave())
+    {
+        writer.writeRawRecord (cell.getSavedState());
+        return;
+    }
+
     if (cell.getState()!=CellStore::State_Loaded)
         cell.load ();
 
@@ -79,18 +90,39 @@ void MWWorld::Cells::writeCell (ESM::ESMWriter& writer, CellStore& cell) const
 
     cell.saveState (cellState);
 
-    writer.startRecord (ESM::REC_CSTA);
-    cellState.mId.save (writer);
-    cellState.save (writer);
-    cell.writeFog(writer);
-    cell.writeReferences (writer);
-    writer.endRecord (ESM::REC_CSTA);
+    std::ostringstream stream;
+    ESM::ESMWriter cellWriter;
+    cellWriter.setEncoder (writer.getEncoder());
+    cellWriter.startRecords (stream);
+
+    cellWriter.startRecord (ESM::REC_CSTA);
+    cellState.mId.save (cellWriter);
+    cellState.save (cellWriter);
+    cell.writeFog(cellWriter);
+    cell.writeReferences (cellWriter);
+    cellWriter.endRecord (ESM::REC_CSTA);
+    cellWriter.close();
+
+    std::string record = stream.str();
+    writer.writeRawRecord (record);
+
+    // Keep the copies within their memory budget. A cell that doesn't fit is serialized again on every save.
+    mSavedCellsSize -= cell.getSavedState().size();
+    if (mSavedCellsSize + record.size() <= mSavedCellsLimit)
+    {
+        cell.setSavedState (record);
+        mSavedCellsSize += record.size();
+    }
+    else
+        cell.clearSavedState();
 }
 
 MWWorld::Cells::Cells (const MWWorld::ESMStore& store, std::vector<ESM::ESMReader>& reader)
 : mStore (store), mReader (reader),
   mIdCache (Settings::Manager::getInt("pointers cache size", "Cells"), std::pair<std::string, CellStore *> ("", (CellStore*)0)),
-  mIdCacheIndex (0)
+  mIdCacheIndex (0),
+  mSavedCellsSize (0),
+  mSavedCellsLimit (static_cast<std::size_t>(std::max(0, Settings::Manager::getInt("unchanged cells cache size", "Saves"))) * 1024 * 1024)
 {}
 
 MWWorld::CellStore *MWWorld::Cells::getExterior (int x, int y)
@@ -33,6 +33,9 @@ namespace MWWorld
             mutable std::map<std::pair<int, int>, CellStore> mExteriors;
             std::vector<std::pair<std::string, CellStore *> > mIdCache;
             std::size_t mIdCacheIndex;
+            // Memory used by the saved state records that cells keep for the next save, and its limit in bytes
+            mutable std::size_t mSavedCellsSize;
+            std::size_t mSavedCellsLimit;
 
             Cells (const Cells&);
             Cells& operator= (const Cells&);
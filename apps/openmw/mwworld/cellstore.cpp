@@ -163,6 +163,41 @@ namespace
         collection.mList.push_back (ref);
     }
 
+    struct HasChangedSinceSaveVisitor
+    {
+        bool mChanged;
+
+        HasChangedSinceSaveVisitor()
+            : mChanged(false)
+        {
+        }
+
+        template<typename T>
+        void operator() (const MWWorld::CellRefList<T>& collection)
+        {
+            for (typename MWWorld::CellRefList<T>::List::const_iterator iter (collection.mList.begin());
+                 !mChanged && iter != collection.mList.end(); ++iter)
+            {
+                if (iter->mData.hasChangedSinceSave() || iter->mRef.hasChangedSinceSave())
+                    mChanged = true;
+            }
+        }
+    };
+
+    struct ResetChangedSinceSaveVisitor
+    {
+        template<typename T>
+        void operator() (MWWorld::CellRefList<T>& collection)
+        {
+            for (typename MWWorld::CellRefList<T>::List::iterator iter (collection.mList.begin());
+                 iter != collection.mList.end(); ++iter)
+            {
+                iter->mData.resetChangedSinceSave();
+                iter->mRef.resetChangedSinceSave();
+            }
+        }
+    };
+
     struct SearchByRefNumVisitor
     {
         MWWorld::LiveCellRefBase* mFound;
@@ -196,7 +231,7 @@ namespace MWWorld
 
         if (const X *ptr = store.search (ref.mRefID))
         {
-            typename std::list<LiveRef>::iterator iter =
+            typename List::iterator iter =
                 std::find(mList.begin(), mList.end(), ref.mRefNum);
 
             LiveRef liveCellRef (ref, ptr);
@@ -236,6 +271,7 @@ namespace MWWorld
             load();
 
         mHasState = true;
+        mChangedSinceSave = true;
         MovedRefTracker::iterator found = mMovedToAnotherCell.find(object.getBase());
         if (found != mMovedToAnotherCell.end())
         {
@@ -386,6 +422,18 @@ namespace MWWorld
         forEachInternal(visitor);
         visitor.merge();
 
+        mRefIdIndexDirty = true;
+
+        /*
+            Start of tes3mp addition
+
+            The unique index lookup table no longer matches mMergedRefs
+        */
+        mUniqueIndexDirty = true;
+        /*
+            End of tes3mp addition
+        */
+
         /*
             Start of tes3mp addition
 
@@ -405,7 +453,14 @@ namespace MWWorld
     }
 
     CellStore::CellStore (const ESM::Cell *cell, const MWWorld::ESMStore& esmStore, std::vector<ESM::ESMReader>& readerList)
-        : mStore(esmStore), mReader(readerList), mCell (cell), mState (State_Unloaded), mHasState (false), mLastRespawn(0,0)
+        : mStore(esmStore), mReader(readerList), mCell (cell), mState (State_Unloaded), mHasState (false), mChangedSinceSave (true), mLastRespawn(0,0), mRefIdIndexDirty(true)
+        /*
+            Start of tes3mp addition
+        */
+        , mUniqueIndexDirty(true)
+        /*
+            End of tes3mp addition
+        */
     {
         mWaterLevel = cell->mWater;
     }
@@ -430,6 +485,41 @@ namespace MWWorld
         return mHasState;
     }
 
+    bool CellStore::hasChangedSinceSave() const
+    {
+        if (mChangedSinceSave)
+            return true;
+
+        // References can also be changed through Ptrs that were looked up before the last save
+        HasChangedSinceSaveVisitor visitor;
+        forEachRefList (*this, visitor);
+        return visitor.mChanged;
+    }
+
+    void CellStore::markAsChanged()
+    {
+        mChangedSinceSave = true;
+    }
+
+    void CellStore::setSavedState (const std::string& record)
+    {
+        mSavedState = record;
+        mChangedSinceSave = false;
+
+        ResetChangedSinceSaveVisitor visitor;
+        forEachRefList (*this, visitor);
+    }
+
+    void CellStore::clearSavedState()
+    {
+        std::string().swap (mSavedState);
+    }
+
+    const std::string& CellStore::getSavedState() const
+    {
+        return mSavedState;
+    }
+
     bool CellStore::hasId (const std::string& id) const
     {
         if (mState==State_Unloaded)
@@ -441,36 +531,47 @@ namespace MWWorld
         return searchConst (id).isEmpty();
     }
 
-    template <typename PtrType>
-    struct SearchVisitor
+    void CellStore::updateRefIdIndex() const
     {
-        PtrType mFound;
-        std::string mIdToFind;
-        bool operator()(const PtrType& ptr)
-        {
-            if (ptr.getCellRef().getRefId() == mIdToFind)
-            {
-                mFound = ptr;
-                return false;
-            }
-            return true;
-        }
-    };
+        mRefIdIndex.clear();
+        mRefIdIndex.reserve(mMergedRefs.size());
+
+        // Keep the order of mMergedRefs so that duplicate IDs resolve to the same object as a full scan would
+        for (std::vector<LiveCellRefBase*>::const_iterator it = mMergedRefs.begin(); it != mMergedRefs.end(); ++it)
+            mRefIdIndex.insert((*it)->mRef.getRefId(), *it);
+
+        mRefIdIndexDirty = false;
+    }
+
+    LiveCellRefBase* CellStore::searchRefIdIndex(const std::string& id) const
+    {
+        if (mRefIdIndexDirty)
+            updateRefIdIndex();
+
+        return mRefIdIndex.findFirst(id, [] (const LiveCellRefBase* ref) { return isAccessible(ref->mData, ref->mRef); });
+    }
 
     Ptr CellStore::search (const std::string& id)
     {
-        SearchVisitor<MWWorld::Ptr> searchVisitor;
-        searchVisitor.mIdToFind = id;
-        forEach(searchVisitor);
-        return searchVisitor.mFound;
+        if (mState != State_Loaded || mMergedRefs.empty())
+            return Ptr();
+
+        mHasState = true;
+        mChangedSinceSave = true;
+
+        if (LiveCellRefBase* ref = searchRefIdIndex(id))
+            return Ptr(ref, this);
+        return Ptr();
     }
 
     ConstPtr CellStore::searchConst (const std::string& id) const
     {
-        SearchVisitor<MWWorld::ConstPtr> searchVisitor;
-        searchVisitor.mIdToFind = id;
-        forEachConst(searchVisitor);
-        return searchVisitor.mFound;
+        if (mState != State_Loaded)
+            return ConstPtr();
+
+        if (const LiveCellRefBase* ref = searchRefIdIndex(id))
+            return ConstPtr(ref, this);
+        return ConstPtr();
     }
 
     Ptr CellStore::searchViaActorId (int id)
@@ -496,25 +597,29 @@ namespace MWWorld
     /*
         Start of tes3mp addition
 
-        A custom type of search visitor used to find objects by their reference numbers
+        Rebuild the lookup table used to find objects by their reference numbers
     */
-    template <typename PtrType>
-    struct SearchExactVisitor
+    void CellStore::updateUniqueIndex()
     {
-        PtrType mFound;
-        unsigned int mRefNumToFind;
-        unsigned int mMpNumToFind;
+        mUniqueIndex.clear();
+        mUniqueIndexEntries.clear();
+        mUniqueIndex.reserve(mMergedRefs.size());
+        mUniqueIndexEntries.reserve(mMergedRefs.size());
 
-        bool operator()(const PtrType& ptr)
+        for (size_t i = 0; i < mMergedRefs.size(); ++i)
         {
-            if (ptr.getCellRef().getRefNum().mIndex == mRefNumToFind && ptr.getCellRef().getMpNum() == mMpNumToFind)
-            {
-                mFound = ptr;
-                return false;
-            }
-            return true;
+            const CellRef& cellRef = mMergedRefs[i]->mRef;
+
+            UniqueIndexEntry entry;
+            entry.mKey = getUniqueIndexKey(cellRef.getRefNum().mIndex, cellRef.getMpNum());
+            entry.mMergedIndex = i;
+
+            mUniqueIndex[entry.mKey].push_back(mMergedRefs[i]);
+            mUniqueIndexEntries[mMergedRefs[i]] = entry;
         }
-    };
+
+        mUniqueIndexDirty = false;
+    }
     /*
         End of tes3mp addition
     */
@@ -530,11 +635,65 @@ namespace MWWorld
         if (refNum == 0 && mpNum == 0)
             return 0;
 
-        SearchExactVisitor<MWWorld::Ptr> searchVisitor;
-        searchVisitor.mRefNumToFind = refNum;
-        searchVisitor.mMpNumToFind = mpNum;
-        forEach(searchVisitor);
-        return searchVisitor.mFound;
+        if (mState != State_Loaded)
+            return Ptr();
+
+        mHasState = true;
+        mChangedSinceSave = true;
+
+        if (mUniqueIndexDirty)
+            updateUniqueIndex();
+
+        UniqueIndexMap::const_iterator found = mUniqueIndex.find(getUniqueIndexKey(refNum, mpNum));
+        if (found == mUniqueIndex.end())
+            return Ptr();
+
+        for (std::vector<LiveCellRefBase*>::const_iterator it = found->second.begin(); it != found->second.end(); ++it)
+        {
+            if (isAccessible((*it)->mData, (*it)->mRef))
+                return Ptr(*it, this);
+        }
+
+        return Ptr();
+    }
+
+    void CellStore::updateUniqueIndex(const Ptr& ptr)
+    {
+        assert(ptr.getCell() == this);
+
+        // A full rebuild is already pending and will pick up the new key
+        if (mUniqueIndexDirty)
+            return;
+
+        UniqueIndexEntryMap::iterator entry = mUniqueIndexEntries.find(ptr.getBase());
+        if (entry == mUniqueIndexEntries.end())
+        {
+            mUniqueIndexDirty = true;
+            return;
+        }
+
+        const CellRef& cellRef = ptr.getCellRef();
+        const unsigned long long key = getUniqueIndexKey(cellRef.getRefNum().mIndex, cellRef.getMpNum());
+        if (key == entry->second.mKey)
+            return;
+
+        UniqueIndexMap::iterator oldRefs = mUniqueIndex.find(entry->second.mKey);
+        if (oldRefs != mUniqueIndex.end())
+        {
+            oldRefs->second.erase(std::remove(oldRefs->second.begin(), oldRefs->second.end(), ptr.getBase()),
+                oldRefs->second.end());
+            if (oldRefs->second.empty())
+                mUniqueIndex.erase(oldRefs);
+        }
+
+        // Insert before the first ref that comes later in mMergedRefs, to keep duplicates in scan order
+        std::vector<LiveCellRefBase*>& newRefs = mUniqueIndex[key];
+        std::vector<LiveCellRefBase*>::iterator position = newRefs.begin();
+        while (position != newRefs.end() && mUniqueIndexEntries[*position].mMergedIndex < entry->second.mMergedIndex)
+            ++position;
+        newRefs.insert(position, ptr.getBase());
+
+        entry->second.mKey = key;
     }
     /*
         End of tes3mp addition
@@ -616,6 +775,7 @@ namespace MWWorld
     {
         mWaterLevel = level;
         mHasState = true;
+        mChangedSinceSave = true;
     }
 
     int CellStore::count() const
@@ -767,6 +927,7 @@ namespace MWWorld
         bool oldState = mHasState;
 
         mHasState = true;
+        mChangedSinceSave = true;
 
         if (Ptr ptr = searchInContainerList (mContainers, id))
             return ptr;
@@ -861,6 +1022,7 @@ namespace MWWorld
     void CellStore::loadState (const ESM::CellState& state)
     {
         mHasState = true;
+        mChangedSinceSave = true;
 
         if (mCell->mData.mFlags & ESM::Cell::Interior && mCell->mData.mFlags & ESM::Cell::HasWater)
             mWaterLevel = state.mWaterLevel;
@@ -931,6 +1093,7 @@ namespace MWWorld
     void CellStore::readReferences (ESM::ESMReader& reader, const std::map<int, int>& contentFileMap, GetCellStoreCallback* callback)
     {
         mHasState = true;
+        mChangedSinceSave = true;
 
         while (reader.isNextSub ("OBJE"))
         {
@@ -1122,6 +1285,7 @@ namespace MWWorld
     void CellStore::setFog(ESM::FogState *fog)
     {
         mFogState.reset(fog);
+        mChangedSinceSave = true;
     }
 
     ESM::FogState* CellStore::getFog() const
@@ -1146,6 +1310,8 @@ namespace MWWorld
     {
         if (mState == State_Loaded)
         {
+            mChangedSinceSave = true;
+
             static const int iMonthsToRespawn = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("iMonthsToRespawn")->getInt();
             if (MWBase::Environment::get().getWorld()->getTimeStamp() - mLastRespawn > 24*30*iMonthsToRespawn)
             {
@@ -6,10 +6,12 @@
 #include <string>
 #include <typeinfo>
 #include <map>
+#include <unordered_map>
 #include <memory>
 
 #include "livecellref.hpp"
 #include "cellreflist.hpp"
+#include "refindex.hpp"
 
 #include <components/esm/loadacti.hpp>
 #include <components/esm/loadalch.hpp>
@@ -70,6 +72,8 @@ namespace MWWorld
             const ESM::Cell *mCell;
             State mState;
             bool mHasState;
+            bool mChangedSinceSave;
+            std::string mSavedState;
             std::vector<std::string> mIds;
             float mWaterLevel;
 
@@ -109,6 +113,48 @@ namespace MWWorld
             // Merged list of ref's currently in this cell - i.e. with added refs from mMovedHere, removed refs from mMovedToAnotherCell
             std::vector<LiveCellRefBase*> mMergedRefs;
 
+            // Lookup table from refId to the refs in mMergedRefs, in mMergedRefs order. Used by search() and searchConst().
+            // Rebuilt on the next search after mMergedRefs changes.
+            typedef RefIndex<std::string, LiveCellRefBase*> RefIdIndex;
+            mutable RefIdIndex mRefIdIndex;
+            mutable bool mRefIdIndexDirty;
+
+            void updateRefIdIndex() const;
+
+            /// Find the first accessible reference with the given refId.
+            LiveCellRefBase* searchRefIdIndex(const std::string& id) const;
+
+            /*
+                Start of tes3mp addition
+
+                Lookup table from (refNum, mpNum) to the refs in mMergedRefs, used by searchExact(). Refs sharing a
+                key are kept in mMergedRefs order, so the first accessible one is the one a full scan would find.
+
+                The table is rebuilt on the next search after mMergedRefs changes. A ref that gets a new refNum or
+                mpNum while in this cell is moved to its new key by updateUniqueIndex(const Ptr&). That call can be
+                skipped right after insert(), which already schedules a rebuild
+            */
+            struct UniqueIndexEntry
+            {
+                unsigned long long mKey;
+                size_t mMergedIndex;
+            };
+            typedef std::unordered_map<unsigned long long, std::vector<LiveCellRefBase*> > UniqueIndexMap;
+            typedef std::unordered_map<const LiveCellRefBase*, UniqueIndexEntry> UniqueIndexEntryMap;
+            UniqueIndexMap mUniqueIndex;
+            UniqueIndexEntryMap mUniqueIndexEntries;
+            bool mUniqueIndexDirty;
+
+            static unsigned long long getUniqueIndexKey(unsigned int refNum, unsigned int mpNum)
+            {
+                return (static_cast<unsigned long long>(refNum) << 32) | mpNum;
+            }
+
+            void updateUniqueIndex();
+            /*
+                End of tes3mp addition
+            */
+
             // Get the Ptr for the given ref which originated from this cell (possibly moved to another cell at this point).
             Ptr getCurrentPtr(MWWorld::LiveCellRefBase* ref);
 
@@ -161,6 +207,34 @@ namespace MWWorld
                     forEachImp (visitor, mCreatureLists);
             }
 
+            // Call function for every reference list owned by this cell, including deleted references and references
+            // that have been moved to another cell. Store is either CellStore or const CellStore.
+            template<class Function, class Store>
+            static void forEachRefList (Store& store, Function& function)
+            {
+                function (store.mActivators);
+                function (store.mPotions);
+                function (store.mAppas);
+                function (store.mArmors);
+                function (store.mBooks);
+                function (store.mClothes);
+                function (store.mContainers);
+                function (store.mDoors);
+                function (store.mIngreds);
+                function (store.mItemLists);
+                function (store.mLights);
+                function (store.mLockpicks);
+                function (store.mMiscItems);
+                function (store.mProbes);
+                function (store.mRepairs);
+                function (store.mStatics);
+                function (store.mWeapons);
+                function (store.mBodyParts);
+                function (store.mCreatures);
+                function (store.mNpcs);
+                function (store.mCreatureLists);
+            }
+
             /// @note If you get a linker error here, this means the given type can not be stored in a cell. The supported types are
             /// defined at the bottom of this file.
             template <class T>
@@ -190,6 +264,7 @@ namespace MWWorld
             LiveCellRefBase* insert(const LiveCellRef<T>* ref)
             {
                 mHasState = true;
+                mChangedSinceSave = true;
                 CellRefList<T>& list = get<T>();
                 LiveCellRefBase* ret = &list.insert(*ref);
                 updateMergedRefs();
@@ -211,6 +286,23 @@ namespace MWWorld
             bool hasState() const;
             ///< Does this cell have state that needs to be stored in a saved game file?
 
+            bool hasChangedSinceSave() const;
+            ///< Could the state of this cell have changed since setSavedState() was last called?
+            /// \note This is conservative: any non-const access to the references of the cell counts as a change, and
+            /// so does any change to the RefData or CellRef of one of its references, even through a Ptr held elsewhere.
+
+            void markAsChanged();
+
+            void setSavedState (const std::string& record);
+            ///< Remember the serialized state record of this cell, so the next save can reuse it
+            /// if the cell hasn't changed in the meantime.
+
+            void clearSavedState();
+            ///< Forget the serialized state record, so the next save serializes the cell again.
+
+            const std::string& getSavedState() const;
+            ///< Serialized state record from the last save, empty if there is none.
+
             bool hasId (const std::string& id) const;
             ///< May return true for deleted IDs when in preload state. Will return false, if cell is
             /// unloaded.
@@ -235,6 +327,10 @@ namespace MWWorld
                 Allow the searching of objects by their reference numbers
             */
             Ptr searchExact (unsigned int refNum, unsigned int mpNum);
+
+            /// Update the lookup table used by searchExact() after the refNum or mpNum of \a ptr, which must be
+            /// in this cell, has been reassigned.
+            void updateUniqueIndex (const Ptr& ptr);
             /*
                 End of tes3mp addition
             */
@@ -323,6 +419,7 @@ namespace MWWorld
                     return true;
 
                 mHasState = true;
+                mChangedSinceSave = true;
 
                 for (unsigned int i=0; i<mMergedRefs.size(); ++i)
                 {
@@ -373,6 +470,7 @@ namespace MWWorld
                     return true;
 
                 mHasState = true;
+                mChangedSinceSave = true;
 
                 CellRefList<T>& list = get<T>();
 
@@ -452,6 +550,7 @@ namespace MWWorld
     inline CellRefList<ESM::Activator>& CellStore::get<ESM::Activator>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mActivators;
     }
 
@@ -459,6 +558,7 @@ namespace MWWorld
     inline CellRefList<ESM::Potion>& CellStore::get<ESM::Potion>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mPotions;
     }
 
@@ -466,6 +566,7 @@ namespace MWWorld
     inline CellRefList<ESM::Apparatus>& CellStore::get<ESM::Apparatus>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mAppas;
     }
 
@@ -473,6 +574,7 @@ namespace MWWorld
     inline CellRefList<ESM::Armor>& CellStore::get<ESM::Armor>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mArmors;
     }
 
@@ -480,6 +582,7 @@ namespace MWWorld
     inline CellRefList<ESM::Book>& CellStore::get<ESM::Book>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mBooks;
     }
 
@@ -487,6 +590,7 @@ namespace MWWorld
     inline CellRefList<ESM::Clothing>& CellStore::get<ESM::Clothing>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mClothes;
     }
 
@@ -494,6 +598,7 @@ namespace MWWorld
     inline CellRefList<ESM::Container>& CellStore::get<ESM::Container>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mContainers;
     }
 
@@ -501,6 +606,7 @@ namespace MWWorld
     inline CellRefList<ESM::Creature>& CellStore::get<ESM::Creature>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mCreatures;
     }
 
@@ -508,6 +614,7 @@ namespace MWWorld
     inline CellRefList<ESM::Door>& CellStore::get<ESM::Door>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mDoors;
     }
 
@@ -515,6 +622,7 @@ namespace MWWorld
     inline CellRefList<ESM::Ingredient>& CellStore::get<ESM::Ingredient>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mIngreds;
     }
 
@@ -522,6 +630,7 @@ namespace MWWorld
     inline CellRefList<ESM::CreatureLevList>& CellStore::get<ESM::CreatureLevList>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mCreatureLists;
     }
 
@@ -529,6 +638,7 @@ namespace MWWorld
     inline CellRefList<ESM::ItemLevList>& CellStore::get<ESM::ItemLevList>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mItemLists;
     }
 
@@ -536,6 +646,7 @@ namespace MWWorld
     inline CellRefList<ESM::Light>& CellStore::get<ESM::Light>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mLights;
     }
 
@@ -543,6 +654,7 @@ namespace MWWorld
     inline CellRefList<ESM::Lockpick>& CellStore::get<ESM::Lockpick>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mLockpicks;
     }
 
@@ -550,6 +662,7 @@ namespace MWWorld
     inline CellRefList<ESM::Miscellaneous>& CellStore::get<ESM::Miscellaneous>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mMiscItems;
     }
 
@@ -557,6 +670,7 @@ namespace MWWorld
     inline CellRefList<ESM::NPC>& CellStore::get<ESM::NPC>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mNpcs;
     }
 
@@ -564,6 +678,7 @@ namespace MWWorld
     inline CellRefList<ESM::Probe>& CellStore::get<ESM::Probe>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mProbes;
     }
 
@@ -571,6 +686,7 @@ namespace MWWorld
     inline CellRefList<ESM::Repair>& CellStore::get<ESM::Repair>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mRepairs;
     }
 
@@ -578,6 +694,7 @@ namespace MWWorld
     inline CellRefList<ESM::Static>& CellStore::get<ESM::Static>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mStatics;
     }
 
@@ -585,6 +702,7 @@ namespace MWWorld
     inline CellRefList<ESM::Weapon>& CellStore::get<ESM::Weapon>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mWeapons;
     }
 
@@ -592,6 +710,7 @@ namespace MWWorld
     inline CellRefList<ESM::BodyPart>& CellStore::get<ESM::BodyPart>()
     {
         mHasState = true;
+        mChangedSinceSave = true;
         return mBodyParts;
     }
 
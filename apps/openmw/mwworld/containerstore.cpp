@@ -20,6 +20,7 @@
 
 #include "../mwbase/environment.hpp"
 #include "../mwbase/world.hpp"
+#include "../mwbase/dialoguemanager.hpp"
 
 #include "../mwmechanics/creaturestats.hpp"
 #include "../mwmechanics/levelledlist.hpp"
@@ -385,6 +386,9 @@ MWWorld::ContainerStoreIterator MWWorld::ContainerStore::add (const Ptr& itemPtr
             item.getRefData().getLocals().setVarByInt(script, "onpcadd", 1);
     }
 
+    if (this == &player.getClass().getContainerStore(player))
+        MWBase::Environment::get().getDialogueManager()->notifyItemCountChanged(item.getCellRef().getRefId());
+
     /*
         Start of tes3mp change (major)
 
@@ -522,6 +526,9 @@ int MWWorld::ContainerStore::remove(const Ptr& item, int count, const Ptr& actor
 
     flagAsModified();
 
+    if (this == &player.getClass().getContainerStore(player))
+        MWBase::Environment::get().getDialogueManager()->notifyItemCountChanged(item.getCellRef().getRefId());
+
     /*
         Start of tes3mp change (major)
 
@@ -688,8 +695,16 @@ void MWWorld::ContainerStore::restock (const ESM::InventoryList& items, const MW
 
 void MWWorld::ContainerStore::clear()
 {
+    Ptr player = MWBase::Environment::get().getWorld()->getPlayerPtr();
+    bool isPlayerStore = this == &player.getClass().getContainerStore(player);
+
     for (ContainerStoreIterator iter (begin()); iter!=end(); ++iter)
+    {
+        if (isPlayerStore && iter->getRefData().getCount() != 0)
+            MWBase::Environment::get().getDialogueManager()->notifyItemCountChanged(iter->getCellRef().getRefId());
+
         iter->getRefData().setCount (0);
+    }
 
     flagAsModified();
 }
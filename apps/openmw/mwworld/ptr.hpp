@@ -3,6 +3,7 @@
 
 #include <cassert>
 
+#include <functional>
 #include <string>
 #include <sstream>
 
@@ -228,6 +229,20 @@ namespace MWWorld
     {
         return !(left>right);
     }
+
+    /// \brief Hash of the reference a Ptr or ConstPtr points to, consistent with operator==
+    struct PtrHash
+    {
+        size_t operator() (const Ptr& ptr) const
+        {
+            return std::hash<const void *>() (ptr.mRef);
+        }
+
+        size_t operator() (const ConstPtr& ptr) const
+        {
+            return std::hash<const void *>() (ptr.mRef);
+        }
+    };
 }
 
 #endif
@@ -29,6 +29,7 @@ namespace MWWorld
         mCount = refData.mCount;
         mPosition = refData.mPosition;
         mChanged = refData.mChanged;
+        mChangedSinceSave = true;
         mDeletedByContentFile = refData.mDeletedByContentFile;
         mFlags = refData.mFlags;
 
@@ -46,7 +47,7 @@ namespace MWWorld
     }
 
     RefData::RefData()
-    : mBaseNode(0), mDeletedByContentFile(false), mEnabled (true), mCount (1), mCustomData (0), mChanged(false), mFlags(0)
+    : mBaseNode(0), mDeletedByContentFile(false), mEnabled (true), mCount (1), mCustomData (0), mChanged(false), mChangedSinceSave(true), mFlags(0)
     {
         for (int i=0; i<3; ++i)
         {
@@ -59,7 +60,7 @@ namespace MWWorld
     : mBaseNode(0), mDeletedByContentFile(false), mEnabled (true),
       mCount (1), mPosition (cellRef.mPos),
       mCustomData (0),
-      mChanged(false), mFlags(0) // Loading from ESM/ESP files -> assume unchanged
+      mChanged(false), mChangedSinceSave(true), mFlags(0) // Loading from ESM/ESP files -> assume unchanged
     {
     }
 
@@ -70,7 +71,7 @@ namespace MWWorld
       mPosition (objectState.mPosition),
       mAnimationState(objectState.mAnimationState),
       mCustomData (0),
-      mChanged(true), mFlags(objectState.mFlags) // Loading from a savegame -> assume changed
+      mChanged(true), mChangedSinceSave(true), mFlags(objectState.mFlags) // Loading from a savegame -> assume changed
     {
         // "Note that the ActivationFlag_UseEnabled is saved to the reference,
         // which will result in permanently suppressed activation if the reference script is removed.
@@ -153,12 +154,14 @@ namespace MWWorld
 
     void RefData::setLocals (const ESM::Script& script)
     {
+        mChangedSinceSave = true;
         if (mLocals.configure (script) && !mLocals.isEmpty())
             mChanged = true;
     }
 
     void RefData::setCount (int count)
     {
+        mChangedSinceSave = true;
         if(count == 0)
             MWBase::Environment::get().getWorld()->removeRefScript(this);
 
@@ -169,6 +172,7 @@ namespace MWWorld
 
     void RefData::setDeletedByContentFile(bool deleted)
     {
+        mChangedSinceSave = true;
         mDeletedByContentFile = deleted;
     }
 
@@ -184,6 +188,8 @@ namespace MWWorld
 
     MWScript::Locals& RefData::getLocals()
     {
+        // The caller may modify the returned data
+        mChangedSinceSave = true;
         return mLocals;
     }
 
@@ -194,6 +200,7 @@ namespace MWWorld
 
     void RefData::enable()
     {
+        mChangedSinceSave = true;
         if (!mEnabled)
         {
             mChanged = true;
@@ -203,6 +210,7 @@ namespace MWWorld
 
     void RefData::disable()
     {
+        mChangedSinceSave = true;
         if (mEnabled)
         {
             mChanged = true;
@@ -212,6 +220,7 @@ namespace MWWorld
 
     void RefData::setPosition(const ESM::Position& pos)
     {
+        mChangedSinceSave = true;
         mChanged = true;
         mPosition = pos;
     }
@@ -223,6 +232,7 @@ namespace MWWorld
 
     void RefData::setCustomData (CustomData *data)
     {
+        mChangedSinceSave = true;
         mChanged = true; // We do not currently track CustomData, so assume anything with a CustomData is changed
         delete mCustomData;
         mCustomData = data;
@@ -230,6 +240,8 @@ namespace MWWorld
 
     CustomData *RefData::getCustomData()
     {
+        // The caller may modify the returned data
+        mChangedSinceSave = true;
         return mCustomData;
     }
 
@@ -243,8 +255,19 @@ namespace MWWorld
         return mChanged || !mAnimationState.empty();
     }
 
+    bool RefData::hasChangedSinceSave() const
+    {
+        return mChangedSinceSave;
+    }
+
+    void RefData::resetChangedSinceSave()
+    {
+        mChangedSinceSave = false;
+    }
+
     bool RefData::activateByScript()
     {
+        mChangedSinceSave = true;
         bool ret = (mFlags & Flag_ActivationBuffered);
         mFlags &= ~(Flag_SuppressActivate|Flag_OnActivate);
         return ret;
@@ -252,6 +275,7 @@ namespace MWWorld
 
     bool RefData::activate()
     {
+        mChangedSinceSave = true;
         if (mFlags & Flag_SuppressActivate)
         {
             mFlags |= Flag_OnActivate|Flag_ActivationBuffered;
@@ -265,6 +289,7 @@ namespace MWWorld
 
     bool RefData::onActivate()
     {
+        mChangedSinceSave = true;
         bool ret = mFlags & Flag_OnActivate;
         mFlags |= Flag_SuppressActivate;
         mFlags &= (~Flag_OnActivate);
@@ -278,6 +303,8 @@ namespace MWWorld
 
     ESM::AnimationState& RefData::getAnimationState()
     {
+        // The caller may modify the returned data
+        mChangedSinceSave = true;
         return mAnimationState;
     }
 
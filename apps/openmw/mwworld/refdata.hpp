@@ -53,6 +53,8 @@ namespace MWWorld
 
             bool mChanged;
 
+            bool mChangedSinceSave;
+
             unsigned int mFlags;
 
         public:
@@ -136,6 +138,13 @@ namespace MWWorld
             bool hasChanged() const;
             ///< Has this RefData changed since it was originally loaded?
 
+            bool hasChangedSinceSave() const;
+            ///< Could this RefData have changed since resetChangedSinceSave() was last called? Any setter counts as a
+            /// change, and so does non-const access to the locals, the custom data or the animation state.
+
+            void resetChangedSinceSave();
+            ///< Called once the state of this RefData has been written to a saved game.
+
             const ESM::AnimationState& getAnimationState() const;
             ESM::AnimationState& getAnimationState();
 
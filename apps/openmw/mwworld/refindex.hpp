@@ -0,0 +1,55 @@
+#ifndef GAME_MWWORLD_REFINDEX_H
+#define GAME_MWWORLD_REFINDEX_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace MWWorld
+{
+    /// \brief Hash table from a key to the references that have it
+    ///
+    /// References sharing a key are kept in the order they were inserted, so that looking one up gives the same
+    /// result as a linear scan over the references in that order.
+    template <typename Key, typename Ref>
+    class RefIndex
+    {
+            typedef std::unordered_map<Key, std::vector<Ref> > Map;
+            Map mMap;
+
+        public:
+
+            void clear()
+            {
+                mMap.clear();
+            }
+
+            void reserve (std::size_t size)
+            {
+                mMap.reserve (size);
+            }
+
+            void insert (const Key& key, const Ref& ref)
+            {
+                mMap[key].push_back (ref);
+            }
+
+            template <typename Predicate>
+            Ref findFirst (const Key& key, Predicate predicate) const
+            {
+                typename Map::const_iterator found = mMap.find (key);
+                if (found == mMap.end())
+                    return Ref();
+
+                for (typename std::vector<Ref>::const_iterator it = found->second.begin(); it != found->second.end(); ++it)
+                    if (predicate (*it))
+                        return *it;
+
+                return Ref();
+            }
+            ///< Return the first reference with \a key for which \a predicate is true, in insertion order, or a
+            /// default constructed Ref if there is none.
+    };
+}
+
+#endif
@@ -433,6 +433,7 @@ namespace MWWorld
         }
 
         int refsToLoad = 0;
+        std::vector<CellStore*> cellsToLoad;
         // get the number of refs to load
         for (int x=X-mHalfGridSize; x<=X+mHalfGridSize; ++x)
         {
@@ -452,37 +453,33 @@ namespace MWWorld
                 }
 
                 if (iter==mActiveCells.end())
-                    refsToLoad += MWBase::Environment::get().getWorld()->getExterior(x, y)->count();
+                {
+                    CellStore *cell = MWBase::Environment::get().getWorld()->getExterior(x, y);
+                    refsToLoad += cell->count();
+                    cellsToLoad.push_back(cell);
+                }
             }
         }
 
         loadingListener->setProgressRange(refsToLoad);
 
-        // Load cells
-        for (int x=X-mHalfGridSize; x<=X+mHalfGridSize; ++x)
+        // Prepare the new cells on the worker threads: instancing of their meshes and collision shapes, and terrain.
+        // Queue them in reverse so that the first cell we insert is the first to be prepared; while the main thread
+        // inserts one cell, the workers are already preparing the next ones.
+        if (mPreloadEnabled)
         {
-            for (int y=Y-mHalfGridSize; y<=Y+mHalfGridSize; ++y)
-            {
-                CellStoreCollection::iterator iter = mActiveCells.begin();
-
-                while (iter!=mActiveCells.end())
-                {
-                    assert ((*iter)->getCell()->isExterior());
-
-                    if (x==(*iter)->getCell()->getGridX() &&
-                        y==(*iter)->getCell()->getGridY())
-                        break;
-
-                    ++iter;
-                }
+            double timestamp = mRendering.getReferenceTime();
+            for (std::vector<CellStore*>::reverse_iterator it = cellsToLoad.rbegin(); it != cellsToLoad.rend(); ++it)
+                mPreloader->preload(*it, timestamp, true);
+        }
 
-                if (iter==mActiveCells.end())
-                {
-                    CellStore *cell = MWBase::Environment::get().getWorld()->getExterior(x, y);
+        // Load cells
+        for (std::vector<CellStore*>::iterator it = cellsToLoad.begin(); it != cellsToLoad.end(); ++it)
+        {
+            if (mPreloadEnabled)
+                mPreloader->waitForPreload(*it);
 
-                    loadCell (cell, loadingListener, changeEvent);
-                }
-            }
+            loadCell (*it, loadingListener, changeEvent);
         }
 
         /*
@@ -563,6 +560,9 @@ namespace MWWorld
         mPhysics->setUnrefQueue(rendering.getUnrefQueue());
 
         rendering.getResourceSystem()->setExpiryDelay(Settings::Manager::getFloat("cache expiry delay", "Cells"));
+        int memoryBudget = Settings::Manager::getInt("cache memory budget", "Cells");
+        if (memoryBudget > 0)
+            rendering.getResourceSystem()->setMemoryBudget(static_cast<size_t>(memoryBudget) * 1024 * 1024);
 
         mPreloader->setExpiryDelay(Settings::Manager::getFloat("preload cell expiry delay", "Cells"));
         mPreloader->setMinCacheSize(Settings::Manager::getInt("preload cell cache min", "Cells"));
@@ -4,6 +4,9 @@
 
 #include <osg/Group>
 #include <osg/ComputeBoundsVisitor>
+#include <osg/Timer>
+
+#include <osgViewer/Viewer>
 
 /*
     Start of tes3mp addition
@@ -43,6 +46,7 @@
 #include "../mwbase/mechanicsmanager.hpp"
 #include "../mwbase/windowmanager.hpp"
 #include "../mwbase/scriptmanager.hpp"
+#include "../mwbase/dialoguemanager.hpp"
 
 #include "../mwmechanics/creaturestats.hpp"
 #include "../mwmechanics/movement.hpp"
@@ -170,7 +174,7 @@ namespace MWWorld
         ToUTF8::Utf8Encoder* encoder, const std::map<std::string,std::string>& fallbackMap,
         int activationDistanceOverride, const std::string& startCell, const std::string& startupScript,
             const std::string& resourcePath, const std::string& userDataPath)
-    : mResourceSystem(resourceSystem), mFallback(fallbackMap), mLocalScripts (mStore),
+    : mViewer(viewer), mResourceSystem(resourceSystem), mFallback(fallbackMap), mLocalScripts (mStore),
       mSky (true), mCells (mStore, mEsm),
       mGodMode(false), mScriptsEnabled(true), mContentFiles (contentFiles), mUserDataPath(userDataPath),
       mActivationDistanceOverride (activationDistanceOverride), mStartupScript(startupScript),
@@ -373,6 +377,9 @@ namespace MWWorld
         {
             CellStore* cellstore = *iter;
             MWBase::Environment::get().getWindowManager()->writeFog(cellstore);
+
+            // Objects in active cells are changed all the time without going through their CellStore
+            cellstore->markAsChanged();
         }
 
         MWMechanics::CreatureStats::writeActorIdCounter(writer);
@@ -627,6 +634,8 @@ namespace MWWorld
             setMonth (value);
         else
             mGlobalVariables[name].setInteger (value);
+
+        MWBase::Environment::get().getDialogueManager()->notifyGlobalChanged (name);
     }
 
     void World::setGlobalFloat (const std::string& name, float value)
@@ -639,6 +648,8 @@ namespace MWWorld
             setMonth(static_cast<int>(value));
         else
             mGlobalVariables[name].setFloat (value);
+
+        MWBase::Environment::get().getDialogueManager()->notifyGlobalChanged (name);
     }
 
     int World::getGlobalInt (const std::string& name) const
@@ -689,7 +700,7 @@ namespace MWWorld
         for (Scene::CellStoreCollection::const_iterator iter (mWorldScene->getActiveCells().begin());
             iter!=mWorldScene->getActiveCells().end(); ++iter)
         {
-            // TODO: caching still doesn't work efficiently here (only works for the one CellStore that the reference is in)
+            // Each CellStore looks the ID up in its own refId index, so this is one hash lookup per active cell
             CellStore* cellstore = *iter;
             Ptr ptr = mCells.getPtr (lowerCaseName, *cellstore, false);
 
@@ -785,11 +796,13 @@ namespace MWWorld
                     deleteObject(ptr);
                     ptr.getCellRef().unsetRefNum();
                     ptr.getCellRef().setMpNum(0);
+                    cellStore->updateUniqueIndex(ptr);
 
                     MWWorld::ManualRef* reference = new MWWorld::ManualRef(getStore(), refId, 1);
                     MWWorld::Ptr newPtr = placeObject(reference->getPtr(), cellStore, *position);
                     newPtr.getCellRef().setRefNum(refNum);
                     newPtr.getCellRef().setMpNum(mpNum);
+                    newPtr.getCell()->updateUniqueIndex(newPtr);
 
                     // Update Ptrs for LocalActors and DedicatedActors
                     if (newPtr.getClass().isActor())
@@ -1880,14 +1893,29 @@ namespace MWWorld
 
         updateWeather(duration, paused);
 
+        osg::Timer_t beforePhysicsTick = osg::Timer::instance()->tick();
         if (!paused)
             doPhysics (duration);
+        osg::Timer_t afterPhysicsTick = osg::Timer::instance()->tick();
 
         updatePlayer();
 
         mPhysics->debugDraw();
 
+        osg::Timer_t beforeCellLoadingTick = osg::Timer::instance()->tick();
         mWorldScene->update (duration, paused);
+        osg::Timer_t afterCellLoadingTick = osg::Timer::instance()->tick();
+
+        osg::Timer_t startTick = mViewer->getStartTick();
+        unsigned int frameNumber = mViewer->getFrameStamp()->getFrameNumber();
+        osg::Stats* stats = mViewer->getViewerStats();
+        stats->setAttribute(frameNumber, "physics_time_begin", osg::Timer::instance()->delta_s(startTick, beforePhysicsTick));
+        stats->setAttribute(frameNumber, "physics_time_taken", osg::Timer::instance()->delta_s(beforePhysicsTick, afterPhysicsTick));
+        stats->setAttribute(frameNumber, "physics_time_end", osg::Timer::instance()->delta_s(startTick, afterPhysicsTick));
+
+        stats->setAttribute(frameNumber, "cell_loading_time_begin", osg::Timer::instance()->delta_s(startTick, beforeCellLoadingTick));
+        stats->setAttribute(frameNumber, "cell_loading_time_taken", osg::Timer::instance()->delta_s(beforeCellLoadingTick, afterCellLoadingTick));
+        stats->setAttribute(frameNumber, "cell_loading_time_end", osg::Timer::instance()->delta_s(startTick, afterCellLoadingTick));
 
         updateSoundListener();
 
@@ -3662,13 +3690,23 @@ namespace MWWorld
             turnIn = std::max(1, turnIn);
         }
 
-        mGlobalVariables["pchascrimegold"].setInteger((bounty <= playerGold) ? 1 : 0);
-
-        mGlobalVariables["pchasgolddiscount"].setInteger((discount <= playerGold) ? 1 : 0);
-        mGlobalVariables["crimegolddiscount"].setInteger(discount);
+        const std::pair<const char*, int> globals[] = {
+            std::make_pair("pchascrimegold", (bounty <= playerGold) ? 1 : 0),
+            std::make_pair("pchasgolddiscount", (discount <= playerGold) ? 1 : 0),
+            std::make_pair("crimegolddiscount", discount),
+            std::make_pair("crimegoldturnin", turnIn),
+            std::make_pair("pchasturnin", (turnIn <= playerGold) ? 1 : 0)
+        };
 
-        mGlobalVariables["crimegoldturnin"].setInteger(turnIn);
-        mGlobalVariables["pchasturnin"].setInteger((turnIn <= playerGold) ? 1 : 0);
+        for (size_t i = 0; i < sizeof(globals) / sizeof(globals[0]); ++i)
+        {
+            ESM::Variant& global = mGlobalVariables[globals[i].first];
+            if (global.getInteger() != globals[i].second)
+            {
+                global.setInteger(globals[i].second);
+                MWBase::Environment::get().getDialogueManager()->notifyGlobalChanged(globals[i].first);
+            }
+        }
     }
 
     void World::confiscateStolenItems(const Ptr &ptr)
@@ -71,6 +71,7 @@ namespace MWWorld
 
     class World final: public MWBase::World
     {
+            osg::ref_ptr<osgViewer::Viewer> mViewer;
             Resource::ResourceSystem* mResourceSystem;
 
             Fallback::Map mFallback;
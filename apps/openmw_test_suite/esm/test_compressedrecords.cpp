@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+#include "components/esm/compressedrecords.hpp"
+#include "components/esm/esmreader.hpp"
+#include "components/esm/esmwriter.hpp"
+
+namespace
+{
+    /// Serialize \a count cell state like records, which repeat a lot of ids as real saves do
+    std::string writeRecords(int count)
+    {
+        std::ostringstream stream;
+        ESM::ESMWriter writer;
+        writer.startRecords(stream);
+
+        for (int i = 0; i < count; ++i)
+        {
+            writer.startRecord("CSTA");
+            writer.writeHNString("NAME", "Balmora, Guild of Mages");
+            writer.writeHNT("INDX", i);
+            for (int j = 0; j < 20; ++j)
+            {
+                writer.writeHNString("OBJE", "misc_com_bottle_" + std::to_string(j % 7));
+                writer.writeHNT("POS_", static_cast<float>(i * 20 + j));
+            }
+            writer.endRecord("CSTA");
+        }
+
+        writer.close();
+        return stream.str();
+    }
+
+    std::vector<int> readIndices(ESM::ESMReader& reader)
+    {
+        std::vector<int> indices;
+        while (reader.hasMoreRecs())
+        {
+            ESM::NAME name = reader.getRecName();
+            reader.getRecHeader();
+            EXPECT_EQ("CSTA", name.toString());
+
+            EXPECT_EQ("Balmora, Guild of Mages", reader.getHNString("NAME"));
+            int index;
+            reader.getHNT(index, "INDX");
+            indices.push_back(index);
+            reader.skipRecord();
+        }
+        return indices;
+    }
+}
+
+TEST(CompressedRecordsTest, blocks_should_hold_whole_records_and_decompress_to_the_original)
+{
+    const std::string records = writeRecords(5000);
+
+    std::vector<ESM::CompressedRecords> blocks;
+    ESM::CompressedRecords::compress(records, 6, blocks);
+    ASSERT_GT(blocks.size(), 1u);
+
+    std::string decompressed;
+    for (std::vector<ESM::CompressedRecords>::const_iterator it = blocks.begin(); it != blocks.end(); ++it)
+        decompressed += it->decompress();
+    EXPECT_EQ(records, decompressed);
+
+    ESM::ESMReader parent;
+    std::vector<int> indices;
+    for (std::vector<ESM::CompressedRecords>::const_iterator it = blocks.begin(); it != blocks.end(); ++it)
+    {
+        ESM::ESMReader reader;
+        reader.openBlock(Files::IStreamPtr(new std::istringstream(it->decompress())), parent);
+        std::vector<int> blockIndices = readIndices(reader);
+        indices.insert(indices.end(), blockIndices.begin(), blockIndices.end());
+    }
+
+    ASSERT_EQ(5000u, indices.size());
+    for (int i = 0; i < 5000; ++i)
+        EXPECT_EQ(i, indices[i]);
+}
+
+TEST(CompressedRecordsTest, block_should_survive_a_round_trip_through_a_record)
+{
+    std::vector<ESM::CompressedRecords> blocks;
+    ESM::CompressedRecords::compress(writeRecords(10), 1, blocks);
+    ASSERT_EQ(1u, blocks.size());
+
+    std::ostringstream stream;
+    ESM::ESMWriter writer;
+    writer.startRecords(stream);
+    writer.startRecord(ESM::CompressedRecords::sRecordId);
+    blocks[0].save(writer);
+    writer.endRecord(ESM::CompressedRecords::sRecordId);
+    writer.close();
+
+    ESM::ESMReader reader;
+    reader.openRaw(Files::IStreamPtr(new std::istringstream(stream.str())), "test");
+    ESM::NAME name = reader.getRecName();
+    reader.getRecHeader();
+    EXPECT_TRUE(name == ESM::CompressedRecords::sRecordId);
+
+    ESM::CompressedRecords loaded;
+    loaded.load(reader);
+    EXPECT_EQ(writeRecords(10), loaded.decompress());
+}
+
+TEST(CompressedRecordsTest, truncated_records_should_not_be_compressed)
+{
+    std::string records = writeRecords(2);
+    records.resize(records.size() - 1);
+
+    std::vector<ESM::CompressedRecords> blocks;
+    EXPECT_THROW(ESM::CompressedRecords::compress(records, 6, blocks), std::runtime_error);
+}
+
+TEST(CompressedRecordsTest, blocks_should_round_trip_and_shrink_records_at_every_level)
+{
+    const std::string records = writeRecords(5000);
+
+    for (int level = 1; level <= 9; ++level)
+    {
+        std::vector<ESM::CompressedRecords> blocks;
+        ESM::CompressedRecords::compress(records, level, blocks);
+
+        std::string decompressed;
+        size_t compressedSize = 0;
+        for (std::vector<ESM::CompressedRecords>::const_iterator it = blocks.begin(); it != blocks.end(); ++it)
+        {
+            compressedSize += it->mData.size();
+            decompressed += it->decompress();
+        }
+
+        EXPECT_EQ(records, decompressed) << "level " << level;
+        EXPECT_LT(compressedSize, records.size()) << "level " << level;
+    }
+}
+
+// Size and time of the compressed container against the plain records. The records are synthetic,
+// so the ratio is only indicative of real saves. Only prints its results, so it is disabled by default;
+// run it with --gtest_also_run_disabled_tests.
+TEST(CompressedRecordsTest, DISABLED_size_and_time_comparison)
+{
+    const std::string records = writeRecords(5000);
+
+    for (int level = 1; level <= 9; level += 4)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::vector<ESM::CompressedRecords> blocks;
+        ESM::CompressedRecords::compress(records, level, blocks);
+        std::chrono::duration<double, std::milli> compressTime = std::chrono::steady_clock::now() - start;
+
+        size_t compressedSize = 0;
+        start = std::chrono::steady_clock::now();
+        for (std::vector<ESM::CompressedRecords>::const_iterator it = blocks.begin(); it != blocks.end(); ++it)
+        {
+            compressedSize += it->mData.size();
+            EXPECT_EQ(it->mSize, it->decompress().size());
+        }
+        std::chrono::duration<double, std::milli> decompressTime = std::chrono::steady_clock::now() - start;
+
+        std::cout << "level " << level << ": " << records.size() << " -> " << compressedSize << " bytes in "
+                  << blocks.size() << " blocks, compress " << compressTime.count() << " ms, decompress "
+                  << decompressTime.count() << " ms" << std::endl;
+    }
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "components/esm/esmwriter.hpp"
+
+namespace
+{
+    void writeTestRecord(ESM::ESMWriter& writer)
+    {
+        writer.startRecord("CSTA");
+        writer.writeHNString("NAME", "Balmora");
+        writer.writeHNT("DATA", 42);
+        writer.startSubRecord("OBJE");
+        writer.writeT(1.5f);
+        writer.writeT(7);
+        writer.endRecord("OBJE");
+        writer.endRecord("CSTA");
+    }
+
+    void writeTestFile(ESM::ESMWriter& writer, std::ostream& stream, const std::string* rawRecord)
+    {
+        writer.setFormat(1);
+        writer.setRecordCount(3);
+        writer.save(stream);
+
+        writer.startRecord("GLOB");
+        writer.writeHNString("NAME", "test");
+        writer.endRecord("GLOB");
+
+        if (rawRecord)
+            writer.writeRawRecord(*rawRecord);
+        else
+            writeTestRecord(writer);
+
+        writer.startRecord("GLOB");
+        writer.writeHNString("NAME", "test2");
+        writer.endRecord("GLOB");
+
+        writer.close();
+    }
+}
+
+TEST(EsmWriterTest, raw_record_should_match_record_written_directly)
+{
+    std::ostringstream direct;
+    ESM::ESMWriter directWriter;
+    writeTestFile(directWriter, direct, nullptr);
+
+    std::ostringstream recordStream;
+    ESM::ESMWriter recordWriter;
+    recordWriter.startRecords(recordStream);
+    writeTestRecord(recordWriter);
+    recordWriter.close();
+    EXPECT_EQ(1, recordWriter.getRecordCount());
+
+    const std::string record = recordStream.str();
+    std::ostringstream raw;
+    ESM::ESMWriter rawWriter;
+    writeTestFile(rawWriter, raw, &record);
+
+    EXPECT_EQ(direct.str(), raw.str());
+    EXPECT_EQ(directWriter.getRecordCount(), rawWriter.getRecordCount());
+}
+
+TEST(EsmWriterTest, raw_record_should_not_be_written_inside_another_record)
+{
+    std::ostringstream stream;
+    ESM::ESMWriter writer;
+    writer.startRecords(stream);
+    writer.startRecord("CSTA");
+    EXPECT_THROW(writer.writeRawRecord("CSTA"), std::runtime_error);
+}
@@ -0,0 +1,259 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#include "components/compiler/context.hpp"
+#include "components/compiler/extensions.hpp"
+#include "components/compiler/fileparser.hpp"
+#include "components/compiler/scanner.hpp"
+#include "components/compiler/streamerrorhandler.hpp"
+
+#include "components/interpreter/context.hpp"
+#include "components/interpreter/installopcodes.hpp"
+#include "components/interpreter/interpreter.hpp"
+
+namespace
+{
+    class CompilerContext : public Compiler::Context
+    {
+        public:
+
+            virtual bool canDeclareLocals() const { return true; }
+
+            virtual char getGlobalType (const std::string& name) const
+            {
+                return name == "gamehour" ? 'f' : name == "counter" ? 'l' : ' ';
+            }
+
+            virtual std::pair<char, bool> getMemberType (const std::string& name, const std::string& id) const
+            {
+                return std::make_pair (' ', false);
+            }
+
+            virtual bool isId (const std::string& name) const { return false; }
+
+            virtual bool isJournalId (const std::string& name) const { return false; }
+    };
+
+    /// Keeps locals and globals in memory and ignores everything that would need the game world
+    class InterpreterContext : public Interpreter::Context
+    {
+            std::vector<int> mShorts;
+            std::vector<int> mLongs;
+            std::vector<float> mFloats;
+            std::map<std::string, float> mGlobals;
+
+        public:
+
+            InterpreterContext (const Compiler::Locals& locals)
+                : mShorts (locals.get ('s').size()), mLongs (locals.get ('l').size()), mFloats (locals.get ('f').size())
+            {
+                mGlobals["gamehour"] = 9.5f;
+                mGlobals["counter"] = 0;
+            }
+
+            virtual int getLocalShort (int index) const { return mShorts.at (index); }
+            virtual int getLocalLong (int index) const { return mLongs.at (index); }
+            virtual float getLocalFloat (int index) const { return mFloats.at (index); }
+            virtual void setLocalShort (int index, int value) { mShorts.at (index) = value; }
+            virtual void setLocalLong (int index, int value) { mLongs.at (index) = value; }
+            virtual void setLocalFloat (int index, float value) { mFloats.at (index) = value; }
+
+            virtual void messageBox (const std::string& message, const std::vector<std::string>& buttons) {}
+            virtual void report (const std::string& message) {}
+            virtual bool menuMode() { return false; }
+
+            virtual int getGlobalShort (const std::string& name) const { return static_cast<int> (mGlobals.at (name)); }
+            virtual int getGlobalLong (const std::string& name) const { return static_cast<int> (mGlobals.at (name)); }
+            virtual float getGlobalFloat (const std::string& name) const { return mGlobals.at (name); }
+            virtual void setGlobalShort (const std::string& name, int value) { mGlobals[name] = value; }
+            virtual void setGlobalLong (const std::string& name, int value) { mGlobals[name] = value; }
+            virtual void setGlobalFloat (const std::string& name, float value) { mGlobals[name] = value; }
+            virtual std::vector<std::string> getGlobals() const { return std::vector<std::string>(); }
+            virtual char getGlobalType (const std::string& name) const { return ' '; }
+
+            virtual std::string getActionBinding (const std::string& action) const { return ""; }
+            virtual std::string getNPCName() const { return ""; }
+            virtual std::string getNPCRace() const { return ""; }
+            virtual std::string getNPCClass() const { return ""; }
+            virtual std::string getNPCFaction() const { return ""; }
+            virtual std::string getNPCRank() const { return ""; }
+            virtual std::string getPCName() const { return ""; }
+            virtual std::string getPCRace() const { return ""; }
+            virtual std::string getPCClass() const { return ""; }
+            virtual std::string getPCRank() const { return ""; }
+            virtual std::string getPCNextRank() const { return ""; }
+            virtual int getPCBounty() const { return 0; }
+            virtual std::string getCurrentCellName() const { return ""; }
+
+            virtual bool isScriptRunning (const std::string& name) const { return false; }
+            virtual void startScript (const std::string& name, const std::string& targetId) {}
+            virtual void stopScript (const std::string& name) {}
+            virtual float getDistance (const std::string& name, const std::string& id) const { return 0; }
+            virtual float getSecondsPassed() const { return 1.f / 60; }
+            virtual bool isDisabled (const std::string& id) const { return false; }
+            virtual void enable (const std::string& id) {}
+            virtual void disable (const std::string& id) {}
+
+            virtual int getMemberShort (const std::string& id, const std::string& name, bool global) const { return 0; }
+            virtual int getMemberLong (const std::string& id, const std::string& name, bool global) const { return 0; }
+            virtual float getMemberFloat (const std::string& id, const std::string& name, bool global) const { return 0; }
+            virtual void setMemberShort (const std::string& id, const std::string& name, int value, bool global) {}
+            virtual void setMemberLong (const std::string& id, const std::string& name, int value, bool global) {}
+            virtual void setMemberFloat (const std::string& id, const std::string& name, float value, bool global) {}
+
+            virtual std::string getTargetId() const { return ""; }
+
+            virtual unsigned short getContextType() const { return SCRIPT_LOCAL; }
+            virtual void setContextType (unsigned short interpreterType) {}
+    };
+
+    struct CompiledScript
+    {
+        std::vector<Interpreter::Type_Code> mCode;
+        Compiler::Locals mLocals;
+    };
+
+    CompiledScript compile (const std::string& source)
+    {
+        std::ostringstream errors;
+        Compiler::StreamErrorHandler errorHandler (errors);
+        CompilerContext context;
+        Compiler::Extensions extensions;
+        context.setExtensions (&extensions);
+        Compiler::FileParser parser (errorHandler, context);
+
+        std::istringstream input (source);
+        Compiler::Scanner scanner (errorHandler, input, &extensions);
+        scanner.scan (parser);
+
+        if (!errorHandler.isGood())
+            throw std::runtime_error ("failed to compile script: " + errors.str());
+
+        CompiledScript script;
+        parser.getCode (script.mCode);
+        script.mLocals = parser.getLocals();
+        return script;
+    }
+
+    /// Similar in shape to the timer and state machine local scripts most objects carry
+    std::string makeScript (int index)
+    {
+        std::ostringstream source;
+        source << "begin test_script_" << index << "\n"
+               << "short state\n"
+               << "long count\n"
+               << "float timer\n"
+               << "short i\n"
+               << "set timer to timer + 0.016\n"
+               << "if ( timer < " << (index % 5 + 1) << " )\n"
+               << "    return\n"
+               << "endif\n"
+               << "set timer to 0\n"
+               << "if ( state == 0 )\n"
+               << "    set state to 1\n"
+               << "elseif ( state == 1 )\n"
+               << "    set i to 0\n"
+               << "    while ( i < " << (index % 8 + 2) << " )\n"
+               << "        set count to count + i * 2 - 1\n"
+               << "        set i to i + 1\n"
+               << "    endwhile\n"
+               << "    if ( GameHour > 8 )\n"
+               << "        set state to 2\n"
+               << "    endif\n"
+               << "else\n"
+               << "    set Counter to Counter + 1\n"
+               << "    set state to 0\n"
+               << "endif\n"
+               << "end\n";
+        return source.str();
+    }
+}
+
+TEST(InterpreterTest, program_should_give_the_same_result_as_byte_code)
+{
+    CompiledScript script = compile (makeScript (7));
+
+    Interpreter::Interpreter interpreter;
+    Interpreter::installOpcodes (interpreter);
+
+    InterpreterContext byteCodeContext (script.mLocals);
+    InterpreterContext programContext (script.mLocals);
+    Interpreter::Program program (script.mCode);
+
+    for (int frame = 0; frame < 1000; ++frame)
+    {
+        interpreter.run (&script.mCode[0], script.mCode.size(), byteCodeContext);
+        interpreter.run (program, programContext);
+    }
+
+    EXPECT_EQ (byteCodeContext.getLocalShort (0), programContext.getLocalShort (0));
+    EXPECT_EQ (byteCodeContext.getLocalLong (0), programContext.getLocalLong (0));
+    EXPECT_EQ (byteCodeContext.getGlobalLong ("counter"), programContext.getGlobalLong ("counter"));
+    EXPECT_GT (programContext.getLocalLong (0), 0);
+    EXPECT_GT (programContext.getGlobalLong ("counter"), 0);
+}
+
+TEST(InterpreterTest, unknown_opcode_should_only_fail_when_executed)
+{
+    CompiledScript script = compile ("begin test\nshort a\nif ( a == 1 )\nset a to 2\nendif\nend\n");
+
+    Interpreter::Interpreter interpreter;
+    Interpreter::installOpcodes (interpreter);
+    InterpreterContext context (script.mLocals);
+
+    // Replace the store of "set a to 2", which is only reached if a is 1, with a segment 5 opcode nobody installed
+    std::vector<Interpreter::Type_Code> code = script.mCode;
+    const Interpreter::Type_Code storeLocalShort = 0xc8000000;
+    std::vector<Interpreter::Type_Code>::iterator store = std::find (code.begin() + 4, code.begin() + 4 + code[0], storeLocalShort);
+    ASSERT_TRUE (store != code.begin() + 4 + code[0]);
+    *store = 0xc8000000 | 0x3fffff;
+
+    Interpreter::Program program (code);
+    EXPECT_NO_THROW (interpreter.run (program, context));
+
+    context.setLocalShort (0, 1);
+    EXPECT_THROW (interpreter.run (program, context), std::runtime_error);
+}
+
+// Runs a set of local script like programs for a number of frames, once decoding the byte code on every
+// run, as one-off console and dialogue scripts do, and once reusing a decoded Program like ScriptManager does.
+// Only prints timings, so it is disabled by default; run it with --gtest_also_run_disabled_tests.
+TEST(InterpreterTest, DISABLED_run_benchmark)
+{
+    const int numScripts = 300;
+    const int numFrames = 200;
+
+    Interpreter::Interpreter interpreter;
+    Interpreter::installOpcodes (interpreter);
+
+    std::vector<CompiledScript> scripts;
+    std::vector<Interpreter::Program> programs;
+    std::vector<InterpreterContext> contexts;
+    for (int i = 0; i < numScripts; ++i)
+    {
+        scripts.push_back (compile (makeScript (i)));
+        programs.push_back (Interpreter::Program (scripts.back().mCode));
+        contexts.push_back (InterpreterContext (scripts.back().mLocals));
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < numFrames; ++frame)
+        for (int i = 0; i < numScripts; ++i)
+            interpreter.run (&scripts[i].mCode[0], scripts[i].mCode.size(), contexts[i]);
+    std::chrono::duration<double, std::milli> byteCodeTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < numFrames; ++frame)
+        for (int i = 0; i < numScripts; ++i)
+            interpreter.run (programs[i], contexts[i]);
+    std::chrono::duration<double, std::milli> programTime = std::chrono::steady_clock::now() - start;
+
+    std::cout << numScripts << " scripts, " << numFrames << " frames: byte code " << byteCodeTime.count()
+              << " ms, decoded program " << programTime.count() << " ms" << std::endl;
+}
@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "components/misc/stablevector.hpp"
+
+namespace
+{
+    struct Counted
+    {
+        static int sAlive;
+        int mValue;
+
+        Counted(int value) : mValue(value) { ++sAlive; }
+        Counted(const Counted& other) : mValue(other.mValue) { ++sAlive; }
+        ~Counted() { --sAlive; }
+    };
+
+    int Counted::sAlive = 0;
+
+    template <typename Container>
+    std::vector<int> toVector(const Container& container)
+    {
+        std::vector<int> result;
+        for (typename Container::const_iterator it = container.begin(); it != container.end(); ++it)
+            result.push_back(it->mValue);
+        return result;
+    }
+}
+
+TEST(StableVectorTest, should_keep_element_addresses_stable_when_growing)
+{
+    Misc::StableVector<Counted, 4> container;
+    container.push_back(Counted(0));
+    const Counted* first = &container.front();
+    Misc::StableVector<Counted, 4>::iterator firstIt = container.begin();
+
+    for (int i = 1; i < 100; ++i)
+        container.push_back(Counted(i));
+
+    EXPECT_EQ(first, &container.front());
+    EXPECT_EQ(first, &*firstIt);
+    EXPECT_EQ(100u, container.size());
+    EXPECT_EQ(99, container.back().mValue);
+}
+
+TEST(StableVectorTest, should_iterate_in_insertion_order_and_skip_erased_elements)
+{
+    Misc::StableVector<Counted, 4> container;
+    for (int i = 0; i < 10; ++i)
+        container.push_back(Counted(i));
+
+    for (Misc::StableVector<Counted, 4>::iterator it = container.begin(); it != container.end();)
+    {
+        if (it->mValue % 3 == 0)
+            it = container.erase(it);
+        else
+            ++it;
+    }
+
+    const std::vector<int> expected = {1, 2, 4, 5, 7, 8};
+    EXPECT_EQ(expected, toVector(container));
+    EXPECT_EQ(6u, container.size());
+    EXPECT_EQ(1, container.front().mValue);
+    EXPECT_EQ(8, container.back().mValue);
+    EXPECT_EQ(6, Counted::sAlive);
+
+    container.clear();
+    EXPECT_TRUE(container.empty());
+    EXPECT_TRUE(container.begin() == container.end());
+    EXPECT_EQ(0, Counted::sAlive);
+}
+
+TEST(StableVectorTest, should_step_back_from_end_over_erased_elements)
+{
+    Misc::StableVector<Counted, 4> container;
+    for (int i = 0; i < 6; ++i)
+        container.push_back(Counted(i));
+    container.erase(--container.end());
+    container.erase(--container.end());
+
+    EXPECT_EQ(3, (--container.end())->mValue);
+    EXPECT_EQ(3, container.back().mValue);
+}
+
+TEST(StableVectorTest, copy_should_only_contain_live_elements)
+{
+    Misc::StableVector<Counted, 4> container;
+    for (int i = 0; i < 5; ++i)
+        container.push_back(Counted(i));
+    container.erase(container.begin());
+
+    Misc::StableVector<Counted, 4> copy(container);
+    EXPECT_EQ(toVector(container), toVector(copy));
+    EXPECT_NE(&container.front(), &copy.front());
+
+    Misc::StableVector<Counted, 4> assigned;
+    assigned.push_back(Counted(42));
+    assigned = copy;
+    EXPECT_EQ(toVector(container), toVector(assigned));
+}
+
+TEST(StableVectorTest, iterators_should_work_with_standard_algorithms)
+{
+    Misc::StableVector<int> container;
+    for (int i = 0; i < 200; ++i)
+        container.push_back(i * 2);
+
+    Misc::StableVector<int>::iterator found = std::find(container.begin(), container.end(), 150);
+    ASSERT_TRUE(found != container.end());
+    EXPECT_EQ(150, *found);
+
+    const Misc::StableVector<int>& constContainer = container;
+    Misc::StableVector<int>::const_iterator constFound = found;
+    EXPECT_TRUE(constFound == found);
+    EXPECT_EQ(75, std::distance(constContainer.begin(), constFound));
+}
+
+// Compares a full visitor pass over cell references stored in std::list (one heap node per reference)
+// with the chunked storage CellRefList now uses. The element size and count roughly match the
+// references of a large city cell; other allocations are interleaved to fragment the list like
+// loading a cell would. Only prints timings, so it is disabled by default; run it with
+// --gtest_also_run_disabled_tests.
+TEST(StableVectorTest, DISABLED_full_pass_benchmark)
+{
+    struct Reference
+    {
+        float mPosition[6];
+        int mCount;
+        bool mEnabled;
+        std::string mRefId;
+        char mPayload[256];
+    };
+
+    const int numRefs = 4000;
+    const int numPasses = 500;
+
+    std::list<Reference> list;
+    Misc::StableVector<Reference> stable;
+    std::vector<std::unique_ptr<char[]> > fragmentation;
+
+    for (int i = 0; i < numRefs; ++i)
+    {
+        Reference ref;
+        std::fill(ref.mPosition, ref.mPosition + 6, static_cast<float>(i));
+        ref.mCount = 1 + i % 3;
+        ref.mEnabled = (i % 7) != 0;
+        ref.mRefId = "ref_" + std::to_string(i);
+        list.push_back(ref);
+        stable.push_back(ref);
+        fragmentation.push_back(std::unique_ptr<char[]>(new char[64 + (i % 5) * 48]));
+    }
+
+    long long listSum = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < numPasses; ++pass)
+    {
+        for (std::list<Reference>::const_iterator it = list.begin(); it != list.end(); ++it)
+            if (it->mEnabled)
+                listSum += it->mCount;
+    }
+    std::chrono::duration<double, std::milli> listTime = std::chrono::steady_clock::now() - start;
+
+    long long stableSum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < numPasses; ++pass)
+    {
+        for (Misc::StableVector<Reference>::const_iterator it = stable.begin(); it != stable.end(); ++it)
+            if (it->mEnabled)
+                stableSum += it->mCount;
+    }
+    std::chrono::duration<double, std::milli> stableTime = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(listSum, stableSum);
+
+    std::cout << numRefs << " references, " << numPasses << " passes: std::list " << listTime.count()
+              << " ms, StableVector " << stableTime.count() << " ms" << std::endl;
+}
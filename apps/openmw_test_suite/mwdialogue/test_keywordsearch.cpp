@@ -1,4 +1,11 @@
 #include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <set>
+
 #include "apps/openmw/mwdialogue/keywordsearch.hpp"
 
 struct KeywordSearchTest : public ::testing::Test
@@ -65,3 +72,518 @@ TEST_F(KeywordSearchTest, keyword_test_conflict_resolution3)
     ASSERT_TRUE (matches.size() == 1);
     ASSERT_TRUE (std::string(matches.front().mBeg, matches.front().mEnd) == "bar lock");
 }
+
+TEST_F(KeywordSearchTest, keyword_test_word_start)
+{
+    // keywords must start at the beginning of a word, but may end within one
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("bar", 0);
+
+    std::string text = "foobar barn";
+
+    std::vector<MWDialogue::KeywordSearch<std::string, int>::Match> matches;
+    search.highlightKeywords(text.begin(), text.end(), matches);
+
+    ASSERT_TRUE (matches.size() == 1);
+    ASSERT_TRUE (matches.front().mBeg - text.begin() == 7);
+    ASSERT_TRUE (std::string(matches.front().mBeg, matches.front().mEnd) == "bar");
+}
+
+TEST_F(KeywordSearchTest, keyword_test_longest_at_same_position)
+{
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("dwemer", 1);
+    search.seed("dwemer ruins", 2);
+    search.seed("ruins", 3);
+
+    std::string text = "Visit the Dwemer Ruins.";
+
+    std::vector<MWDialogue::KeywordSearch<std::string, int>::Match> matches;
+    search.highlightKeywords(text.begin(), text.end(), matches);
+
+    ASSERT_TRUE (matches.size() == 1);
+    ASSERT_TRUE (std::string(matches.front().mBeg, matches.front().mEnd) == "Dwemer Ruins");
+    ASSERT_TRUE (matches.front().mValue == 2);
+}
+
+TEST_F(KeywordSearchTest, keyword_test_contains_keyword)
+{
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("latest rumors", 1);
+    search.seed("latest", 2);
+
+    int value = 0;
+    ASSERT_TRUE (search.containsKeyword("Latest Rumors", value));
+    ASSERT_TRUE (value == 1);
+    ASSERT_TRUE (search.containsKeyword("latest", value));
+    ASSERT_TRUE (value == 2);
+    ASSERT_FALSE (search.containsKeyword("latest rumor", value));
+    ASSERT_FALSE (search.containsKeyword("rumors", value));
+
+    search.seed("rumors", 3);
+    ASSERT_TRUE (search.containsKeyword("rumors", value));
+    ASSERT_TRUE (value == 3);
+
+    search.clear();
+    ASSERT_FALSE (search.containsKeyword("latest", value));
+}
+
+TEST_F(KeywordSearchTest, keyword_test_duplicate)
+{
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("duties", 0);
+    search.seed("duties", 1);
+
+    int value = 0;
+    ASSERT_THROW (search.containsKeyword("duties", value), std::runtime_error);
+}
+
+namespace
+{
+    typedef MWDialogue::KeywordSearch<std::string, int> Search;
+
+    // Reference implementation: test every keyword at every word start, keep the longest one,
+    // then resolve overlaps the same way KeywordSearch does
+    std::vector<Search::Match> highlightKeywordsNaive(const std::vector<std::string>& keywords, const std::string& text)
+    {
+        std::vector<Search::Match> matches;
+        for (std::string::const_iterator i = text.begin(); i != text.end(); ++i)
+        {
+            if (i != text.begin() && isalpha(*(i - 1)))
+                continue;
+
+            int best = -1;
+            for (size_t k = 0; k < keywords.size(); ++k)
+            {
+                const std::string& keyword = keywords[k];
+                if (static_cast<size_t>(text.end() - i) < keyword.size())
+                    continue;
+                if (!Misc::StringUtils::ciEqual(std::string(i, i + keyword.size()), keyword))
+                    continue;
+                if (best == -1 || keyword.size() > keywords[best].size())
+                    best = static_cast<int>(k);
+            }
+
+            if (best != -1)
+            {
+                Search::Match match;
+                match.mBeg = i;
+                match.mEnd = i + keywords[best].size();
+                match.mValue = best;
+                matches.push_back(match);
+            }
+        }
+
+        std::vector<Search::Match> out;
+        while (!matches.empty())
+        {
+            int longestKeywordSize = 0;
+            std::vector<Search::Match>::iterator longestKeyword = matches.begin();
+            for (std::vector<Search::Match>::iterator it = matches.begin(); it != matches.end(); ++it)
+            {
+                int size = it->mEnd - it->mBeg;
+                if (size > longestKeywordSize)
+                {
+                    longestKeywordSize = size;
+                    longestKeyword = it;
+                }
+
+                std::vector<Search::Match>::iterator next = it;
+                ++next;
+                if (next == matches.end() || it->mEnd <= next->mBeg)
+                    break;
+            }
+
+            Search::Match keyword = *longestKeyword;
+            matches.erase(longestKeyword);
+            out.push_back(keyword);
+            for (std::vector<Search::Match>::iterator it = matches.begin(); it != matches.end();)
+            {
+                if (it->mBeg < keyword.mEnd && it->mEnd > keyword.mBeg)
+                    it = matches.erase(it);
+                else
+                    ++it;
+            }
+        }
+
+        std::sort(out.begin(), out.end(), Search::sortMatches);
+        return out;
+    }
+
+    // Topic-like keywords and texts made of a small vocabulary, so that keywords overlap, share prefixes
+    // and are suffixes of each other a lot
+    struct RandomTopics
+    {
+        std::vector<std::string> mKeywords;
+        std::vector<std::string> mTexts;
+
+        RandomTopics(unsigned int seed, size_t numKeywords, size_t numTexts, size_t textWords)
+        {
+            static const char* const words[] = {
+                "the", "dwemer", "ruins", "latest", "rumors", "mages", "guild", "fighters", "house", "hlaalu",
+                "redoran", "telvanni", "vivec", "balmora", "ald'ruhn", "ash", "vampire", "nerevarine", "blight",
+                "temple", "duties", "little", "secret", "ald", "a", "an", "bar", "barn", "s", "-"
+            };
+            const size_t numWords = sizeof(words) / sizeof(words[0]);
+
+            std::mt19937 rng(seed);
+            std::set<std::string> unique;
+            while (unique.size() < numKeywords)
+            {
+                std::string keyword = words[rng() % numWords];
+                for (unsigned int n = rng() % 3; n > 0; --n)
+                    keyword += std::string(rng() % 4 == 0 ? "" : " ") + words[rng() % numWords];
+                unique.insert(keyword);
+            }
+            mKeywords.assign(unique.begin(), unique.end());
+            std::shuffle(mKeywords.begin(), mKeywords.end(), rng);
+
+            static const char* const separators[] = { " ", " ", " ", ", ", ". ", "'", "" };
+            for (size_t i = 0; i < numTexts; ++i)
+            {
+                std::string text;
+                for (size_t n = 0; n < textWords; ++n)
+                {
+                    std::string word = words[rng() % numWords];
+                    if (rng() % 5 == 0)
+                        word[0] = static_cast<char>(toupper(word[0]));
+                    text += word + separators[rng() % (sizeof(separators) / sizeof(separators[0]))];
+                }
+                mTexts.push_back(text);
+            }
+        }
+    };
+
+    // The trie KeywordSearch used before the automaton, kept to compare the throughput against.
+    // It requires the keywords to be seeded in sorted order.
+    template <typename string_t, typename value_t>
+    class TrieKeywordSearch
+    {
+    public:
+
+        typedef typename string_t::const_iterator Point;
+
+        struct Match
+        {
+            Point mBeg;
+            Point mEnd;
+            value_t mValue;
+        };
+
+        void seed (string_t keyword, value_t value)
+        {
+            if (keyword.empty())
+                return;
+            seed_impl  (/*std::move*/ (keyword), /*std::move*/ (value), 0, mRoot);
+        }
+
+        void clear ()
+        {
+            mRoot.mChildren.clear ();
+            mRoot.mKeyword.clear ();
+        }
+
+        bool containsKeyword (string_t keyword, value_t& value)
+        {
+            typename Entry::childen_t::iterator current;
+            typename Entry::childen_t::iterator next;
+
+            current = mRoot.mChildren.find (Misc::StringUtils::toLower (*keyword.begin()));
+            if (current == mRoot.mChildren.end())
+                return false;
+            else if (current->second.mKeyword.size() && Misc::StringUtils::ciEqual(current->second.mKeyword, keyword))
+            {
+                value = current->second.mValue;
+                return true;
+            }
+
+            for (Point i = ++keyword.begin(); i != keyword.end(); ++i)
+            {
+                next = current->second.mChildren.find(Misc::StringUtils::toLower (*i));
+                if (next == current->second.mChildren.end())
+                    return false;
+                if (Misc::StringUtils::ciEqual(next->second.mKeyword, keyword))
+                {
+                    value = next->second.mValue;
+                    return true;
+                }
+                current = next;
+            }
+            return false;
+        }
+
+        static bool sortMatches(const Match& left, const Match& right)
+        {
+            return left.mBeg < right.mBeg;
+        }
+
+        void highlightKeywords (Point beg, Point end, std::vector<Match>& out)
+        {
+            std::vector<Match> matches;
+            for (Point i = beg; i != end; ++i)
+            {
+                // check if previous character marked start of new word
+                if (i != beg)
+                {
+                    Point prev = i;
+                    --prev;
+                    if(isalpha(*prev))
+                        continue;
+                }
+
+
+                // check first character
+                typename Entry::childen_t::iterator candidate = mRoot.mChildren.find (Misc::StringUtils::toLower (*i));
+
+                // no match, on to next character
+                if (candidate == mRoot.mChildren.end ())
+                    continue;
+
+                // see how far the match goes
+                Point j = i;
+
+                // some keywords might be longer variations of other keywords, so we definitely need a list of candidates
+                // the first element in the pair is length of the match, i.e. depth from the first character on
+                std::vector< typename std::pair<int, typename Entry::childen_t::iterator> > candidates;
+
+                while ((j + 1) != end)
+                {
+                    typename Entry::childen_t::iterator next = candidate->second.mChildren.find (Misc::StringUtils::toLower (*++j));
+
+                    if (next == candidate->second.mChildren.end ())
+                    {
+                        if (candidate->second.mKeyword.size() > 0)
+                            candidates.push_back(std::make_pair((j-i), candidate));
+                        break;
+                    }
+
+                    candidate = next;
+
+                    if (candidate->second.mKeyword.size() > 0)
+                        candidates.push_back(std::make_pair((j-i), candidate));
+                }
+
+                if (candidates.empty())
+                    continue; // didn't match enough to disambiguate, on to next character
+
+                // shorter candidates will be added to the vector first. however, we want to check against longer candidates first
+                std::reverse(candidates.begin(), candidates.end());
+
+                for (typename std::vector< std::pair<int, typename Entry::childen_t::iterator> >::iterator it = candidates.begin();
+                     it != candidates.end(); ++it)
+                {
+                    candidate = it->second;
+                    // try to match the rest of the keyword
+                    Point k = i + it->first;
+                    typename string_t::const_iterator t = candidate->second.mKeyword.begin () + (k - i);
+
+
+                    while (k != end && t != candidate->second.mKeyword.end ())
+                    {
+                        if (Misc::StringUtils::toLower (*k) != Misc::StringUtils::toLower (*t))
+                            break;
+
+                        ++k, ++t;
+                    }
+
+                    // didn't match full keyword, try the next candidate
+                    if (t != candidate->second.mKeyword.end ())
+                        continue;
+
+                    // found a keyword, but there might still be longer keywords that start somewhere _within_ this keyword
+                    // we will resolve these overlapping keywords later, choosing the longest one in case of conflict
+                    Match match;
+                    match.mValue = candidate->second.mValue;
+                    match.mBeg = i;
+                    match.mEnd = k;
+                    matches.push_back(match);
+                    break;
+                }
+            }
+
+            // resolve overlapping keywords
+            while (!matches.empty())
+            {
+                int longestKeywordSize = 0;
+                typename std::vector<Match>::iterator longestKeyword = matches.begin();
+                for (typename std::vector<Match>::iterator it = matches.begin(); it != matches.end(); ++it)
+                {
+                    int size = it->mEnd - it->mBeg;
+                    if (size > longestKeywordSize)
+                    {
+                        longestKeywordSize = size;
+                        longestKeyword = it;
+                    }
+
+                    typename std::vector<Match>::iterator next = it;
+                    ++next;
+
+                    if (next == matches.end())
+                        break;
+
+                    if (it->mEnd <= next->mBeg)
+                    {
+                        break; // no overlap
+                    }
+                }
+
+                Match keyword = *longestKeyword;
+                matches.erase(longestKeyword);
+                out.push_back(keyword);
+                // erase anything that overlaps with the keyword we just added to the output
+                for (typename std::vector<Match>::iterator it = matches.begin(); it != matches.end();)
+                {
+                    if (it->mBeg < keyword.mEnd && it->mEnd > keyword.mBeg)
+                        it = matches.erase(it);
+                    else
+                        ++it;
+                }
+            }
+
+            std::sort(out.begin(), out.end(), sortMatches);
+        }
+
+    private:
+
+        struct Entry
+        {
+            typedef std::map <wchar_t, Entry> childen_t;
+
+            string_t mKeyword;
+            value_t mValue;
+            childen_t mChildren;
+        };
+
+        void seed_impl (string_t keyword, value_t value, size_t depth, Entry  & entry)
+        {
+            int ch = Misc::StringUtils::toLower (keyword.at (depth));
+
+            typename Entry::childen_t::iterator j = entry.mChildren.find (ch);
+
+            if (j == entry.mChildren.end ())
+            {
+                entry.mChildren [ch].mValue = /*std::move*/ (value);
+                entry.mChildren [ch].mKeyword = /*std::move*/ (keyword);
+            }
+            else
+            {
+                if (j->second.mKeyword.size () > 0)
+                {
+                    if (keyword == j->second.mKeyword)
+                        throw std::runtime_error ("duplicate keyword inserted");
+
+                    value_t pushValue = /*std::move*/ (j->second.mValue);
+                    string_t pushKeyword = /*std::move*/ (j->second.mKeyword);
+
+                    if (depth >= pushKeyword.size ())
+                        throw std::runtime_error ("unexpected");
+
+                    if (depth+1 < pushKeyword.size())
+                    {
+                        seed_impl (/*std::move*/ (pushKeyword), /*std::move*/ (pushValue), depth+1, j->second);
+                        j->second.mKeyword.clear ();
+                    }
+                }
+                if (depth+1 == keyword.size())
+                    j->second.mKeyword = value;
+                else // depth+1 < keyword.size()
+                    seed_impl (/*std::move*/ (keyword), /*std::move*/ (value), depth+1, j->second);
+            }
+
+        }
+
+        Entry mRoot;
+    };
+}
+
+TEST_F(KeywordSearchTest, keyword_test_equivalent_to_naive_search)
+{
+    for (unsigned int seed = 0; seed < 20; ++seed)
+    {
+        RandomTopics topics(seed, 10 + seed * 10, 20, 40);
+
+        Search search;
+        for (size_t i = 0; i < topics.mKeywords.size(); ++i)
+            search.seed(topics.mKeywords[i], static_cast<int>(i));
+
+        for (std::vector<std::string>::const_iterator text = topics.mTexts.begin(); text != topics.mTexts.end(); ++text)
+        {
+            std::vector<Search::Match> matches;
+            search.highlightKeywords(text->begin(), text->end(), matches);
+
+            std::vector<Search::Match> expected = highlightKeywordsNaive(topics.mKeywords, *text);
+
+            ASSERT_EQ(expected.size(), matches.size()) << *text;
+            for (size_t i = 0; i < expected.size(); ++i)
+            {
+                EXPECT_EQ(expected[i].mBeg - text->begin(), matches[i].mBeg - text->begin()) << *text;
+                EXPECT_EQ(expected[i].mEnd - text->begin(), matches[i].mEnd - text->begin()) << *text;
+                EXPECT_EQ(expected[i].mValue, matches[i].mValue) << *text;
+            }
+        }
+
+        for (size_t i = 0; i < topics.mKeywords.size(); ++i)
+        {
+            int value = -1;
+            EXPECT_TRUE(search.containsKeyword(topics.mKeywords[i], value));
+            EXPECT_EQ(static_cast<int>(i), value);
+        }
+    }
+}
+
+// Highlights dialogue responses against a number of topics comparable to all dialogue IDs of the
+// Morrowind content files, which is what the hypertext parser searches through, and compares with the old trie.
+// Only prints timings, so it is disabled by default; run it with --gtest_also_run_disabled_tests.
+TEST_F(KeywordSearchTest, DISABLED_keyword_test_benchmark)
+{
+    RandomTopics topics(42, 3000, 2000, 60);
+
+    std::vector<std::string> sortedKeywords = topics.mKeywords;
+    std::sort(sortedKeywords.begin(), sortedKeywords.end(), Misc::StringUtils::ciLess);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Search search;
+    for (size_t i = 0; i < sortedKeywords.size(); ++i)
+        search.seed(sortedKeywords[i], static_cast<int>(i));
+    int value;
+    search.containsKeyword(sortedKeywords.front(), value);
+    std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    TrieKeywordSearch<std::string, int> trie;
+    for (size_t i = 0; i < sortedKeywords.size(); ++i)
+        trie.seed(sortedKeywords[i], static_cast<int>(i));
+    std::chrono::duration<double, std::milli> trieBuildTime = std::chrono::steady_clock::now() - start;
+
+    size_t characters = 0;
+    size_t numMatches = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::vector<std::string>::const_iterator text = topics.mTexts.begin(); text != topics.mTexts.end(); ++text)
+    {
+        std::vector<Search::Match> matches;
+        search.highlightKeywords(text->begin(), text->end(), matches);
+        characters += text->size();
+        numMatches += matches.size();
+    }
+    std::chrono::duration<double, std::milli> searchTime = std::chrono::steady_clock::now() - start;
+
+    size_t trieMatches = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::vector<std::string>::const_iterator text = topics.mTexts.begin(); text != topics.mTexts.end(); ++text)
+    {
+        std::vector<TrieKeywordSearch<std::string, int>::Match> matches;
+        trie.highlightKeywords(text->begin(), text->end(), matches);
+        trieMatches += matches.size();
+    }
+    std::chrono::duration<double, std::milli> trieSearchTime = std::chrono::steady_clock::now() - start;
+
+    EXPECT_GT(numMatches, 0u);
+
+    std::cout << topics.mKeywords.size() << " keywords, " << topics.mTexts.size() << " texts (" << characters
+              << " characters)" << std::endl;
+    std::cout << "automaton: built in " << buildTime.count() << " ms, searched in " << searchTime.count() << " ms, "
+              << numMatches << " matches" << std::endl;
+    // the trie misses one-character keywords when the text goes on along a longer keyword, e.g. "a" in "a dwemer"
+    std::cout << "trie: built in " << trieBuildTime.count() << " ms, searched in " << trieSearchTime.count() << " ms, "
+              << trieMatches << " matches" << std::endl;
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "apps/openmw/mwmechanics/spatialgrid.hpp"
+
+namespace
+{
+    using MWMechanics::SpatialGrid;
+
+    const float cellSize = 2048;
+
+    struct SpatialGridTest : public ::testing::Test
+    {
+        std::mt19937 mRandom;
+        std::vector<osg::Vec3f> mPositions;
+        SpatialGrid<int> mGrid;
+
+        SpatialGridTest()
+            : mRandom(42)
+            , mGrid(cellSize)
+        {
+        }
+
+        float random(float min, float max)
+        {
+            return std::uniform_real_distribution<float>(min, max)(mRandom);
+        }
+
+        /// Scatter actors over a few exterior cells on both sides of the origin
+        void build(int numActors)
+        {
+            mPositions.clear();
+            mGrid.clear();
+            for (int i = 0; i < numActors; ++i)
+            {
+                mPositions.push_back(osg::Vec3f(random(-20000, 20000), random(-20000, 20000), random(-500, 500)));
+                mGrid.insert(i, mPositions.back());
+            }
+            mGrid.build();
+        }
+
+        std::vector<int> bruteForce(const osg::Vec3f& position, float radius) const
+        {
+            std::vector<int> result;
+            for (std::size_t i = 0; i < mPositions.size(); ++i)
+                if ((mPositions[i] - position).length2() <= radius * radius)
+                    result.push_back(static_cast<int>(i));
+            return result;
+        }
+
+        std::vector<int> query(const osg::Vec3f& position, float radius) const
+        {
+            std::vector<int> result;
+            mGrid.getInRange(position, radius, result);
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+    };
+}
+
+TEST_F(SpatialGridTest, empty_grid_should_find_nothing)
+{
+    build(0);
+    EXPECT_TRUE(query(osg::Vec3f(0, 0, 0), 1e6f).empty());
+}
+
+TEST_F(SpatialGridTest, should_find_same_objects_as_brute_force)
+{
+    build(1000);
+    const float radii[] = { 0.f, 100.f, 400.f, cellSize, 5000.f, 8192.f * 50 };
+    for (int test = 0; test < 200; ++test)
+    {
+        osg::Vec3f position (random(-25000, 25000), random(-25000, 25000), random(-500, 500));
+        for (std::size_t i = 0; i < sizeof(radii) / sizeof(radii[0]); ++i)
+            EXPECT_EQ(bruteForce(position, radii[i]), query(position, radii[i])) << "radius " << radii[i];
+    }
+}
+
+TEST_F(SpatialGridTest, should_find_objects_on_cell_borders)
+{
+    const osg::Vec3f positions[] = {
+        osg::Vec3f(0, 0, 0), osg::Vec3f(-cellSize, 0, 0), osg::Vec3f(cellSize, -cellSize, 0), osg::Vec3f(-0.001f, -0.001f, 0)
+    };
+    mGrid.clear();
+    for (int i = 0; i < 4; ++i)
+    {
+        mPositions.push_back(positions[i]);
+        mGrid.insert(i, positions[i]);
+    }
+    mGrid.build();
+
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(bruteForce(positions[i], 0.f), query(positions[i], 0.f));
+        EXPECT_EQ(bruteForce(positions[i], cellSize), query(positions[i], cellSize));
+    }
+}
+
+TEST_F(SpatialGridTest, rebuild_should_forget_previous_positions)
+{
+    build(100);
+    build(10);
+    EXPECT_EQ(10u, mGrid.size());
+    EXPECT_EQ(bruteForce(osg::Vec3f(0, 0, 0), 1e6f), query(osg::Vec3f(0, 0, 0), 1e6f));
+}
+
+TEST_F(SpatialGridTest, neighbour_queries_should_match_brute_force)
+{
+    const int numActors = 2000;
+    const float radius = 400;
+    build(numActors);
+
+    for (int i = 0; i < numActors; ++i)
+        EXPECT_EQ(bruteForce(mPositions[i], radius), query(mPositions[i], radius));
+}
+
+TEST_F(SpatialGridTest, covers_all_only_when_query_reaches_every_object)
+{
+    build(0);
+    EXPECT_TRUE(mGrid.coversAll(osg::Vec3f(0, 0, 0), 0.f));
+
+    build(1000);
+    EXPECT_TRUE(mGrid.coversAll(osg::Vec3f(0, 0, 0), 8192.f * 50));
+    EXPECT_TRUE(mGrid.coversAll(osg::Vec3f(10000, -10000, 0), 30000.f));
+    EXPECT_FALSE(mGrid.coversAll(osg::Vec3f(0, 0, 0), 5000.f));
+    EXPECT_FALSE(mGrid.coversAll(osg::Vec3f(30000, 0, 0), 30000.f));
+}
+
+// Only prints timings, so it is disabled by default; run it with --gtest_also_run_disabled_tests.
+TEST_F(SpatialGridTest, DISABLED_neighbour_queries_benchmark)
+{
+    const int numActors = 2000;
+    const float radius = 400;
+    build(numActors);
+
+    std::size_t bruteForceFound = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < numActors; ++i)
+        bruteForceFound += bruteForce(mPositions[i], radius).size();
+    std::chrono::duration<double, std::milli> bruteForceTime = std::chrono::steady_clock::now() - start;
+
+    // Including the rebuild, which update() does every frame
+    std::size_t gridFound = 0;
+    start = std::chrono::steady_clock::now();
+    mGrid.clear();
+    for (int i = 0; i < numActors; ++i)
+        mGrid.insert(i, mPositions[i]);
+    mGrid.build();
+    for (int i = 0; i < numActors; ++i)
+        gridFound += query(mPositions[i], radius).size();
+    std::chrono::duration<double, std::milli> gridTime = std::chrono::steady_clock::now() - start;
+
+    std::cout << numActors << " actors, radius " << radius << ": brute force " << bruteForceTime.count() << " ms ("
+              << bruteForceFound << " found), grid " << gridTime.count() << " ms (" << gridFound << " found)" << std::endl;
+}
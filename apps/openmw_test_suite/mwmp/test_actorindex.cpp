@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "apps/openmw/mwmp/ActorIndex.hpp"
+
+namespace
+{
+    struct TestCell
+    {
+    };
+
+    const int numCells = 9;
+    const int numActors = 500;
+    const int numFrames = 200;
+
+    struct TestActor
+    {
+        unsigned int mRefNum;
+        unsigned int mMpNum;
+        int mCell;
+    };
+
+    std::vector<TestActor> makeActors()
+    {
+        // Mix actors from content files (refNum only) with server-spawned ones (mpNum only)
+        std::vector<TestActor> actors;
+        for (int i = 0; i < numActors; ++i)
+        {
+            TestActor actor;
+            actor.mRefNum = (i % 3 == 0) ? 0 : 100000 + i * 7;
+            actor.mMpNum = (i % 3 == 0) ? 1 + i : 0;
+            actor.mCell = i % numCells;
+            actors.push_back(actor);
+        }
+        return actors;
+    }
+
+    // The actors of a cell, as mwmp::Cell holds them in localActors
+    struct BenchmarkCell
+    {
+        std::unordered_map<mwmp::ActorIndex, const TestActor *> mActors;
+    };
+
+    // The string keyed scheme CellController used before ActorIndex: "refNum-mpNum" actor indexes mapped to
+    // cell descriptions, which are then looked up in the initialized cells
+    struct StringBenchmarkCell
+    {
+        std::map<std::string, const TestActor *> mActors;
+    };
+
+    std::string generateMapIndex(int refNum, int mpNum)
+    {
+        std::string mapIndex = "";
+        mapIndex = Utils::toString(refNum) + "-" + Utils::toString(mpNum);
+        return mapIndex;
+    }
+
+    std::string getCellDescription(int cell)
+    {
+        return Utils::toString(cell % 3 - 1) + ", " + Utils::toString(cell / 3 - 1);
+    }
+}
+
+TEST(ActorIndexTest, actor_index_should_round_trip_refnum_and_mpnum)
+{
+    mwmp::ActorIndex index = mwmp::generateActorIndex(123456, 789);
+    EXPECT_EQ(123456u, mwmp::getActorIndexRefNum(index));
+    EXPECT_EQ(789u, mwmp::getActorIndexMpNum(index));
+
+    index = mwmp::generateActorIndex(0xFFFFFFFF, 0xFFFFFFFF);
+    EXPECT_EQ(0xFFFFFFFFu, mwmp::getActorIndexRefNum(index));
+    EXPECT_EQ(0xFFFFFFFFu, mwmp::getActorIndexMpNum(index));
+}
+
+TEST(ActorIndexTest, actor_index_should_not_mix_up_refnum_and_mpnum)
+{
+    EXPECT_NE(mwmp::generateActorIndex(1, 0), mwmp::generateActorIndex(0, 1));
+    EXPECT_NE(mwmp::generateActorIndex(12, 3), mwmp::generateActorIndex(1, 23));
+}
+
+TEST(ActorIndexTest, actor_index_description_should_match_string_index)
+{
+    EXPECT_EQ("5-0", mwmp::getActorIndexDescription(mwmp::generateActorIndex(5, 0)));
+    EXPECT_EQ("0-42", mwmp::getActorIndexDescription(mwmp::generateActorIndex(0, 42)));
+}
+
+TEST(ActorIndexTest, actor_records_should_follow_actors_between_cells)
+{
+    TestCell first, second;
+    mwmp::ActorCellRecords<TestCell> records;
+    const mwmp::ActorIndex actor = mwmp::generateActorIndex(5, 0);
+
+    records.set(actor, &first);
+    EXPECT_EQ(&first, records.get(actor));
+
+    records.set(actor, &second);
+    EXPECT_EQ(&second, records.get(actor));
+    EXPECT_EQ(1u, records.size());
+
+    records.remove(actor);
+    EXPECT_FALSE(records.has(actor));
+    EXPECT_THROW(records.get(actor), std::out_of_range);
+}
+
+TEST(ActorIndexTest, removing_cell_should_drop_only_its_records)
+{
+    TestCell removed, kept;
+    mwmp::ActorCellRecords<TestCell> records;
+
+    for (unsigned int i = 1; i <= 10; ++i)
+        records.set(mwmp::generateActorIndex(i, 0), i % 2 ? &removed : &kept);
+    records.set(mwmp::generateActorIndex(0, 1), &removed);
+
+    records.removeCell(&removed);
+
+    EXPECT_EQ(5u, records.size());
+    EXPECT_FALSE(records.has(mwmp::generateActorIndex(0, 1)));
+    for (unsigned int i = 1; i <= 10; ++i)
+    {
+        const mwmp::ActorIndex actor = mwmp::generateActorIndex(i, 0);
+        if (i % 2)
+            EXPECT_FALSE(records.has(actor));
+        else
+            EXPECT_EQ(&kept, records.get(actor));
+    }
+}
+
+// Looks up every actor of 9 cells once per frame, the way Actors::update() asks CellController::isLocalActor() and
+// getLocalActor() about them, with ActorCellRecords and with the old string keys. Only prints timings, so it is
+// disabled by default; run it with --gtest_also_run_disabled_tests.
+TEST(ActorIndexTest, DISABLED_actor_lookup_benchmark)
+{
+    const std::vector<TestActor> actors = makeActors();
+
+    std::map<std::string, std::string> stringActorsToCells;
+    std::map<std::string, StringBenchmarkCell> stringCells;
+
+    mwmp::ActorCellRecords<BenchmarkCell> actorsToCells;
+    std::vector<BenchmarkCell> cells(numCells);
+
+    for (std::vector<TestActor>::const_iterator it = actors.begin(); it != actors.end(); ++it)
+    {
+        std::string mapIndex = generateMapIndex(it->mRefNum, it->mMpNum);
+        std::string cellDescription = getCellDescription(it->mCell);
+        stringActorsToCells[mapIndex] = cellDescription;
+        stringCells[cellDescription].mActors[mapIndex] = &*it;
+
+        mwmp::ActorIndex actorIndex = mwmp::generateActorIndex(it->mRefNum, it->mMpNum);
+        actorsToCells.set(actorIndex, &cells[it->mCell]);
+        cells[it->mCell].mActors[actorIndex] = &*it;
+    }
+
+    size_t stringFound = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        for (std::vector<TestActor>::const_iterator it = actors.begin(); it != actors.end(); ++it)
+        {
+            if (stringActorsToCells.count(generateMapIndex(it->mRefNum, it->mMpNum)) == 0)
+                continue;
+
+            std::string mapIndex = generateMapIndex(it->mRefNum, it->mMpNum);
+            std::string cellDescription = stringActorsToCells.at(mapIndex);
+            if (stringCells.at(cellDescription).mActors.at(mapIndex) == &*it)
+                ++stringFound;
+        }
+    }
+    std::chrono::duration<double, std::milli> stringTime = std::chrono::steady_clock::now() - start;
+
+    size_t found = 0;
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        for (std::vector<TestActor>::const_iterator it = actors.begin(); it != actors.end(); ++it)
+        {
+            if (!actorsToCells.has(mwmp::generateActorIndex(it->mRefNum, it->mMpNum)))
+                continue;
+
+            mwmp::ActorIndex actorIndex = mwmp::generateActorIndex(it->mRefNum, it->mMpNum);
+            if (actorsToCells.get(actorIndex)->mActors.at(actorIndex) == &*it)
+                ++found;
+        }
+    }
+    std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+
+    std::cout << numActors << " actors in " << numCells << " cells, " << numFrames << " frames: string keys "
+              << stringTime.count() << " ms (" << stringFound << " found), ActorCellRecords " << time.count()
+              << " ms (" << found << " found)" << std::endl;
+}
@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "apps/openmw/mwphysics/parallelmovement.hpp"
+
+namespace
+{
+    using MWPhysics::ParallelMovement;
+
+    const float sCellSize = 8192;
+    const int sNumSubSteps = 8;
+
+    osg::BoundingBox boxAt(const osg::Vec3f& center, const osg::Vec3f& halfExtents)
+    {
+        return osg::BoundingBox(center - halfExtents, center + halfExtents);
+    }
+
+    bool overlaps(const osg::BoundingBox& a, const osg::BoundingBox& b)
+    {
+        return a.xMin() < b.xMax() && b.xMin() < a.xMax() && a.yMin() < b.yMax() && b.yMin() < a.yMax()
+                && a.zMin() < b.zMax() && b.zMin() < a.zMax();
+    }
+
+    /// A cell with box shaped obstacles and actors, standing in for the collision world and MovementSolver.
+    /// Actors walk towards their target until they would overlap an obstacle or another actor, and then slow down for the
+    /// next frame. Collision queries scan all boxes, like a world without a broadphase.
+    struct Crowd : public ParallelMovement::Mover
+    {
+        std::vector<osg::BoundingBox> mObstacles;
+
+        osg::Vec3f mHalfExtents;
+        std::vector<osg::BoundingBox> mActors; ///< The collision objects of the actors
+        std::vector<osg::Vec3f> mVelocities;
+        float mTime;
+
+        std::vector<float> mSpeedFactors; ///< Actor state that move() reads and writes
+        std::vector<float> mSpeedFactorsBeforeMove;
+        std::vector<osg::Vec3f> mResults;
+
+        Crowd(unsigned int numActors, unsigned int numObstacles, float area, unsigned int seed)
+            : mHalfExtents(30, 30, 64)
+            , mTime(1/60.f)
+        {
+            std::mt19937 random (seed);
+            std::uniform_real_distribution<float> position (-area / 2, area / 2);
+            std::uniform_real_distribution<float> direction (-1, 1);
+
+            for (unsigned int i = 0; i < numObstacles; ++i)
+                mObstacles.push_back(boxAt(osg::Vec3f(position(random), position(random), 64), osg::Vec3f(80, 80, 100)));
+
+            while (mActors.size() < numActors)
+            {
+                osg::BoundingBox box = boxAt(osg::Vec3f(position(random), position(random), 64), mHalfExtents);
+                if (blocked(box, mActors.size()))
+                    continue;
+                mActors.push_back(box);
+                osg::Vec3f velocity (direction(random), direction(random), 0);
+                velocity.normalize();
+                mVelocities.push_back(velocity * 6000); // fast enough to bump into each other within a few frames
+            }
+            mSpeedFactors.resize(numActors, 1.f);
+            mSpeedFactorsBeforeMove.resize(numActors);
+            mResults.resize(numActors);
+        }
+
+        bool blocked(const osg::BoundingBox& box, std::size_t self) const
+        {
+            for (std::size_t i = 0; i < mObstacles.size(); ++i)
+                if (overlaps(box, mObstacles[i]))
+                    return true;
+            for (std::size_t i = 0; i < mActors.size(); ++i)
+                if (i != self && overlaps(box, mActors[i]))
+                    return true;
+            return false;
+        }
+
+        virtual void move(std::size_t index)
+        {
+            mSpeedFactorsBeforeMove[index] = mSpeedFactors[index];
+            const osg::Vec3f start = mActors[index].center();
+            const osg::Vec3f step = mVelocities[index] * (mSpeedFactors[index] * mTime / sNumSubSteps);
+            osg::Vec3f position = start;
+            mSpeedFactors[index] = 1.f;
+            for (int i = 1; i <= sNumSubSteps; ++i)
+            {
+                osg::Vec3f next = start + step * static_cast<float>(i);
+                if (blocked(boxAt(next, mHalfExtents), index))
+                {
+                    mSpeedFactors[index] = 0.5f;
+                    break;
+                }
+                position = next;
+            }
+            mResults[index] = position;
+        }
+
+        virtual void moveAgain(std::size_t index)
+        {
+            mSpeedFactors[index] = mSpeedFactorsBeforeMove[index];
+            move(index);
+        }
+
+        virtual void apply(std::size_t index)
+        {
+            mActors[index] = boxAt(mResults[index], mHalfExtents);
+        }
+
+        virtual osg::BoundingBox getBounds(std::size_t index) const
+        {
+            return mActors[index];
+        }
+
+        virtual osg::BoundingBox getReach(std::size_t index) const
+        {
+            osg::BoundingBox reach = mActors[index];
+            reach.expandBy(boxAt(mActors[index].center() + mVelocities[index] * (mSpeedFactors[index] * mTime), mHalfExtents));
+            return reach;
+        }
+
+        /// Move the actors one after another, like PhysicsSystem does without movement threads
+        void moveSerially()
+        {
+            for (std::size_t i = 0; i < mActors.size(); ++i)
+            {
+                move(i);
+                apply(i);
+            }
+        }
+
+        bool hasOverlappingActors() const
+        {
+            for (std::size_t i = 0; i < mActors.size(); ++i)
+                for (std::size_t j = i + 1; j < mActors.size(); ++j)
+                    if (overlaps(mActors[i], mActors[j]))
+                        return true;
+            return false;
+        }
+    };
+
+    void expectSameActors(const Crowd& expected, const Crowd& actual)
+    {
+        ASSERT_EQ(expected.mActors.size(), actual.mActors.size());
+        for (std::size_t i = 0; i < expected.mActors.size(); ++i)
+        {
+            EXPECT_EQ(expected.mActors[i]._min, actual.mActors[i]._min) << "actor " << i;
+            EXPECT_EQ(expected.mActors[i]._max, actual.mActors[i]._max) << "actor " << i;
+            EXPECT_EQ(expected.mSpeedFactors[i], actual.mSpeedFactors[i]) << "actor " << i;
+        }
+    }
+}
+
+TEST(ParallelMovementTest, should_give_same_results_as_moving_actors_one_after_another)
+{
+    const int threads[] = { 1, 2, 4 };
+    for (unsigned int t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t)
+    {
+        ParallelMovement parallelMovement (threads[t]);
+        Crowd serial (200, 20, 2048, 7);
+        Crowd parallel (200, 20, 2048, 7);
+
+        std::size_t movedAgain = 0;
+        for (int frame = 0; frame < 60; ++frame)
+        {
+            serial.moveSerially();
+            movedAgain += parallelMovement.move(parallel, parallel.mActors.size());
+            expectSameActors(serial, parallel);
+            if (HasFailure())
+                return;
+        }
+        EXPECT_FALSE(parallel.hasOverlappingActors());
+
+        // Otherwise the scene does not test anything
+        EXPECT_GT(movedAgain, 0u);
+        EXPECT_LT(movedAgain, 60u * parallel.mActors.size());
+    }
+}
+
+TEST(ParallelMovementTest, should_rethrow_errors_of_worker_threads)
+{
+    struct FailingCrowd : public Crowd
+    {
+        FailingCrowd() : Crowd(10, 0, 2048, 1) {}
+
+        virtual void move(std::size_t index)
+        {
+            if (index == 5)
+                throw std::runtime_error("actor 5 failed");
+            Crowd::move(index);
+        }
+    };
+
+    ParallelMovement parallelMovement (2);
+    FailingCrowd crowd;
+    EXPECT_THROW(parallelMovement.move(crowd, crowd.mActors.size()), std::runtime_error);
+}
+
+// Only prints timings, so it is disabled by default; run it with --gtest_also_run_disabled_tests.
+TEST(ParallelMovementTest, DISABLED_crowd_in_one_cell_benchmark)
+{
+    const int numFrames = 100;
+    const unsigned int actorCounts[] = { 100, 200, 300 };
+    for (unsigned int a = 0; a < sizeof(actorCounts) / sizeof(actorCounts[0]); ++a)
+    {
+        Crowd serial (actorCounts[a], 100, sCellSize, 3);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < numFrames; ++frame)
+            serial.moveSerially();
+        std::chrono::duration<double, std::milli> serialTime = std::chrono::steady_clock::now() - start;
+        std::cout << actorCounts[a] << " actors: serial " << serialTime.count() / numFrames << " ms per frame";
+
+        const int threads[] = { 1, 2, 4 };
+        for (unsigned int t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t)
+        {
+            ParallelMovement parallelMovement (threads[t]);
+            Crowd parallel (actorCounts[a], 100, sCellSize, 3);
+            std::size_t movedAgain = 0;
+            start = std::chrono::steady_clock::now();
+            for (int frame = 0; frame < numFrames; ++frame)
+                movedAgain += parallelMovement.move(parallel, parallel.mActors.size());
+            std::chrono::duration<double, std::milli> parallelTime = std::chrono::steady_clock::now() - start;
+
+            expectSameActors(serial, parallel);
+            std::cout << ", " << threads[t] << " threads " << parallelTime.count() / numFrames << " ms ("
+                      << movedAgain / static_cast<double>(numFrames) << " moved again)";
+        }
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "apps/openmw/mwworld/refindex.hpp"
+
+namespace
+{
+    struct Ref
+    {
+        std::string mId;
+        bool mAccessible;
+    };
+
+    bool isAccessible(const Ref* ref)
+    {
+        return ref->mAccessible;
+    }
+
+    /// Mirrors the full scan the index replaces
+    const Ref* scan(const std::vector<Ref>& refs, const std::string& id)
+    {
+        for (std::vector<Ref>::const_iterator it = refs.begin(); it != refs.end(); ++it)
+            if (it->mId == id && it->mAccessible)
+                return &*it;
+        return NULL;
+    }
+}
+
+TEST(RefIndexTest, missing_key_should_give_default_ref)
+{
+    MWWorld::RefIndex<std::string, const Ref*> index;
+    EXPECT_EQ(NULL, index.findFirst("chargen boat", isAccessible));
+}
+
+TEST(RefIndexTest, duplicate_ids_should_resolve_in_insertion_order)
+{
+    std::vector<Ref> refs;
+    // Enough duplicates of each ID for a hash table to get the chance to reorder them
+    for (int i = 0; i < 64; ++i)
+    {
+        Ref ref;
+        ref.mId = (i % 2) ? "rat" : "mudcrab";
+        ref.mAccessible = true;
+        refs.push_back(ref);
+    }
+
+    MWWorld::RefIndex<std::string, const Ref*> index;
+    for (std::vector<Ref>::const_iterator it = refs.begin(); it != refs.end(); ++it)
+        index.insert(it->mId, &*it);
+
+    EXPECT_EQ(&refs[0], index.findFirst("mudcrab", isAccessible));
+    EXPECT_EQ(&refs[1], index.findFirst("rat", isAccessible));
+}
+
+TEST(RefIndexTest, duplicate_ids_should_skip_inaccessible_refs_like_a_scan)
+{
+    std::vector<Ref> refs;
+    const char* ids[] = { "rat", "guard", "rat", "rat", "guard", "chest" };
+    for (int i = 0; i < 6; ++i)
+    {
+        Ref ref;
+        ref.mId = ids[i];
+        ref.mAccessible = true;
+        refs.push_back(ref);
+    }
+
+    MWWorld::RefIndex<std::string, const Ref*> index;
+    for (std::vector<Ref>::const_iterator it = refs.begin(); it != refs.end(); ++it)
+        index.insert(it->mId, &*it);
+
+    // Disable refs one at a time, as deleting references in a cell would
+    for (std::size_t disabled = 0; disabled < refs.size(); ++disabled)
+    {
+        refs[disabled].mAccessible = false;
+        for (int i = 0; i < 6; ++i)
+            EXPECT_EQ(scan(refs, ids[i]), index.findFirst(ids[i], isAccessible)) << ids[i] << " after " << disabled;
+    }
+}
@@ -0,0 +1,423 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "components/sceneutil/skinning.hpp"
+#include "components/sceneutil/workqueue.hpp"
+
+namespace
+{
+    using namespace SceneUtil;
+
+    const unsigned short sNumVertices = 1000;
+
+    struct SkinningTest : public ::testing::Test
+    {
+        std::mt19937 mRandom;
+
+        std::vector<float> mPositions;
+        std::vector<float> mNormals;
+        std::vector<float> mTangents;
+
+        SkinningTest()
+            : mRandom(42)
+        {
+            for (unsigned int i = 0; i < sNumVertices; ++i)
+            {
+                for (unsigned int j = 0; j < 3; ++j)
+                {
+                    mPositions.push_back(random(-100, 100));
+                    mNormals.push_back(random(-1, 1));
+                    mTangents.push_back(random(-1, 1));
+                }
+                mTangents.push_back(i % 2 ? 1.f : -1.f);
+            }
+        }
+
+        float random(float min, float max)
+        {
+            return std::uniform_real_distribution<float>(min, max)(mRandom);
+        }
+
+        /// Affine matrix in OSG's layout, like the skinning matrices RigGeometry computes
+        std::vector<float> randomMatrix()
+        {
+            std::vector<float> matrix (16, 0.f);
+            for (unsigned int row = 0; row < 4; ++row)
+                for (unsigned int col = 0; col < 3; ++col)
+                    matrix[row*4 + col] = row < 3 ? random(-2, 2) : random(-50, 50);
+            matrix[15] = 1.f;
+            return matrix;
+        }
+
+        std::vector<unsigned short> randomIndices()
+        {
+            std::vector<unsigned short> indices;
+            for (unsigned short i = 0; i < sNumVertices; ++i)
+                if (mRandom() % 3 == 0)
+                    indices.push_back(i);
+            return indices;
+        }
+    };
+
+    /// What osg::Matrixf::preMult(const osg::Vec3f&) computes, including the perspective divide
+    void osgPreMult(const float* m, const float* v, float* out)
+    {
+        float d = 1.0f/(m[3]*v[0] + m[7]*v[1] + m[11]*v[2] + m[15]);
+        out[0] = (m[0]*v[0] + m[4]*v[1] + m[8]*v[2] + m[12])*d;
+        out[1] = (m[1]*v[0] + m[5]*v[1] + m[9]*v[2] + m[13])*d;
+        out[2] = (m[2]*v[0] + m[6]*v[1] + m[10]*v[2] + m[14])*d;
+    }
+
+    /// What osg::Matrix::transform3x3(const osg::Vec3f&, const osg::Matrixd&) computes for an osg::Matrixf, in double precision
+    void osgTransform3x3(const float* m, const float* v, float* out)
+    {
+        out[0] = static_cast<float>(double(m[0])*v[0] + double(m[4])*v[1] + double(m[8])*v[2]);
+        out[1] = static_cast<float>(double(m[1])*v[0] + double(m[5])*v[1] + double(m[9])*v[2]);
+        out[2] = static_cast<float>(double(m[2])*v[0] + double(m[6])*v[1] + double(m[10])*v[2]);
+    }
+
+    void expectNear(const float* expected, const float* actual, float tolerance)
+    {
+        for (unsigned int i = 0; i < 3; ++i)
+            EXPECT_NEAR(expected[i], actual[i], tolerance * std::max(1.f, std::abs(expected[i])));
+    }
+
+    /// A double buffered mesh that is translated by (frame, 0, 0) in each frame
+    struct PipelineMesh
+    {
+        std::vector<unsigned short> mIndices;
+        std::vector<float> mSource;
+        std::vector<float> mBuffers[2];
+        float mMatrices[2][16];
+        std::atomic<int> mDrawing[2];
+        osg::ref_ptr<SkinningWork> mWork;
+
+        PipelineMesh(const std::vector<float>& source)
+            : mSource(source)
+            , mWork(new SkinningWork)
+        {
+            for (unsigned short i = 0; i < source.size() / 3; ++i)
+                mIndices.push_back(i);
+            for (unsigned int i = 0; i < 2; ++i)
+            {
+                mBuffers[i].resize(source.size());
+                mDrawing[i] = 0;
+            }
+        }
+    };
+
+    class PipelineWorkItem : public WorkItem
+    {
+    public:
+        PipelineWorkItem(PipelineMesh& mesh, unsigned int frame, std::atomic<int>& violations)
+            : mMesh(mesh)
+            , mBuffer(frame%2)
+            , mViolations(violations)
+        {
+        }
+
+        virtual void doWork()
+        {
+            if (mMesh.mDrawing[mBuffer])
+                ++mViolations;
+            Skinning::transformPositions(mMesh.mMatrices[mBuffer], &mMesh.mIndices[0], mMesh.mIndices.size(),
+                                         &mMesh.mSource[0], &mMesh.mBuffers[mBuffer][0]);
+            if (mMesh.mDrawing[mBuffer])
+                ++mViolations;
+        }
+
+    private:
+        PipelineMesh& mMesh;
+        unsigned int mBuffer;
+        std::atomic<int>& mViolations;
+    };
+
+    /// Runs frames the way osgViewer's DrawThreadPerContext does: the calling thread culls, a draw thread draws the previous frame
+    /// meanwhile, and culling needs one of the renderer's two SceneViews, which are only released once their frame is drawn.
+    class Pipeline
+    {
+    public:
+        Pipeline(std::vector<PipelineMesh*>& meshes, WorkQueue* workQueue, bool verify)
+            : mViolations(0)
+            , mWrongVertices(0)
+            , mMeshes(meshes)
+            , mWorkQueue(workQueue)
+            , mVerify(verify)
+            , mFreeSceneViews(2)
+            , mDone(false)
+            , mDrawThread(&Pipeline::draw, this)
+        {
+        }
+
+        ~Pipeline()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mDone = true;
+            }
+            mCondition.notify_all();
+            mDrawThread.join();
+        }
+
+        void cull(unsigned int frame)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mCondition.wait(lock, [this] { return mFreeSceneViews > 0; });
+                --mFreeSceneViews;
+            }
+
+            for (std::vector<PipelineMesh*>::iterator it = mMeshes.begin(); it != mMeshes.end(); ++it)
+            {
+                PipelineMesh& mesh = **it;
+                mesh.mWork->waitTillDone(frame);
+                float* matrix = mesh.mMatrices[frame%2];
+                std::fill(matrix, matrix + 16, 0.f);
+                matrix[0] = matrix[5] = matrix[10] = matrix[15] = 1.f;
+                matrix[12] = static_cast<float>(frame);
+
+                osg::ref_ptr<PipelineWorkItem> workItem (new PipelineWorkItem(mesh, frame, mViolations));
+                mesh.mWork->start(frame, workItem, mWorkQueue);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mFramesToDraw.push_back(frame);
+            }
+            mCondition.notify_all();
+        }
+
+        void finish()
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this] { return mFreeSceneViews == 2; });
+        }
+
+        std::atomic<int> mViolations;
+        std::atomic<int> mWrongVertices;
+
+    private:
+        void draw()
+        {
+            while (true)
+            {
+                unsigned int frame;
+                {
+                    std::unique_lock<std::mutex> lock(mMutex);
+                    mCondition.wait(lock, [this] { return mDone || !mFramesToDraw.empty(); });
+                    if (mFramesToDraw.empty())
+                        return;
+                    frame = mFramesToDraw.front();
+                    mFramesToDraw.pop_front();
+                }
+
+                for (std::vector<PipelineMesh*>::iterator it = mMeshes.begin(); it != mMeshes.end(); ++it)
+                {
+                    PipelineMesh& mesh = **it;
+                    const unsigned int buffer = frame%2;
+                    mesh.mWork->waitTillDone(frame);
+                    ++mesh.mDrawing[buffer];
+                    for (std::size_t i = 0; mVerify && i < mesh.mSource.size(); i += 3)
+                    {
+                        if (mesh.mBuffers[buffer][i] != mesh.mSource[i] + static_cast<float>(frame)
+                                || mesh.mBuffers[buffer][i+1] != mesh.mSource[i+1]
+                                || mesh.mBuffers[buffer][i+2] != mesh.mSource[i+2])
+                            ++mWrongVertices;
+                    }
+                    --mesh.mDrawing[buffer];
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    ++mFreeSceneViews;
+                }
+                mCondition.notify_all();
+            }
+        }
+
+        std::vector<PipelineMesh*>& mMeshes;
+        WorkQueue* mWorkQueue;
+        bool mVerify;
+
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+        int mFreeSceneViews;
+        std::deque<unsigned int> mFramesToDraw;
+        bool mDone;
+
+        std::thread mDrawThread;
+    };
+
+    void runPipeline(const std::vector<float>& source, WorkQueue* workQueue, unsigned int numMeshes, unsigned int numFrames,
+                     bool verify = true)
+    {
+        std::vector<PipelineMesh*> meshes;
+        for (unsigned int i = 0; i < numMeshes; ++i)
+            meshes.push_back(new PipelineMesh(source));
+
+        {
+            Pipeline pipeline (meshes, workQueue, verify);
+            for (unsigned int frame = 1; frame <= numFrames; ++frame)
+                pipeline.cull(frame);
+            pipeline.finish();
+
+            EXPECT_EQ(0, pipeline.mViolations);
+            EXPECT_EQ(0, pipeline.mWrongVertices);
+        }
+
+        for (unsigned int i = 0; i < numMeshes; ++i)
+        {
+            meshes[i]->mWork->waitTillDone(0);
+            meshes[i]->mWork->waitTillDone(1);
+            delete meshes[i];
+        }
+    }
+}
+
+TEST_F(SkinningTest, transforms_should_match_osg_matrix_transforms)
+{
+    for (unsigned int test = 0; test < 10; ++test)
+    {
+        std::vector<float> matrix = randomMatrix();
+        std::vector<unsigned short> indices = randomIndices();
+
+        std::vector<float> positions (mPositions.size());
+        std::vector<float> normals (mNormals.size());
+        std::vector<float> tangents (mTangents.size());
+        Skinning::transformPositions(&matrix[0], &indices[0], indices.size(), &mPositions[0], &positions[0]);
+        Skinning::transformNormals(&matrix[0], &indices[0], indices.size(), &mNormals[0], &normals[0]);
+        Skinning::transformTangents(&matrix[0], &indices[0], indices.size(), &mTangents[0], &tangents[0]);
+
+        for (std::vector<unsigned short>::const_iterator it = indices.begin(); it != indices.end(); ++it)
+        {
+            const std::size_t i = *it;
+            float expected[3];
+            osgPreMult(&matrix[0], &mPositions[i*3], expected);
+            for (unsigned int j = 0; j < 3; ++j)
+                EXPECT_FLOAT_EQ(expected[j], positions[i*3 + j]);
+
+            osgTransform3x3(&matrix[0], &mNormals[i*3], expected);
+            expectNear(expected, &normals[i*3], 1e-5f);
+
+            osgTransform3x3(&matrix[0], &mTangents[i*4], expected);
+            expectNear(expected, &tangents[i*4], 1e-5f);
+            EXPECT_EQ(mTangents[i*4 + 3], tangents[i*4 + 3]);
+        }
+    }
+}
+
+TEST_F(SkinningTest, transforms_should_only_write_given_vertices)
+{
+    std::vector<unsigned short> indices = randomIndices();
+    std::vector<float> matrix = randomMatrix();
+
+    const float unchanged = 12345.f;
+    std::vector<float> positions (mPositions.size(), unchanged);
+    std::vector<float> tangents (mTangents.size(), unchanged);
+    Skinning::transformPositions(&matrix[0], &indices[0], indices.size(), &mPositions[0], &positions[0]);
+    Skinning::transformTangents(&matrix[0], &indices[0], indices.size(), &mTangents[0], &tangents[0]);
+
+    std::vector<unsigned short>::const_iterator it = indices.begin();
+    for (unsigned short i = 0; i < sNumVertices; ++i)
+    {
+        if (it != indices.end() && *it == i)
+        {
+            ++it;
+            continue;
+        }
+        for (unsigned int j = 0; j < 3; ++j)
+            EXPECT_EQ(unchanged, positions[i*3 + j]);
+        for (unsigned int j = 0; j < 4; ++j)
+            EXPECT_EQ(unchanged, tangents[i*4 + j]);
+    }
+}
+
+TEST_F(SkinningTest, skinning_without_work_queue_should_be_done_before_draw)
+{
+    runPipeline(mPositions, NULL, 20, 200);
+}
+
+TEST_F(SkinningTest, skinning_on_work_queue_should_not_overlap_with_draw_of_same_buffer)
+{
+    osg::ref_ptr<WorkQueue> workQueue (new WorkQueue(3));
+    runPipeline(mPositions, workQueue, 20, 200);
+}
+
+// Only prints timings, so it is disabled by default; run it with --gtest_also_run_disabled_tests.
+TEST_F(SkinningTest, DISABLED_skinning_benchmark)
+{
+    const unsigned int numMeshes = 200;
+    const unsigned int numGroups = 20;
+    std::vector<std::vector<float> > matrices;
+    std::vector<std::vector<unsigned short> > groups;
+    for (unsigned int i = 0; i < numGroups; ++i)
+    {
+        matrices.push_back(randomMatrix());
+        groups.push_back(randomIndices());
+    }
+
+    std::vector<float> positions (mPositions.size());
+    std::vector<float> normals (mNormals.size());
+    std::vector<float> tangents (mTangents.size());
+
+    // The per-vertex code RigGeometry used before: osg::Matrixf::preMult() and osg::Matrix::transform3x3()
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned int mesh = 0; mesh < numMeshes; ++mesh)
+    {
+        for (unsigned int group = 0; group < numGroups; ++group)
+        {
+            const float* matrix = &matrices[group][0];
+            for (std::vector<unsigned short>::const_iterator it = groups[group].begin(); it != groups[group].end(); ++it)
+            {
+                const std::size_t i = *it;
+                osgPreMult(matrix, &mPositions[i*3], &positions[i*3]);
+                osgTransform3x3(matrix, &mNormals[i*3], &normals[i*3]);
+                osgTransform3x3(matrix, &mTangents[i*4], &tangents[i*4]);
+                tangents[i*4 + 3] = mTangents[i*4 + 3];
+            }
+        }
+    }
+    std::chrono::duration<double, std::milli> oldTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned int mesh = 0; mesh < numMeshes; ++mesh)
+    {
+        for (unsigned int group = 0; group < numGroups; ++group)
+        {
+            const float* matrix = &matrices[group][0];
+            const std::vector<unsigned short>& indices = groups[group];
+            Skinning::transformPositions(matrix, &indices[0], indices.size(), &mPositions[0], &positions[0]);
+            Skinning::transformNormals(matrix, &indices[0], indices.size(), &mNormals[0], &normals[0]);
+            Skinning::transformTangents(matrix, &indices[0], indices.size(), &mTangents[0], &tangents[0]);
+        }
+    }
+    std::chrono::duration<double, std::milli> newTime = std::chrono::steady_clock::now() - start;
+
+    std::cout << numMeshes << " meshes of " << numGroups << " vertex groups: per-vertex osg transforms " << oldTime.count()
+              << " ms, Skinning transforms " << newTime.count() << " ms" << std::endl;
+
+    const unsigned int numFrames = 100;
+    const unsigned int threads[] = { 0, 1, 2, 4 };
+    for (unsigned int i = 0; i < sizeof(threads) / sizeof(threads[0]); ++i)
+    {
+        osg::ref_ptr<WorkQueue> workQueue;
+        if (threads[i] > 0)
+            workQueue = new WorkQueue(threads[i]);
+        start = std::chrono::steady_clock::now();
+        runPipeline(mPositions, workQueue, numMeshes, numFrames, false);
+        std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+        std::cout << numFrames << " frames of " << numMeshes << " meshes with " << threads[i] << " skinning threads: "
+                  << time.count() / numFrames << " ms per frame" << std::endl;
+    }
+}
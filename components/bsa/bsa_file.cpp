@@ -24,6 +24,8 @@
 #include "bsa_file.hpp"
 
 #include <cassert>
+#include <cstring>
+#include <algorithm>
 
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem/fstream.hpp>
@@ -62,7 +64,8 @@ void BSAFile::readHeader()
      *
      * ---------- end of directory block -------------
      *
-     * - 8*filenum - hash table block, we currently ignore this
+     * - 8*filenum - hash table block, two 32-bit hashes of the file name
+     *   per file (see getHash())
      *
      * ----------- start of data buffer --------------
      *
@@ -123,47 +126,107 @@ void BSAFile::readHeader()
     // Check our position
     assert(input.tellg() == std::streampos(12+dirsize));
 
+    // Read the hash table
+    std::vector<uint32_t> hashes(2*filenum);
+    input.read(reinterpret_cast<char*>(&hashes[0]), 8*filenum);
+
     // Calculate the offset of the data buffer. All file offsets are
     // relative to this. 12 header bytes + directory + hash table
-    // (skipped)
     size_t fileDataOffset = 12 + dirsize + 8*filenum;
 
     // Set up the the FileStruct table
     files.resize(filenum);
+    lookup.resize(filenum);
     for(size_t i=0;i<filenum;i++)
     {
         FileStruct &fs = files[i];
         fs.fileSize = offsets[i*2];
         fs.offset = offsets[i*2+1] + fileDataOffset;
+        fs.hash = (static_cast<Hash>(hashes[i*2+1]) << 32) | hashes[i*2];
         fs.name = &stringBuf[offsets[2*filenum+i]];
 
         if(fs.offset + fs.fileSize > fsize)
             fail("Archive contains offsets outside itself");
 
         // Add the file name to the lookup
-        lookup[fs.name] = i;
+        lookup[i] = std::make_pair(fs.hash, static_cast<int>(i));
     }
+    std::sort(lookup.begin(), lookup.end());
 
     isLoaded = true;
 }
 
+namespace
+{
+    char normalizeChar(char ch)
+    {
+        return ch == '/' ? '\\' : Misc::StringUtils::toLower(ch);
+    }
+
+    /// Case insensitive comparison that treats forward slashes and backslashes as equal
+    bool namesEqual(const char *name, const char *str, size_t length)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            if (name[i] == '\0' || normalizeChar(name[i]) != normalizeChar(str[i]))
+                return false;
+        }
+        return name[length] == '\0';
+    }
+}
+
+BSAFile::Hash BSAFile::getHash(const char *name, size_t length)
+{
+    size_t half = length / 2;
+    uint32_t sum = 0, off = 0, temp, n;
+    size_t i = 0;
+
+    for (; i < half; ++i)
+    {
+        sum ^= static_cast<uint32_t>(normalizeChar(name[i])) << (off & 0x1F);
+        off += 8;
+    }
+    Hash low = sum;
+
+    for (sum = off = 0; i < length; ++i)
+    {
+        temp = static_cast<uint32_t>(normalizeChar(name[i])) << (off & 0x1F);
+        sum ^= temp;
+        n = temp & 0x1F;
+        // Rotate right by n
+        if (n != 0)
+            sum = (sum << (32 - n)) | (sum >> n);
+        off += 8;
+    }
+
+    return (static_cast<Hash>(sum) << 32) | low;
+}
+
 /// Get the index of a given file name, or -1 if not found
 int BSAFile::getIndex(const char *str) const
 {
-    Lookup::const_iterator it = lookup.find(str);
-    if(it == lookup.end())
-        return -1;
+    size_t length = std::strlen(str);
+    Hash hash = getHash(str, length);
 
-    int res = it->second;
-    assert(res >= 0 && (size_t)res < files.size());
-    return res;
+    Lookup::const_iterator it = std::lower_bound(lookup.begin(), lookup.end(), std::make_pair(hash, 0));
+    for (; it != lookup.end() && it->first == hash; ++it)
+    {
+        int res = it->second;
+        assert(res >= 0 && (size_t)res < files.size());
+        if (namesEqual(files[res].name, str, length))
+            return res;
+    }
+    return -1;
 }
 
 /// Open an archive file.
-void BSAFile::open(const string &file)
+void BSAFile::open(const string &file, bool memoryMapped)
 {
     filename = file;
     readHeader();
+
+    if (memoryMapped)
+        mapping.reset(new Files::MemoryMappedFile(filename.c_str()));
 }
 
 Files::IStreamPtr BSAFile::getFile(const char *file)
@@ -173,12 +236,13 @@ Files::IStreamPtr BSAFile::getFile(const char *file)
     if(i == -1)
         fail("File not found: " + string(file));
 
-    const FileStruct &fs = files[i];
-
-    return Files::openConstrainedFileStream (filename.c_str (), fs.offset, fs.fileSize);
+    return getFile(&files[i]);
 }
 
 Files::IStreamPtr BSAFile::getFile(const FileStruct *file)
 {
+    if (mapping)
+        return Files::openMemoryMappedFileStream (mapping, file->offset, file->fileSize);
+
     return Files::openConstrainedFileStream (filename.c_str (), file->offset, file->fileSize);
 }
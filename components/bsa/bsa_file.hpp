@@ -27,11 +27,11 @@
 #include <stdint.h>
 #include <string>
 #include <vector>
-#include <map>
 
 #include <components/misc/stringops.hpp>
 
 #include <components/files/constrainedfilestream.hpp>
+#include <components/files/memorymappedfile.hpp>
 
 
 namespace Bsa
@@ -43,6 +43,10 @@ namespace Bsa
 class BSAFile
 {
 public:
+    /// Name hash as stored in the archive's hash table. The low 32 bits are
+    /// the hash of the first half of the name, the high 32 bits the second half.
+    typedef uint64_t Hash;
+
     /// Represents one file entry in the archive
     struct FileStruct
     {
@@ -51,6 +55,9 @@ public:
         // (which is what is stored in the archive.)
         uint32_t fileSize, offset;
 
+        // Precomputed hash of the file name, read from the archive
+        Hash hash;
+
         // Zero-terminated file name
         const char *name;
     };
@@ -69,18 +76,14 @@ private:
     /// Used for error messages
     std::string filename;
 
-    /// Case insensitive string comparison
-    struct iltstr
-    {
-        bool operator()(const char *s1, const char *s2) const
-        { return Misc::StringUtils::ciLess(s1, s2); }
-    };
+    /// The whole archive mapped into memory, if opened in memory mapped mode
+    Files::MemoryMappedFilePtr mapping;
 
-    /** A map used for fast file name lookup. The value is the index into
-        the files[] vector above. The iltstr ensures that file name
-        checks are case insensitive.
+    /** A table used for fast file name lookup, sorted by name hash. The
+        second member is the index into the files[] vector above. Since the
+        hash is case insensitive, so are the file name checks.
     */
-    typedef std::map<const char*, int, iltstr> Lookup;
+    typedef std::vector<std::pair<Hash, int> > Lookup;
     Lookup lookup;
 
     /// Error handling
@@ -103,8 +106,19 @@ public:
       : isLoaded(false)
     { }
 
+    /// Compute the archive hash of a file name. Case is folded and forward slashes
+    /// are treated as backslashes, so the result matches the hash stored in the archive.
+    /// @note Thread safe.
+    static Hash getHash(const char *name, size_t length);
+
     /// Open an archive file.
-    void open(const std::string &file);
+    /// @param memoryMapped Map the whole archive into memory once, so opening a file
+    /// returns a stream directly over the mapping instead of reopening the archive.
+    void open(const std::string &file, bool memoryMapped = false);
+
+    /// Is the archive mapped into memory?
+    bool isMemoryMapped() const
+    { return mapping.get() != 0; }
 
     /* -----------------------------------
      * Archive file routines
@@ -0,0 +1,100 @@
+#include "compressedrecords.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include <zlib.h>
+
+#include "esmreader.hpp"
+#include "esmwriter.hpp"
+#include "defs.hpp"
+
+unsigned int ESM::CompressedRecords::sRecordId = ESM::REC_ZBLK;
+const size_t ESM::CompressedRecords::sBlockSize = 1024 * 1024;
+
+namespace
+{
+    // name, size, unused, flags
+    const size_t sRecordHeaderSize = 16;
+
+    /// Size of the record starting at \a offset, including its header
+    size_t getRecordSize (const std::string& records, size_t offset)
+    {
+        if (records.size() - offset < sRecordHeaderSize)
+            throw std::runtime_error ("Truncated record header");
+
+        uint32_t size;
+        std::memcpy (&size, records.data() + offset + 4, sizeof (size));
+
+        if (records.size() - offset - sRecordHeaderSize < size)
+            throw std::runtime_error ("Truncated record");
+
+        return sRecordHeaderSize + size;
+    }
+}
+
+ESM::CompressedRecords::CompressedRecords()
+    : mSize (0)
+{
+}
+
+void ESM::CompressedRecords::load (ESMReader &esm)
+{
+    esm.getHNT (mSize, "SIZE");
+
+    esm.getSubNameIs ("DATA");
+    esm.getSubHeader();
+    mData.resize (esm.getSubSize());
+    if (!mData.empty())
+        esm.getExact (&mData[0], mData.size());
+}
+
+void ESM::CompressedRecords::save (ESMWriter &esm) const
+{
+    esm.writeHNT ("SIZE", mSize);
+
+    esm.startSubRecord ("DATA");
+    if (!mData.empty())
+        esm.write (&mData[0], mData.size());
+    esm.endRecord ("DATA");
+}
+
+void ESM::CompressedRecords::compress (const std::string& records, int level, std::vector<CompressedRecords>& blocks)
+{
+    size_t begin = 0;
+    while (begin < records.size())
+    {
+        size_t end = begin;
+        while (end < records.size() && end - begin < sBlockSize)
+            end += getRecordSize (records, end);
+
+        CompressedRecords block;
+        block.mSize = static_cast<uint32_t> (end - begin);
+
+        uLongf compressedSize = compressBound (block.mSize);
+        block.mData.resize (compressedSize);
+
+        if (compress2 (reinterpret_cast<Bytef*> (&block.mData[0]), &compressedSize,
+                reinterpret_cast<const Bytef*> (records.data() + begin), block.mSize, level) != Z_OK)
+            throw std::runtime_error ("Failed to compress records");
+
+        block.mData.resize (compressedSize);
+        blocks.push_back (block);
+
+        begin = end;
+    }
+}
+
+std::string ESM::CompressedRecords::decompress() const
+{
+    std::string records (mSize, '\0');
+    if (mSize == 0)
+        return records;
+
+    uLongf size = mSize;
+    if (mData.empty() || uncompress (reinterpret_cast<Bytef*> (&records[0]), &size,
+            reinterpret_cast<const Bytef*> (&mData[0]), mData.size()) != Z_OK || size != mSize)
+        throw std::runtime_error ("Failed to decompress records");
+
+    return records;
+}
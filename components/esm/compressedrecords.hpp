@@ -0,0 +1,42 @@
+#ifndef OPENMW_ESM_COMPRESSEDRECORDS_H
+#define OPENMW_ESM_COMPRESSEDRECORDS_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ESM
+{
+    class ESMReader;
+    class ESMWriter;
+
+    /// \brief A group of saved game records, deflated with zlib
+    ///
+    /// Each block holds whole records, so a reader only ever needs to inflate one block at a time
+    /// and can then read the records in it like any others.
+    struct CompressedRecords
+    {
+        static unsigned int sRecordId;
+
+        /// Records are grouped into blocks of at least this many uncompressed bytes
+        static const size_t sBlockSize;
+
+        uint32_t mSize; ///< uncompressed size of the records
+        std::vector<char> mData; ///< deflated records
+
+        CompressedRecords();
+
+        void load (ESMReader &esm);
+        void save (ESMWriter &esm) const;
+
+        /// Split a sequence of serialized records into groups and deflate each of them.
+        ///
+        /// \param level zlib compression level
+        static void compress (const std::string& records, int level, std::vector<CompressedRecords>& blocks);
+
+        /// Inflate the records of this block.
+        std::string decompress() const;
+    };
+}
+
+#endif
@@ -75,6 +75,15 @@ void ESMReader::openRaw(const std::string& filename)
     openRaw(Files::openConstrainedFileStream(filename.c_str()), filename);
 }
 
+void ESMReader::openBlock(Files::IStreamPtr block, const ESMReader &parent)
+{
+    openRaw(block, parent.getName());
+    mHeader = parent.mHeader;
+    setIndex(parent.mIdx);
+    mGlobalReaderList = parent.mGlobalReaderList;
+    mEncoder = parent.mEncoder;
+}
+
 void ESMReader::open(Files::IStreamPtr _esm, const std::string &name)
 {
     openRaw(_esm, name);
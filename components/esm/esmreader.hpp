@@ -73,6 +73,10 @@ public:
 
   void openRaw(const std::string &filename);
 
+  /// Open a block of records that is stored inside the file read by \a parent, e.g. records that
+  /// were decompressed from it. The block shares the header, index and encoder of \a parent.
+  void openBlock(Files::IStreamPtr block, const ESMReader &parent);
+
   /// Get the current position in the file. Make sure that the file has been opened!
   size_t getFileOffset();
 
@@ -80,6 +80,23 @@ namespace ESM
         endRecord("TES3");
     }
 
+    void ESMWriter::startRecords(std::ostream& file)
+    {
+        mRecordCount = 0;
+        mRecords.clear();
+        mCounting = true;
+        mStream = &file;
+    }
+
+    void ESMWriter::writeRawRecord(const std::string& record)
+    {
+        if (!mRecords.empty())
+            throw std::runtime_error ("Can't write a raw record inside another record");
+
+        mRecordCount++;
+        write(record.c_str(), record.size());
+    }
+
     void ESMWriter::close()
     {
         if (!mRecords.empty())
@@ -227,4 +244,9 @@ namespace ESM
     {
         mEncoder = encoder;
     }
+
+    ToUTF8::Utf8Encoder* ESMWriter::getEncoder() const
+    {
+        return mEncoder;
+    }
 }
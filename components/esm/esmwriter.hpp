@@ -34,6 +34,7 @@ class ESMWriter
         void setVersion(unsigned int ver = 0x3fa66666);
         void setType(int type);
         void setEncoder(ToUTF8::Utf8Encoder *encoding);
+        ToUTF8::Utf8Encoder* getEncoder() const;
         void setAuthor(const std::string& author);
         void setDescription(const std::string& desc);
 
@@ -52,6 +53,13 @@ class ESMWriter
         void save(std::ostream& file);
         ///< Start saving a file by writing the TES3 header.
 
+        void startRecords(std::ostream& file);
+        ///< Start writing records to a stream without a TES3 header, e.g. to serialize a single record
+        /// that is copied into a file later with writeRawRecord().
+
+        void writeRawRecord(const std::string& record);
+        ///< Write a complete record that was serialized previously. Counts as one record.
+
         void close();
         ///< \note Does not close the stream.
 
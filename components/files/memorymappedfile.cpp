@@ -0,0 +1,175 @@
+#include "memorymappedfile.hpp"
+
+#include <stdexcept>
+#include <sstream>
+
+#include "memorystream.hpp"
+
+#if FILE_API == FILE_API_POSIX
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#elif FILE_API == FILE_API_WIN32
+#include <boost/locale.hpp>
+#endif
+
+namespace
+{
+    /// A memory stream that keeps the mapping it reads from alive
+    class MemoryMappedFileStream : public Files::IMemStream
+    {
+    public:
+        MemoryMappedFileStream(const Files::MemoryMappedFilePtr& file, size_t start, size_t length)
+            : Files::MemBuf(file->getData() + start, length)
+            , Files::IMemStream(file->getData() + start, length)
+            , mFile(file)
+        {
+        }
+
+    private:
+        Files::MemoryMappedFilePtr mFile;
+    };
+}
+
+namespace Files
+{
+
+#if FILE_API == FILE_API_STDIO
+
+    MemoryMappedFile::MemoryMappedFile(const char *filename)
+        : mData(0)
+        , mSize(0)
+    {
+        LowLevelFile file;
+        file.open(filename);
+        mBuffer.resize(file.size());
+        if (!mBuffer.empty())
+            file.read(&mBuffer[0], mBuffer.size());
+        mData = mBuffer.empty() ? 0 : &mBuffer[0];
+        mSize = mBuffer.size();
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+    }
+
+#elif FILE_API == FILE_API_POSIX
+
+    MemoryMappedFile::MemoryMappedFile(const char *filename)
+        : mData(0)
+        , mSize(0)
+    {
+#ifdef O_BINARY
+        static const int openFlags = O_RDONLY | O_BINARY;
+#else
+        static const int openFlags = O_RDONLY;
+#endif
+
+        int handle = ::open(filename, openFlags, 0);
+        if (handle == -1)
+        {
+            std::ostringstream os;
+            os << "Failed to open '" << filename << "' for reading: " << strerror(errno);
+            throw std::runtime_error(os.str());
+        }
+
+        struct stat info;
+        if (::fstat(handle, &info) == -1)
+        {
+            std::ostringstream os;
+            os << "An fstat() call on '" << filename << "' failed: " << strerror(errno);
+            ::close(handle);
+            throw std::runtime_error(os.str());
+        }
+        mSize = info.st_size;
+
+        if (mSize > 0)
+        {
+            void* data = ::mmap(0, mSize, PROT_READ, MAP_PRIVATE, handle, 0);
+            if (data == MAP_FAILED)
+            {
+                std::ostringstream os;
+                os << "Failed to map '" << filename << "' into memory: " << strerror(errno);
+                ::close(handle);
+                throw std::runtime_error(os.str());
+            }
+            mData = static_cast<const char*>(data);
+        }
+
+        // The mapping stays valid after the descriptor is closed
+        ::close(handle);
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        if (mData)
+            ::munmap(const_cast<char*>(mData), mSize);
+    }
+
+#elif FILE_API == FILE_API_WIN32
+
+    MemoryMappedFile::MemoryMappedFile(const char *filename)
+        : mData(0)
+        , mSize(0)
+        , mFileHandle(INVALID_HANDLE_VALUE)
+        , mMappingHandle(0)
+    {
+        std::wstring wname = boost::locale::conv::utf_to_utf<wchar_t>(filename);
+        mFileHandle = CreateFileW(wname.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, 0, 0);
+        if (mFileHandle == INVALID_HANDLE_VALUE)
+        {
+            std::ostringstream os;
+            os << "Failed to open '" << filename << "' for reading.";
+            throw std::runtime_error(os.str());
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(mFileHandle, &size))
+        {
+            CloseHandle(mFileHandle);
+            throw std::runtime_error("A query operation on a file failed.");
+        }
+        mSize = static_cast<size_t>(size.QuadPart);
+
+        if (mSize > 0)
+        {
+            mMappingHandle = CreateFileMappingW(mFileHandle, 0, PAGE_READONLY, 0, 0, 0);
+            if (mMappingHandle)
+                mData = static_cast<const char*>(MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0));
+
+            if (!mData)
+            {
+                if (mMappingHandle)
+                    CloseHandle(mMappingHandle);
+                CloseHandle(mFileHandle);
+                std::ostringstream os;
+                os << "Failed to map '" << filename << "' into memory.";
+                throw std::runtime_error(os.str());
+            }
+        }
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        if (mData)
+            UnmapViewOfFile(mData);
+        if (mMappingHandle)
+            CloseHandle(mMappingHandle);
+        if (mFileHandle != INVALID_HANDLE_VALUE)
+            CloseHandle(mFileHandle);
+    }
+
+#endif
+
+    IStreamPtr openMemoryMappedFileStream(const MemoryMappedFilePtr& file, size_t start, size_t length)
+    {
+        if (start + length > file->getSize())
+            throw std::runtime_error("Memory mapped file region out of range");
+        return IStreamPtr(new MemoryMappedFileStream(file, start, length));
+    }
+
+}
@@ -0,0 +1,49 @@
+#ifndef OPENMW_COMPONENTS_FILES_MEMORYMAPPEDFILE_H
+#define OPENMW_COMPONENTS_FILES_MEMORYMAPPEDFILE_H
+
+#include <memory>
+#include <vector>
+
+#include "lowlevelfile.hpp"
+#include "constrainedfilestream.hpp"
+
+namespace Files
+{
+
+    /// @brief A read-only view of a whole file mapped into memory.
+    /// @par Falls back to reading the file into a heap buffer on platforms without a mapping API.
+    /// @note Once opened the mapping is immutable, so it may be read from any thread.
+    class MemoryMappedFile
+    {
+    public:
+        /// @note Throws an exception if the file can not be opened or mapped.
+        MemoryMappedFile(const char *filename);
+        ~MemoryMappedFile();
+
+        const char* getData() const { return mData; }
+        size_t getSize() const { return mSize; }
+
+    private:
+        MemoryMappedFile(const MemoryMappedFile&);
+        MemoryMappedFile& operator=(const MemoryMappedFile&);
+
+        const char* mData;
+        size_t mSize;
+
+#if FILE_API == FILE_API_STDIO
+        std::vector<char> mBuffer;
+#elif FILE_API == FILE_API_WIN32
+        HANDLE mFileHandle;
+        HANDLE mMappingHandle;
+#endif
+    };
+
+    typedef std::shared_ptr<const MemoryMappedFile> MemoryMappedFilePtr;
+
+    /// Open a stream over a region of the mapping, without copying the data. The stream keeps the mapping alive.
+    /// @note Use Files::getMemoryBuffer() on the returned stream to access the region directly.
+    IStreamPtr openMemoryMappedFileStream(const MemoryMappedFilePtr& file, size_t start, size_t length);
+
+}
+
+#endif
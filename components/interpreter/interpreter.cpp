@@ -8,7 +8,7 @@
 
 namespace Interpreter
 {
-    void Interpreter::execute (Type_Code code)
+    void Interpreter::decode (Type_Code code, Instruction& instruction) const
     {
         unsigned int segSpec = code>>30;
 
@@ -19,12 +19,19 @@ namespace Interpreter
                 int opcode = code>>24;
                 unsigned int arg0 = code & 0xffffff;
 
-                std::map<int, Opcode1 *>::iterator iter = mSegment0.find (opcode);
+                std::map<int, Opcode1 *>::const_iterator iter = mSegment0.find (opcode);
 
                 if (iter==mSegment0.end())
-                    abortUnknownCode (0, opcode);
+                {
+                    instruction.mType = Instruction::Type_UnknownCode;
+                    instruction.mArg0 = 0;
+                    instruction.mArg1 = opcode;
+                    return;
+                }
 
-                iter->second->execute (mRuntime, arg0);
+                instruction.mType = Instruction::Type_Opcode1;
+                instruction.mOpcode1 = iter->second;
+                instruction.mArg0 = arg0;
 
                 return;
             }
@@ -35,12 +42,20 @@ namespace Interpreter
                 unsigned int arg0 = (code>>16) & 0xfff;
                 unsigned int arg1 = code & 0xfff;
 
-                std::map<int, Opcode2 *>::iterator iter = mSegment1.find (opcode);
+                std::map<int, Opcode2 *>::const_iterator iter = mSegment1.find (opcode);
 
                 if (iter==mSegment1.end())
-                    abortUnknownCode (1, opcode);
-
-                iter->second->execute (mRuntime, arg0, arg1);
+                {
+                    instruction.mType = Instruction::Type_UnknownCode;
+                    instruction.mArg0 = 1;
+                    instruction.mArg1 = opcode;
+                    return;
+                }
+
+                instruction.mType = Instruction::Type_Opcode2;
+                instruction.mOpcode2 = iter->second;
+                instruction.mArg0 = arg0;
+                instruction.mArg1 = arg1;
 
                 return;
             }
@@ -50,12 +65,19 @@ namespace Interpreter
                 int opcode = (code>>20) & 0x3ff;
                 unsigned int arg0 = code & 0xfffff;
 
-                std::map<int, Opcode1 *>::iterator iter = mSegment2.find (opcode);
+                std::map<int, Opcode1 *>::const_iterator iter = mSegment2.find (opcode);
 
                 if (iter==mSegment2.end())
-                    abortUnknownCode (2, opcode);
+                {
+                    instruction.mType = Instruction::Type_UnknownCode;
+                    instruction.mArg0 = 2;
+                    instruction.mArg1 = opcode;
+                    return;
+                }
 
-                iter->second->execute (mRuntime, arg0);
+                instruction.mType = Instruction::Type_Opcode1;
+                instruction.mOpcode1 = iter->second;
+                instruction.mArg0 = arg0;
 
                 return;
             }
@@ -70,12 +92,19 @@ namespace Interpreter
                 int opcode = (code>>8) & 0x3ffff;
                 unsigned int arg0 = code & 0xff;
 
-                std::map<int, Opcode1 *>::iterator iter = mSegment3.find (opcode);
+                std::map<int, Opcode1 *>::const_iterator iter = mSegment3.find (opcode);
 
                 if (iter==mSegment3.end())
-                    abortUnknownCode (3, opcode);
+                {
+                    instruction.mType = Instruction::Type_UnknownCode;
+                    instruction.mArg0 = 3;
+                    instruction.mArg1 = opcode;
+                    return;
+                }
 
-                iter->second->execute (mRuntime, arg0);
+                instruction.mType = Instruction::Type_Opcode1;
+                instruction.mOpcode1 = iter->second;
+                instruction.mArg0 = arg0;
 
                 return;
             }
@@ -86,12 +115,20 @@ namespace Interpreter
                 unsigned int arg0 = (code>>8) & 0xff;
                 unsigned int arg1 = code & 0xff;
 
-                std::map<int, Opcode2 *>::iterator iter = mSegment4.find (opcode);
+                std::map<int, Opcode2 *>::const_iterator iter = mSegment4.find (opcode);
 
                 if (iter==mSegment4.end())
-                    abortUnknownCode (4, opcode);
-
-                iter->second->execute (mRuntime, arg0, arg1);
+                {
+                    instruction.mType = Instruction::Type_UnknownCode;
+                    instruction.mArg0 = 4;
+                    instruction.mArg1 = opcode;
+                    return;
+                }
+
+                instruction.mType = Instruction::Type_Opcode2;
+                instruction.mOpcode2 = iter->second;
+                instruction.mArg0 = arg0;
+                instruction.mArg1 = arg1;
 
                 return;
             }
@@ -100,18 +137,57 @@ namespace Interpreter
             {
                 int opcode = code & 0x3ffffff;
 
-                std::map<int, Opcode0 *>::iterator iter = mSegment5.find (opcode);
+                std::map<int, Opcode0 *>::const_iterator iter = mSegment5.find (opcode);
 
                 if (iter==mSegment5.end())
-                    abortUnknownCode (5, opcode);
+                {
+                    instruction.mType = Instruction::Type_UnknownCode;
+                    instruction.mArg0 = 5;
+                    instruction.mArg1 = opcode;
+                    return;
+                }
 
-                iter->second->execute (mRuntime);
+                instruction.mType = Instruction::Type_Opcode0;
+                instruction.mOpcode0 = iter->second;
 
                 return;
             }
         }
 
-        abortUnknownSegment (code);
+        instruction.mType = Instruction::Type_UnknownSegment;
+        instruction.mArg0 = code;
+    }
+
+
+    void Interpreter::execute (const Instruction& instruction)
+    {
+        switch (instruction.mType)
+        {
+            case Instruction::Type_Opcode0:
+
+                instruction.mOpcode0->execute (mRuntime);
+                return;
+
+            case Instruction::Type_Opcode1:
+
+                instruction.mOpcode1->execute (mRuntime, instruction.mArg0);
+                return;
+
+            case Instruction::Type_Opcode2:
+
+                instruction.mOpcode2->execute (mRuntime, instruction.mArg0, instruction.mArg1);
+                return;
+
+            case Instruction::Type_UnknownCode:
+
+                abortUnknownCode (instruction.mArg0, instruction.mArg1);
+                return;
+
+            case Instruction::Type_UnknownSegment:
+
+                abortUnknownSegment (instruction.mArg0);
+                return;
+        }
     }
 
     void Interpreter::abortUnknownCode (int segment, int opcode)
@@ -227,23 +303,41 @@ namespace Interpreter
 
     void Interpreter::run (const Type_Code *code, int codeSize, Context& context)
     {
-        assert (codeSize>=4);
+        Program program (std::vector<Type_Code> (code, code+codeSize));
+        run (program, context);
+    }
+
+    void Interpreter::run (Program& program, Context& context)
+    {
+        assert (program.mCode.size()>=4);
+
+        const Type_Code *code = &program.mCode[0];
+        int opcodes = static_cast<int> (code[0]);
+
+        if (program.mInterpreter!=this)
+        {
+            const Type_Code *codeBlock = code + 4;
+
+            program.mInstructions.resize (opcodes);
+            for (int i=0; i<opcodes; ++i)
+                decode (codeBlock[i], program.mInstructions[i]);
+
+            program.mInterpreter = this;
+        }
 
         begin();
 
         try
         {
-            mRuntime.configure (code, codeSize, context);
+            mRuntime.configure (code, static_cast<int> (program.mCode.size()), context);
 
-            int opcodes = static_cast<int> (code[0]);
-
-            const Type_Code *codeBlock = code + 4;
+            const Instruction *instructions = opcodes>0 ? &program.mInstructions[0] : 0;
 
             while (mRuntime.getPC()>=0 && mRuntime.getPC()<opcodes)
             {
-                Type_Code runCode = codeBlock[mRuntime.getPC()];
+                const Instruction& instruction = instructions[mRuntime.getPC()];
                 mRuntime.setPC (mRuntime.getPC()+1);
-                execute (runCode);
+                execute (instruction);
             }
         }
         catch (...)
@@ -4,6 +4,7 @@
 #include <map>
 #include <stack>
 
+#include "program.hpp"
 #include "runtime.hpp"
 #include "types.hpp"
 
@@ -29,7 +30,10 @@ namespace Interpreter
             Interpreter (const Interpreter&);
             Interpreter& operator= (const Interpreter&);
 
-            void execute (Type_Code code);
+            void decode (Type_Code code, Instruction& instruction) const;
+            ///< Look up the opcode of \a code and extract its arguments.
+
+            void execute (const Instruction& instruction);
 
             void abortUnknownCode (int segment, int opcode);
 
@@ -64,6 +68,10 @@ namespace Interpreter
             ///< ownership of \a opcode is transferred to *this.
 
             void run (const Type_Code *code, int codeSize, Context& context);
+            ///< Run byte code that is only run once. Scripts that are run repeatedly should use a Program.
+
+            void run (Program& program, Context& context);
+            ///< Run \a program, decoding its instructions first if it hasn't been run by this interpreter before.
     };
 }
 
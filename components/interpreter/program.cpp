@@ -0,0 +1,20 @@
+#include "program.hpp"
+
+namespace Interpreter
+{
+    Program::Program() : mInterpreter (0) {}
+
+    Program::Program (const std::vector<Type_Code>& code) : mCode (code), mInterpreter (0) {}
+
+    bool Program::empty() const
+    {
+        return mCode.empty();
+    }
+
+    void Program::clear()
+    {
+        mCode.clear();
+        mInstructions.clear();
+        mInterpreter = 0;
+    }
+}
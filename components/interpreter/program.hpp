@@ -0,0 +1,64 @@
+#ifndef INTERPRETER_PROGRAM_H_INCLUDED
+#define INTERPRETER_PROGRAM_H_INCLUDED
+
+#include <vector>
+
+#include "types.hpp"
+
+namespace Interpreter
+{
+    class Interpreter;
+    class Opcode0;
+    class Opcode1;
+    class Opcode2;
+
+    /// An instruction with its opcode already looked up and its arguments extracted
+    struct Instruction
+    {
+        enum Type
+        {
+            Type_Opcode0,
+            Type_Opcode1,
+            Type_Opcode2,
+            Type_UnknownCode, ///< mArg0: segment, mArg1: opcode
+            Type_UnknownSegment ///< mArg0: code
+        };
+
+        Type mType;
+
+        union
+        {
+            Opcode0 *mOpcode0;
+            Opcode1 *mOpcode1;
+            Opcode2 *mOpcode2;
+        };
+
+        unsigned int mArg0;
+        unsigned int mArg1;
+    };
+
+    /// \brief Script byte code, prepared for being run repeatedly
+    ///
+    /// The interpreter decodes the instructions on the first run, so later runs don't have to look up
+    /// every opcode again. The decoded instructions refer to the opcodes of that interpreter.
+    class Program
+    {
+            std::vector<Type_Code> mCode;
+            std::vector<Instruction> mInstructions;
+            const Interpreter *mInterpreter; ///< that mInstructions were decoded for
+
+            friend class Interpreter;
+
+        public:
+
+            Program();
+
+            explicit Program (const std::vector<Type_Code>& code);
+
+            bool empty() const;
+
+            void clear();
+    };
+}
+
+#endif
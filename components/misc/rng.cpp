@@ -13,6 +13,11 @@ namespace Misc
         generator.seed(static_cast<unsigned int>(std::chrono::high_resolution_clock::now().time_since_epoch().count()));
     }
 
+    void Rng::init(unsigned int seed)
+    {
+        generator.seed(seed);
+    }
+
     float Rng::rollProbability()
     {
         return std::uniform_real_distribution<float>(0, 1 - std::numeric_limits<float>::epsilon())(generator);
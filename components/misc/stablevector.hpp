@@ -0,0 +1,219 @@
+#ifndef MISC_STABLEVECTOR_H
+#define MISC_STABLEVECTOR_H
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace Misc
+{
+    /// @brief Sequence container that stores its elements in fixed-size chunks of contiguous memory.
+    ///
+    /// Unlike std::vector, elements never move once inserted: pointers, references and iterators stay valid
+    /// until the element itself is erased, like with std::list. Unlike std::list, neighbouring elements
+    /// share cache lines, so a full pass over the container is mostly linear memory access.
+    ///
+    /// Erasing leaves a hole that iteration skips over; holes are only reclaimed by clear(). This suits
+    /// collections that mostly grow and are rarely erased from, such as the references of a cell.
+    template <typename T, std::size_t ChunkSize = 64>
+    class StableVector
+    {
+        struct Chunk
+        {
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type mData[ChunkSize];
+            bool mAlive[ChunkSize];
+
+            T* get(std::size_t index) { return reinterpret_cast<T*>(&mData[index]); }
+        };
+
+        template <typename Value, typename Container>
+        class IteratorBase
+        {
+            Container* mContainer;
+            std::size_t mIndex;
+
+            template <typename V, typename C> friend class IteratorBase;
+            friend class StableVector;
+
+        public:
+            typedef std::bidirectional_iterator_tag iterator_category;
+            typedef typename std::remove_const<Value>::type value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef Value* pointer;
+            typedef Value& reference;
+
+            IteratorBase() : mContainer(nullptr), mIndex(0) {}
+
+            IteratorBase(Container* container, std::size_t index) : mContainer(container), mIndex(index) {}
+
+            /// Allow conversion from iterator to const_iterator
+            template <typename V, typename C>
+            IteratorBase(const IteratorBase<V, C>& other) : mContainer(other.mContainer), mIndex(other.mIndex) {}
+
+            reference operator*() const { return *mContainer->slot(mIndex); }
+            pointer operator->() const { return mContainer->slot(mIndex); }
+
+            IteratorBase& operator++()
+            {
+                mIndex = mContainer->nextAlive(mIndex + 1);
+                return *this;
+            }
+
+            IteratorBase operator++(int)
+            {
+                IteratorBase copy(*this);
+                ++*this;
+                return copy;
+            }
+
+            IteratorBase& operator--()
+            {
+                mIndex = mContainer->previousAlive(mIndex);
+                return *this;
+            }
+
+            IteratorBase operator--(int)
+            {
+                IteratorBase copy(*this);
+                --*this;
+                return copy;
+            }
+
+            template <typename V, typename C>
+            bool operator==(const IteratorBase<V, C>& other) const
+            {
+                return mIndex == other.mIndex && mContainer == other.mContainer;
+            }
+
+            template <typename V, typename C>
+            bool operator!=(const IteratorBase<V, C>& other) const
+            {
+                return !(*this == other);
+            }
+        };
+
+    public:
+        typedef T value_type;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef std::size_t size_type;
+        typedef IteratorBase<T, StableVector> iterator;
+        typedef IteratorBase<const T, const StableVector> const_iterator;
+
+        StableVector() : mEnd(0), mSize(0) {}
+
+        StableVector(const StableVector& other) : mEnd(0), mSize(0)
+        {
+            for (const_iterator it = other.begin(); it != other.end(); ++it)
+                push_back(*it);
+        }
+
+        StableVector& operator=(const StableVector& other)
+        {
+            if (this != &other)
+            {
+                clear();
+                for (const_iterator it = other.begin(); it != other.end(); ++it)
+                    push_back(*it);
+            }
+            return *this;
+        }
+
+        ~StableVector()
+        {
+            clear();
+            for (typename std::vector<Chunk*>::iterator it = mChunks.begin(); it != mChunks.end(); ++it)
+                delete *it;
+        }
+
+        iterator begin() { return iterator(this, nextAlive(0)); }
+        iterator end() { return iterator(this, mEnd); }
+        const_iterator begin() const { return const_iterator(this, nextAlive(0)); }
+        const_iterator end() const { return const_iterator(this, mEnd); }
+
+        bool empty() const { return mSize == 0; }
+
+        /// Number of elements, not counting the holes left by erase().
+        size_type size() const { return mSize; }
+
+        T& front() { return *begin(); }
+        const T& front() const { return *begin(); }
+        T& back() { return *--end(); }
+        const T& back() const { return *--end(); }
+
+        void push_back(const T& value)
+        {
+            if (mEnd == mChunks.size() * ChunkSize)
+                mChunks.push_back(new Chunk);
+
+            Chunk* chunk = mChunks[mEnd / ChunkSize];
+            std::size_t index = mEnd % ChunkSize;
+            new (chunk->get(index)) T(value);
+            chunk->mAlive[index] = true;
+            ++mEnd;
+            ++mSize;
+        }
+
+        /// Destroy the element at the given position; other elements are not moved.
+        /// @return iterator to the element following the erased one
+        iterator erase(iterator position)
+        {
+            Chunk* chunk = mChunks[position.mIndex / ChunkSize];
+            std::size_t index = position.mIndex % ChunkSize;
+            chunk->get(index)->~T();
+            chunk->mAlive[index] = false;
+            --mSize;
+            return iterator(this, nextAlive(position.mIndex + 1));
+        }
+
+        /// Destroy all elements. The allocated chunks are kept for reuse.
+        void clear()
+        {
+            for (std::size_t i = 0; i < mEnd; ++i)
+            {
+                Chunk* chunk = mChunks[i / ChunkSize];
+                if (chunk->mAlive[i % ChunkSize])
+                {
+                    chunk->get(i % ChunkSize)->~T();
+                    chunk->mAlive[i % ChunkSize] = false;
+                }
+            }
+            mEnd = 0;
+            mSize = 0;
+        }
+
+    private:
+        T* slot(std::size_t index) const
+        {
+            return mChunks[index / ChunkSize]->get(index % ChunkSize);
+        }
+
+        bool isAlive(std::size_t index) const
+        {
+            return mChunks[index / ChunkSize]->mAlive[index % ChunkSize];
+        }
+
+        std::size_t nextAlive(std::size_t index) const
+        {
+            while (index < mEnd && !isAlive(index))
+                ++index;
+            return index;
+        }
+
+        std::size_t previousAlive(std::size_t index) const
+        {
+            do
+                --index;
+            while (!isAlive(index));
+            return index;
+        }
+
+        std::vector<Chunk*> mChunks;
+        std::size_t mEnd;   // one past the last slot ever used
+        std::size_t mSize;  // number of live elements
+    };
+}
+
+#endif
@@ -1,34 +1,79 @@
 #include "niffile.hpp"
 #include "effect.hpp"
 
-#include <map>
+#include <cstddef>
+#include <new>
+#include <unordered_map>
 #include <sstream>
 
 namespace Nif
 {
 
+void* RecordArena::allocate(size_t size)
+{
+    // Keep every allocation suitably aligned for any record type
+    const size_t alignment = alignof(std::max_align_t);
+    size = (size + alignment - 1) & ~(alignment - 1);
+
+    if (size > sBlockSize)
+    {
+        // Oversized records get a dedicated block, inserted before the current one so it stays in use
+        std::unique_ptr<char[]> block(new char[size]);
+        char* data = block.get();
+        mBlocks.insert(mBlocks.empty() ? mBlocks.end() : mBlocks.end() - 1, std::move(block));
+        return data;
+    }
+
+    if (mUsed + size > sBlockSize)
+    {
+        mBlocks.emplace_back(new char[sBlockSize]);
+        mUsed = 0;
+    }
+
+    void* data = mBlocks.back().get() + mUsed;
+    mUsed += size;
+    return data;
+}
+
 /// Open a NIF stream. The name is used for error messages.
 NIFFile::NIFFile(Files::IStreamPtr stream, const std::string &name)
     : ver(0)
     , filename(name)
+    , mFileSize(0)
     , mUseSkinning(false)
 {
-    parse(stream);
+    try
+    {
+        parse(stream);
+    }
+    catch (...)
+    {
+        clear();
+        throw;
+    }
 }
 
 NIFFile::~NIFFile()
+{
+    clear();
+}
+
+void NIFFile::clear()
 {
     for (std::vector<Record*>::iterator it = records.begin() ; it != records.end(); ++it)
     {
-        delete *it;
+        if (*it)
+            (*it)->~Record();
     }
+    records.clear();
+    roots.clear();
 }
 
-template <typename NodeType> static Record* construct() { return new NodeType; }
+template <typename NodeType> static Record* construct(RecordArena& arena) { return new (arena.allocate(sizeof(NodeType))) NodeType; }
 
 struct RecordFactoryEntry {
 
-    typedef Record* (*create_t) ();
+    typedef Record* (*create_t) (RecordArena& arena);
 
     create_t        mCreate;
     RecordType      mType;
@@ -36,16 +81,16 @@ struct RecordFactoryEntry {
 };
 
 ///Helper function for adding records to the factory map
-static std::pair<std::string,RecordFactoryEntry> makeEntry(std::string recName, Record* (*create_t) (), RecordType type)
+static std::pair<std::string,RecordFactoryEntry> makeEntry(std::string recName, Record* (*create_t) (RecordArena&), RecordType type)
 {
     RecordFactoryEntry anEntry = {create_t,type};
     return std::make_pair(recName, anEntry);
 }
 
 ///These are all the record types we know how to read.
-static std::map<std::string,RecordFactoryEntry> makeFactory()
+static std::unordered_map<std::string,RecordFactoryEntry> makeFactory()
 {
-    std::map<std::string,RecordFactoryEntry> newFactory;
+    std::unordered_map<std::string,RecordFactoryEntry> newFactory;
     newFactory.insert(makeEntry("NiNode",                     &construct <NiNode>                      , RC_NiNode                        ));
     newFactory.insert(makeEntry("NiSwitchNode",               &construct <NiSwitchNode>                , RC_NiSwitchNode                  ));
     newFactory.insert(makeEntry("NiLODNode",                  &construct <NiLODNode>                   , RC_NiLODNode                     ));
@@ -114,7 +159,7 @@ static std::map<std::string,RecordFactoryEntry> makeFactory()
 
 
 ///Make the factory map used for parsing the file
-static const std::map<std::string,RecordFactoryEntry> factories = makeFactory();
+static const std::unordered_map<std::string,RecordFactoryEntry> factories = makeFactory();
 
 std::string NIFFile::printVersion(unsigned int version)
 {
@@ -137,6 +182,7 @@ std::string NIFFile::printVersion(unsigned int version)
 void NIFFile::parse(Files::IStreamPtr stream)
 {
     NIFStream nif (this, stream);
+    mFileSize = nif.size();
 
     // Check the header string
     std::string head = nif.getVersionString();
@@ -172,11 +218,11 @@ void NIFFile::parse(Files::IStreamPtr stream)
             fail(error.str());
         }
 
-        std::map<std::string,RecordFactoryEntry>::const_iterator entry = factories.find(rec);
+        std::unordered_map<std::string,RecordFactoryEntry>::const_iterator entry = factories.find(rec);
 
         if (entry != factories.end())
         {
-            r = entry->second.mCreate ();
+            r = entry->second.mCreate (mRecordArena);
             r->recType = entry->second.mType;
         }
         else
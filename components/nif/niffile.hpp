@@ -5,6 +5,7 @@
 
 #include <stdexcept>
 #include <vector>
+#include <memory>
 #include <iostream>
 
 #include <components/files/constrainedfilestream.hpp>
@@ -14,6 +15,22 @@
 namespace Nif
 {
 
+/// Allocates the records of one file from a few large blocks instead of one heap allocation per record.
+/// @note Does not run destructors, the owner has to destroy the objects before the arena goes away.
+class RecordArena
+{
+public:
+    RecordArena() : mUsed(sBlockSize) {}
+
+    void* allocate(size_t size);
+
+private:
+    static const size_t sBlockSize = 16384;
+
+    std::vector<std::unique_ptr<char[]> > mBlocks;
+    size_t mUsed;
+};
+
 class NIFFile
 {
     enum NIFVersion {
@@ -26,17 +43,26 @@ class NIFFile
     /// File name, used for error messages and opening the file
     std::string filename;
 
+    /// Size of the parsed file in bytes
+    size_t mFileSize;
+
     /// Record list
     std::vector<Record*> records;
 
     /// Root list.  This is a select portion of the pointers from records
     std::vector<Record*> roots;
 
+    /// Storage for the records
+    RecordArena mRecordArena;
+
     bool mUseSkinning;
 
     /// Parse the file
     void parse(Files::IStreamPtr stream);
 
+    /// Destroy all records
+    void clear();
+
     /// Get the file's version in a human readable form
     ///\returns A string containing a human readable NIF version number
     std::string printVersion(unsigned int version);
@@ -91,6 +117,9 @@ public:
 
     /// Get the name of the file
     std::string getFilename() const { return filename; }
+
+    /// Get the size of the parsed file in bytes, useful as an estimate of the memory used by the records
+    size_t getFileSize() const { return mFileSize; }
 };
 typedef std::shared_ptr<const Nif::NIFFile> NIFFilePtr;
 
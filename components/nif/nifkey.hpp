@@ -6,7 +6,8 @@
 #include "nifstream.hpp"
 
 #include <sstream>
-#include <map>
+#include <vector>
+#include <algorithm>
 
 #include "niffile.hpp"
 
@@ -31,10 +32,9 @@ typedef KeyT<osg::Vec3f> Vector3Key;
 typedef KeyT<osg::Vec4f> Vector4Key;
 typedef KeyT<osg::Quat> QuaternionKey;
 
+/// Keys of a controller, stored as contiguous arrays sorted by time for quick lookups while animating
 template<typename T, T (NIFStream::*getValue)()>
 struct KeyMapT {
-    typedef std::map< float, KeyT<T> > MapType;
-
     typedef T ValueType;
     typedef KeyT<T> KeyType;
 
@@ -44,7 +44,8 @@ struct KeyMapT {
     static const unsigned int sXYZInterpolation = 4;
 
     unsigned int mInterpolationType;
-    MapType mKeys;
+    std::vector<float> mTimes; ///< ascending, each time only appears once
+    std::vector<KeyType> mKeys; ///< the key for each time in mTimes
 
     KeyMapT() : mInterpolationType(sLinearInterpolation) {}
 
@@ -59,6 +60,7 @@ struct KeyMapT {
         if(count == 0 && !force)
             return;
 
+        mTimes.clear();
         mKeys.clear();
 
         mInterpolationType = nif->getUInt();
@@ -72,7 +74,7 @@ struct KeyMapT {
             {
                 float time = nif->getFloat();
                 readValue(nifReference, key);
-                mKeys[time] = key;
+                addKey(time, key);
             }
         }
         else if(mInterpolationType == sQuadraticInterpolation)
@@ -81,7 +83,7 @@ struct KeyMapT {
             {
                 float time = nif->getFloat();
                 readQuadratic(nifReference, key);
-                mKeys[time] = key;
+                addKey(time, key);
             }
         }
         else if(mInterpolationType == sTBCInterpolation)
@@ -90,7 +92,7 @@ struct KeyMapT {
             {
                 float time = nif->getFloat();
                 readTBC(nifReference, key);
-                mKeys[time] = key;
+                addKey(time, key);
             }
         }
         //XYZ keys aren't actually read here.
@@ -120,9 +122,55 @@ struct KeyMapT {
             error << "Unhandled interpolation type: " << mInterpolationType;
             nif->file->fail(error.str());
         }
+
+        sortKeys();
     }
 
 private:
+    void addKey(float time, const KeyType &key)
+    {
+        mTimes.push_back(time);
+        mKeys.push_back(key);
+    }
+
+    struct IndexLess
+    {
+        const std::vector<float> &mTimes;
+        IndexLess(const std::vector<float> &times) : mTimes(times) {}
+        bool operator()(size_t left, size_t right) const { return mTimes[left] < mTimes[right]; }
+    };
+
+    /// Keys are stored in order in practice. Otherwise, sort them, and if a time appears more than once
+    /// keep the key read last, like a map would.
+    void sortKeys()
+    {
+        bool sorted = true;
+        for (size_t i = 1; i < mTimes.size() && sorted; ++i)
+            sorted = mTimes[i-1] < mTimes[i];
+        if (sorted)
+            return;
+
+        std::vector<size_t> order(mTimes.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), IndexLess(mTimes));
+
+        std::vector<float> times;
+        std::vector<KeyType> keys;
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            if (!times.empty() && times.back() == mTimes[order[i]])
+                keys.back() = mKeys[order[i]];
+            else
+            {
+                times.push_back(mTimes[order[i]]);
+                keys.push_back(mKeys[order[i]]);
+            }
+        }
+        mTimes.swap(times);
+        mKeys.swap(keys);
+    }
+
     static void readValue(NIFStream &nif, KeyT<T> &key)
     {
         key.mValue = (nif.*getValue)();
@@ -1,13 +1,16 @@
 #include "nifstream.hpp"
+
+#include <sstream>
+
+#include <components/files/memorystream.hpp>
+
 //For error reporting
 #include "niffile.hpp"
 
-namespace Nif
+namespace
 {
-    osg::Quat NIFStream::getQuaternion()
+    osg::Quat makeQuaternion(const float* f)
     {
-        float f[4];
-        readLittleEndianBufferOfType<4, float,uint32_t>(inp, (float*)&f);
         osg::Quat quat;
         quat.w() = f[0];
         quat.x() = f[1];
@@ -15,6 +18,67 @@ namespace Nif
         quat.z() = f[3];
         return quat;
     }
+}
+
+namespace Nif
+{
+    NIFStream::NIFStream(NIFFile *file, Files::IStreamPtr inp)
+        : inp(inp)
+        , mData(0)
+        , mSize(0)
+        , mPos(0)
+        , file(file)
+    {
+        if (Files::getMemoryBuffer(*inp, mData, mSize))
+            return;
+
+        // Not memory backed, so read the whole file with a single bulk read
+        inp->seekg(0, std::ios_base::end);
+        std::streamoff size = inp->tellg();
+        inp->seekg(0, std::ios_base::beg);
+        if (size > 0 && inp->good())
+        {
+            mBuffer.resize(static_cast<size_t>(size));
+            inp->read(mBuffer.data(), size);
+            mBuffer.resize(static_cast<size_t>(inp->gcount()));
+        }
+        else
+        {
+            inp->clear();
+            char chunk[8192];
+            while (inp->read(chunk, sizeof(chunk)) || inp->gcount() > 0)
+                mBuffer.insert(mBuffer.end(), chunk, chunk + inp->gcount());
+        }
+
+        mData = mBuffer.data();
+        mSize = mBuffer.size();
+    }
+
+    void NIFStream::failReadPastEnd(size_t size) const
+    {
+        std::stringstream error;
+        error << "Attempt to read " << size << " bytes at offset " << mPos << " past the end of the file (" << mSize << " bytes)";
+        file->fail(error.str());
+    }
+
+    osg::Quat NIFStream::getQuaternion()
+    {
+        float f[4];
+        readLittleEndianBufferOfType<4, float,uint32_t>(consume(4 * sizeof(float)), (float*)&f);
+        return makeQuaternion(f);
+    }
+
+    void NIFStream::getQuaternions(std::vector<osg::Quat> &quat, size_t size)
+    {
+        const char* data = consume(size * 4 * sizeof(float));
+        quat.resize(size);
+        for (size_t i = 0;i < quat.size();i++)
+        {
+            float f[4];
+            readLittleEndianBufferOfType<4, float,uint32_t>(data + i * 4 * sizeof(float), (float*)&f);
+            quat[i] = makeQuaternion(f);
+        }
+    }
 
     Transformation NIFStream::getTrafo()
     {
@@ -4,8 +4,10 @@
 #define OPENMW_COMPONENTS_NIF_NIFSTREAM_HPP
 
 #include <cassert>
+#include <cstring>
 #include <stdint.h>
 #include <stdexcept>
+#include <algorithm>
 #include <vector>
 
 #include <components/files/constrainedfilestream.hpp>
@@ -21,16 +23,15 @@ namespace Nif
 
 class NIFFile;
 
-/* 
+/*
     readLittleEndianBufferOfType: This template should only be used with non POD data types
 */
-template <uint32_t numInstances, typename T, typename IntegerT> inline void readLittleEndianBufferOfType(Files::IStreamPtr &pIStream, T* dest)
+template <uint32_t numInstances, typename T, typename IntegerT> inline void readLittleEndianBufferOfType(const char* src, T* dest)
 {
 #if defined(__x86_64__) || defined(_M_X64) || defined(__i386) || defined(_M_IX86)
-    pIStream->read((char*)dest, numInstances * sizeof(T));
+    std::memcpy(dest, src, numInstances * sizeof(T));
 #else
-    uint8_t* destByteBuffer = (uint8_t*)dest;
-    pIStream->read((char*)dest, numInstances * sizeof(T));
+    const uint8_t* srcByteBuffer = (const uint8_t*)src;
     /*
         Due to the loop iterations being known at compile time,
         this nested loop will most likely be unrolled
@@ -44,7 +45,7 @@ template <uint32_t numInstances, typename T, typename IntegerT> inline void read
     {
         u = { 0 };
         for (uint32_t byte = 0; byte < sizeof(T); byte++)
-            u.i |= (((IntegerT)destByteBuffer[i * sizeof(T) + byte]) << (byte * 8));
+            u.i |= (((IntegerT)srcByteBuffer[i * sizeof(T) + byte]) << (byte * 8));
         dest[i] = u.t;
     }
 #endif
@@ -53,13 +54,12 @@ template <uint32_t numInstances, typename T, typename IntegerT> inline void read
 /*
     readLittleEndianDynamicBufferOfType: This template should only be used with non POD data types
 */
-template <typename T, typename IntegerT> inline void readLittleEndianDynamicBufferOfType(Files::IStreamPtr &pIStream, T* dest, uint32_t numInstances)
+template <typename T, typename IntegerT> inline void readLittleEndianDynamicBufferOfType(const char* src, T* dest, uint32_t numInstances)
 {
 #if defined(__x86_64__) || defined(_M_X64) || defined(__i386) || defined(_M_IX86)
-    pIStream->read((char*)dest, numInstances * sizeof(T));
+    std::memcpy(dest, src, numInstances * sizeof(T));
 #else
-    uint8_t* destByteBuffer = (uint8_t*)dest;
-    pIStream->read((char*)dest, numInstances * sizeof(T));
+    const uint8_t* srcByteBuffer = (const uint8_t*)src;
     union {
         IntegerT i;
         T t;
@@ -68,86 +68,112 @@ template <typename T, typename IntegerT> inline void readLittleEndianDynamicBuff
     {
         u.i = 0;
         for (uint32_t byte = 0; byte < sizeof(T); byte++)
-            u.i |= ((IntegerT)destByteBuffer[i * sizeof(T) + byte]) << (byte * 8);
+            u.i |= ((IntegerT)srcByteBuffer[i * sizeof(T) + byte]) << (byte * 8);
         dest[i] = u.t;
     }
 #endif
 }
-template<typename type, typename IntegerT> type inline readLittleEndianType(Files::IStreamPtr &pIStream)
+template<typename type, typename IntegerT> type inline readLittleEndianType(const char* src)
 {
     type val;
-    readLittleEndianBufferOfType<1,type,IntegerT>(pIStream, (type*)&val);
+    readLittleEndianBufferOfType<1,type,IntegerT>(src, (type*)&val);
     return val;
 }
 
 class NIFStream
 {
-    /// Input stream
+    /// Input stream, kept alive while its buffer is in use
     Files::IStreamPtr inp;
 
+    /// Copy of the stream contents, only used if the stream is not memory backed
+    std::vector<char> mBuffer;
+
+    /// The contiguous file contents that are parsed
+    const char* mData;
+    size_t mSize;
+    size_t mPos;
+
+    /// Throws an exception about a read past the end of the file
+    void failReadPastEnd(size_t size) const;
+
+    /// Advance by the given number of bytes, returning a pointer to the data passed over
+    const char* consume(size_t size)
+    {
+        if (size > mSize - mPos)
+            failReadPastEnd(size);
+        const char* data = mData + mPos;
+        mPos += size;
+        return data;
+    }
+
 public:
 
     NIFFile * const file;
 
-    NIFStream (NIFFile * file, Files::IStreamPtr inp): inp (inp), file (file) {}
+    /// @note If the stream is memory backed (see Files::getMemoryBuffer()) it is parsed in place,
+    /// otherwise its contents are read into memory in one go.
+    NIFStream (NIFFile * file, Files::IStreamPtr inp);
 
-    void skip(size_t size) { inp->ignore(size); }
+    void skip(size_t size) { consume(size); }
+
+    /// Size of the whole file in bytes
+    size_t size() const { return mSize; }
 
     char getChar()
     {
-        return readLittleEndianType<char,char>(inp);
+        return readLittleEndianType<char,char>(consume(sizeof(char)));
     }
 
     short getShort()
     {
-        return readLittleEndianType<short,short>(inp);
+        return readLittleEndianType<short,short>(consume(sizeof(short)));
     }
 
     unsigned short getUShort()
     {
-        return readLittleEndianType<unsigned short,unsigned short>(inp);
+        return readLittleEndianType<unsigned short,unsigned short>(consume(sizeof(unsigned short)));
     }
 
     int getInt()
     {
-        return readLittleEndianType<int,int>(inp);
+        return readLittleEndianType<int,int>(consume(sizeof(int)));
     }
 
     unsigned int getUInt()
     {
-        return readLittleEndianType<unsigned int,unsigned int>(inp);
+        return readLittleEndianType<unsigned int,unsigned int>(consume(sizeof(unsigned int)));
     }
 
     float getFloat()
     {
-        return readLittleEndianType<float,uint32_t>(inp);
+        return readLittleEndianType<float,uint32_t>(consume(sizeof(float)));
     }
 
     osg::Vec2f getVector2()
     {
         osg::Vec2f vec;
-        readLittleEndianBufferOfType<2,float,uint32_t>(inp, (float*)&vec._v[0]);
+        readLittleEndianBufferOfType<2,float,uint32_t>(consume(2 * sizeof(float)), (float*)&vec._v[0]);
         return vec;
     }
 
     osg::Vec3f getVector3()
     {
         osg::Vec3f vec;
-        readLittleEndianBufferOfType<3, float,uint32_t>(inp, (float*)&vec._v[0]);
+        readLittleEndianBufferOfType<3, float,uint32_t>(consume(3 * sizeof(float)), (float*)&vec._v[0]);
         return vec;
     }
 
     osg::Vec4f getVector4()
     {
         osg::Vec4f vec;
-        readLittleEndianBufferOfType<4, float,uint32_t>(inp, (float*)&vec._v[0]);
+        readLittleEndianBufferOfType<4, float,uint32_t>(consume(4 * sizeof(float)), (float*)&vec._v[0]);
         return vec;
     }
 
     Matrix3 getMatrix3()
     {
         Matrix3 mat;
-        readLittleEndianBufferOfType<9, float,uint32_t>(inp, (float*)&mat.mValues);
+        readLittleEndianBufferOfType<9, float,uint32_t>(consume(9 * sizeof(float)), (float*)&mat.mValues);
         return mat;
     }
 
@@ -158,67 +184,70 @@ public:
     ///Read in a string of the given length
     std::string getString(size_t length)
     {
-        std::vector<char> str(length + 1, 0);
-
-        inp->read(&str[0], length);
-
-        return &str[0];
+        const char* str = consume(length);
+        // Stop at the first null terminator, if any
+        return std::string(str, std::find(str, str + length, '\0'));
     }
     ///Read in a string of the length specified in the file
     std::string getString()
     {
-        size_t size = readLittleEndianType<uint32_t,uint32_t>(inp);
+        size_t size = readLittleEndianType<uint32_t,uint32_t>(consume(sizeof(uint32_t)));
         return getString(size);
     }
     ///This is special since the version string doesn't start with a number, and ends with "\n"
     std::string getVersionString()
     {
-        std::string result;
-        std::getline(*inp, result);
+        const char* start = mData + mPos;
+        const char* end = std::find(start, mData + mSize, '\n');
+        std::string result(start, end);
+        mPos += result.size();
+        if (end != mData + mSize)
+            ++mPos;
         return result;
     }
 
+    // The array readers check the bounds before resizing, so that a corrupt count fails
+    // instead of causing a huge allocation
     void getUShorts(std::vector<unsigned short> &vec, size_t size)
     {
+        const char* data = consume(size * sizeof(unsigned short));
         vec.resize(size);
-        readLittleEndianDynamicBufferOfType<unsigned short,unsigned short>(inp, &vec.front(), size);
+        readLittleEndianDynamicBufferOfType<unsigned short,unsigned short>(data, vec.data(), size);
     }
 
     void getFloats(std::vector<float> &vec, size_t size)
     {
+        const char* data = consume(size * sizeof(float));
         vec.resize(size);
-        readLittleEndianDynamicBufferOfType<float,uint32_t>(inp, &vec.front(), size);
+        readLittleEndianDynamicBufferOfType<float,uint32_t>(data, vec.data(), size);
     }
 
     void getVector2s(std::vector<osg::Vec2f> &vec, size_t size)
     {
+        const char* data = consume(size * 2 * sizeof(float));
         vec.resize(size);
         /* The packed storage of each Vec2f is 2 floats exactly */
-        readLittleEndianDynamicBufferOfType<float,uint32_t>(inp,(float*) &vec.front(), size*2);
+        readLittleEndianDynamicBufferOfType<float,uint32_t>(data, (float*)vec.data(), size*2);
     }
 
     void getVector3s(std::vector<osg::Vec3f> &vec, size_t size)
     {
+        const char* data = consume(size * 3 * sizeof(float));
         vec.resize(size);
         /* The packed storage of each Vec3f is 3 floats exactly */
-        readLittleEndianDynamicBufferOfType<float,uint32_t>(inp, (float*) &vec.front(), size*3);
+        readLittleEndianDynamicBufferOfType<float,uint32_t>(data, (float*)vec.data(), size*3);
     }
 
     void getVector4s(std::vector<osg::Vec4f> &vec, size_t size)
     {
+        const char* data = consume(size * 4 * sizeof(float));
         vec.resize(size);
         /* The packed storage of each Vec4f is 4 floats exactly */
-        readLittleEndianDynamicBufferOfType<float,uint32_t>(inp, (float*) &vec.front(), size*4);
+        readLittleEndianDynamicBufferOfType<float,uint32_t>(data, (float*)vec.data(), size*4);
     }
 
-    void getQuaternions(std::vector<osg::Quat> &quat, size_t size)
-    {
-        quat.resize(size);
-        for (size_t i = 0;i < quat.size();i++)
-            quat[i] = getQuaternion();
-    }
+    void getQuaternions(std::vector<osg::Quat> &quat, size_t size);
 };
-
 }
 
 #endif
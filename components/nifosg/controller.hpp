@@ -42,19 +42,16 @@ namespace NifOsg
         typedef typename MapT::ValueType ValueT;
 
         ValueInterpolator()
-            : mDefaultVal(ValueT())
+            : mLastHighKey(0)
+            , mDefaultVal(ValueT())
         {
         }
 
         ValueInterpolator(std::shared_ptr<const MapT> keys, ValueT defaultVal = ValueT())
-            : mKeys(keys)
+            : mLastHighKey(0)
+            , mKeys(keys)
             , mDefaultVal(defaultVal)
         {
-            if (keys)
-            {
-                mLastLowKey = mKeys->mKeys.end();
-                mLastHighKey = mKeys->mKeys.end();
-            }
         }
 
         ValueT interpKey(float time) const
@@ -62,49 +59,32 @@ namespace NifOsg
             if (empty())
                 return mDefaultVal;
 
-            const typename MapT::MapType & keys = mKeys->mKeys;
+            const std::vector<float>& times = mKeys->mTimes;
+            const std::vector<typename MapT::KeyType>& keys = mKeys->mKeys;
 
-            if(time <= keys.begin()->first)
-                return keys.begin()->second.mValue;
+            if(time <= times.front())
+                return keys.front().mValue;
+            if(time > times.back())
+                return keys.back().mValue;
 
-            // retrieve the current position in the map, optimized for the most common case
-            // where time moves linearly along the keyframe track
-            typename MapT::MapType::const_iterator it = mLastHighKey;
-            if (mLastHighKey != keys.end())
+            // find the first key at or after time, starting from where it was found last time,
+            // optimized for the most common case where time moves linearly along the keyframe track
+            size_t high = mLastHighKey;
+            if (high == 0 || high >= times.size() || time > times[high] || time <= times[high-1])
             {
-                if (time > mLastHighKey->first)
-                {
-                    // try if we're there by incrementing one
-                    ++mLastLowKey;
-                    ++mLastHighKey;
-                    it = mLastHighKey;
-                }
-                if (mLastHighKey == keys.end() || (time < mLastLowKey->first || time > mLastHighKey->first))
-                    it = keys.lower_bound(time); // still not there, reorient by performing lower_bound check on the whole map
+                if (high != 0 && high+1 < times.size() && time > times[high] && time <= times[high+1])
+                    ++high; // we're there by incrementing one
+                else // reorient by performing a binary search on the whole track
+                    high = std::lower_bound(times.begin(), times.end(), time) - times.begin();
             }
-            else
-                it = keys.lower_bound(time);
-
-            // now do the actual interpolation
-            if (it != keys.end())
-            {
-                float aTime = it->first;
-                const typename MapT::KeyType* aKey = &it->second;
-
-                // cache for next time
-                mLastHighKey = it;
 
-                typename MapT::MapType::const_iterator last = --it;
-                mLastLowKey = last;
-                float aLastTime = last->first;
-                const typename MapT::KeyType* aLastKey = &last->second;
+            // cache for next time
+            mLastHighKey = high;
 
-                float a = (time - aLastTime) / (aTime - aLastTime);
+            // now do the actual interpolation
+            float a = (time - times[high-1]) / (times[high] - times[high-1]);
 
-                return InterpolationFunc()(aLastKey->mValue, aKey->mValue, a);
-            }
-            else
-                return keys.rbegin()->second.mValue;
+            return InterpolationFunc()(keys[high-1].mValue, keys[high].mValue, a);
         }
 
         bool empty() const
@@ -113,8 +93,7 @@ namespace NifOsg
         }
 
     private:
-        mutable typename MapT::MapType::const_iterator mLastLowKey;
-        mutable typename MapT::MapType::const_iterator mLastHighKey;
+        mutable size_t mLastHighKey; ///< index of the key found by the last lookup, 0 if there is none yet
 
         std::shared_ptr<const MapT> mKeys;
 
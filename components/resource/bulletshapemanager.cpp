@@ -114,6 +114,7 @@ osg::ref_ptr<const BulletShape> BulletShapeManager::getShape(const std::string &
     mVFS->normalizeFilename(normalized);
 
     osg::ref_ptr<BulletShape> shape;
+    size_t memoryUsage = 0;
     osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
     if (obj)
         shape = osg::ref_ptr<BulletShape>(static_cast<BulletShape*>(obj.get()));
@@ -127,7 +128,10 @@ osg::ref_ptr<const BulletShape> BulletShapeManager::getShape(const std::string &
         if (ext == "nif")
         {
             NifBullet::BulletNifLoader loader;
-            shape = loader.load(mNifFileManager->get(normalized));
+            Nif::NIFFilePtr file = mNifFileManager->get(normalized);
+            shape = loader.load(file);
+            // The collision mesh is at most as large as the geometry in the file
+            memoryUsage = file->getFileSize();
         }
         else
         {
@@ -142,7 +146,7 @@ osg::ref_ptr<const BulletShape> BulletShapeManager::getShape(const std::string &
                 return osg::ref_ptr<BulletShape>();
         }
 
-        mCache->addEntryToObjectCache(normalized, shape);
+        mCache->addEntryToObjectCache(normalized, shape, 0.0, memoryUsage);
     }
     return shape;
 }
@@ -149,7 +149,7 @@ namespace Resource
                 }
             }
 
-            mCache->addEntryToObjectCache(normalized, image);
+            mCache->addEntryToObjectCache(normalized, image, 0.0, image->getTotalSizeInBytesIncludingMipmaps());
             return image;
         }
     }
@@ -27,9 +27,11 @@ namespace Resource
         else
         {
             osg::ref_ptr<NifOsg::KeyframeHolder> loaded (new NifOsg::KeyframeHolder);
-            NifOsg::Loader::loadKf(Nif::NIFFilePtr(new Nif::NIFFile(mVFS->getNormalized(normalized), normalized)), *loaded.get());
+            Nif::NIFFilePtr file (new Nif::NIFFile(mVFS->getNormalized(normalized), normalized));
+            NifOsg::Loader::loadKf(file, *loaded.get());
 
-            mCache->addEntryToObjectCache(normalized, loaded);
+            // The keyframe data is roughly as large as the file it was loaded from
+            mCache->addEntryToObjectCache(normalized, loaded, 0.0, file->getFileSize());
             return loaded;
         }
     }
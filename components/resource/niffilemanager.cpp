@@ -51,7 +51,7 @@ namespace Resource
         {
             Nif::NIFFilePtr file (new Nif::NIFFile(mVFS->get(name), name));
             obj = new NifFileHolder(file);
-            mCache->addEntryToObjectCache(name, obj);
+            mCache->addEntryToObjectCache(name, obj, 0.0, file->getFileSize());
             return file;
         }
     }
@@ -24,7 +24,11 @@ namespace Resource
 // ObjectCache
 //
 ObjectCache::ObjectCache():
-    osg::Referenced(true)
+    osg::Referenced(true),
+    _memoryUsage(0),
+    _numHits(0),
+    _numMisses(0),
+    _numEvictions(0)
 {
 }
 
@@ -32,7 +36,7 @@ ObjectCache::~ObjectCache()
 {
 }
 
-void ObjectCache::addEntryToObjectCache(const std::string& filename, osg::Object* object, double timestamp)
+void ObjectCache::addEntryToObjectCache(const std::string& filename, osg::Object* object, double timestamp, size_t memoryUsage)
 {
     if (!object)
     {
@@ -40,7 +44,12 @@ void ObjectCache::addEntryToObjectCache(const std::string& filename, osg::Object
         return;
     }
     OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-    _objectCache[filename]=ObjectTimeStampPair(object,timestamp);
+    Item& item = _objectCache[filename];
+    _memoryUsage -= item.mObject ? item.mMemoryUsage : 0;
+    item.mObject = object;
+    item.mTimeStamp = timestamp;
+    item.mMemoryUsage = memoryUsage;
+    _memoryUsage += memoryUsage;
 }
 
 osg::ref_ptr<osg::Object> ObjectCache::getRefFromObjectCache(const std::string& fileName)
@@ -49,9 +58,14 @@ osg::ref_ptr<osg::Object> ObjectCache::getRefFromObjectCache(const std::string&
     ObjectCacheMap::iterator itr = _objectCache.find(fileName);
     if (itr!=_objectCache.end())
     {
-        return itr->second.first;
+        ++_numHits;
+        return itr->second.mObject;
+    }
+    else
+    {
+        ++_numMisses;
+        return 0;
     }
-    else return 0;
 }
 
 bool ObjectCache::checkInObjectCache(const std::string &fileName, double timeStamp)
@@ -60,7 +74,7 @@ bool ObjectCache::checkInObjectCache(const std::string &fileName, double timeSta
     ObjectCacheMap::iterator itr = _objectCache.find(fileName);
     if (itr!=_objectCache.end())
     {
-        itr->second.second = timeStamp;
+        itr->second.mTimeStamp = timeStamp;
         return true;
     }
     else return false;
@@ -76,10 +90,10 @@ void ObjectCache::updateTimeStampOfObjectsInCacheWithExternalReferences(double r
         ++itr)
     {
         // if ref count is greater the 1 the object has an external reference.
-        if (itr->second.first->referenceCount()>1)
+        if (itr->second.mObject->referenceCount()>1)
         {
             // so update it time stamp.
-            itr->second.second = referenceTime;
+            itr->second.mTimeStamp = referenceTime;
         }
     }
 }
@@ -95,9 +109,10 @@ void ObjectCache::removeExpiredObjectsInCache(double expiryTime)
         ObjectCacheMap::iterator oitr = _objectCache.begin();
         while(oitr != _objectCache.end())
         {
-            if (oitr->second.second<=expiryTime)
+            if (oitr->second.mTimeStamp<=expiryTime)
             {
-                objectsToRemove.push_back(oitr->second.first);
+                objectsToRemove.push_back(oitr->second.mObject);
+                _memoryUsage -= oitr->second.mMemoryUsage;
                 _objectCache.erase(oitr++);
             }
             else
@@ -115,13 +130,18 @@ void ObjectCache::removeFromObjectCache(const std::string& fileName)
 {
     OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
     ObjectCacheMap::iterator itr = _objectCache.find(fileName);
-    if (itr!=_objectCache.end()) _objectCache.erase(itr);
+    if (itr!=_objectCache.end())
+    {
+        _memoryUsage -= itr->second.mMemoryUsage;
+        _objectCache.erase(itr);
+    }
 }
 
 void ObjectCache::clear()
 {
     OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
     _objectCache.clear();
+    _memoryUsage = 0;
 }
 
 void ObjectCache::releaseGLObjects(osg::State* state)
@@ -132,7 +152,7 @@ void ObjectCache::releaseGLObjects(osg::State* state)
         itr != _objectCache.end();
         ++itr)
     {
-        osg::Object* object = itr->second.first.get();
+        osg::Object* object = itr->second.mObject.get();
         object->releaseGLObjects(state);
     }
 }
@@ -145,7 +165,7 @@ void ObjectCache::accept(osg::NodeVisitor &nv)
         itr != _objectCache.end();
         ++itr)
     {
-        osg::Object* object = itr->second.first.get();
+        osg::Object* object = itr->second.mObject.get();
         if (object)
         {
             osg::Node* node = dynamic_cast<osg::Node*>(object);
@@ -161,4 +181,69 @@ unsigned int ObjectCache::getCacheSize() const
     return _objectCache.size();
 }
 
+void ObjectCache::getEvictionCandidates(std::vector<EvictionCandidate>& candidates)
+{
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
+
+    for(ObjectCacheMap::iterator itr = _objectCache.begin();
+        itr != _objectCache.end();
+        ++itr)
+    {
+        // objects with external references would stay in memory anyway
+        if (itr->second.mMemoryUsage == 0 || itr->second.mObject->referenceCount()>1)
+            continue;
+
+        EvictionCandidate candidate = { this, itr->first, itr->second.mTimeStamp, itr->second.mMemoryUsage };
+        candidates.push_back(candidate);
+    }
+}
+
+size_t ObjectCache::evictFromObjectCache(const std::string& fileName)
+{
+    osg::ref_ptr<osg::Object> objectToRemove;
+    size_t memoryUsage = 0;
+
+    {
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
+        ObjectCacheMap::iterator itr = _objectCache.find(fileName);
+        // the object may have been referenced again since the candidates were collected
+        if (itr == _objectCache.end() || itr->second.mObject->referenceCount()>1)
+            return 0;
+
+        objectToRemove = itr->second.mObject;
+        memoryUsage = itr->second.mMemoryUsage;
+        _memoryUsage -= memoryUsage;
+        ++_numEvictions;
+        _objectCache.erase(itr);
+    }
+
+    // note, actual unref happens outside of the lock
+    objectToRemove = NULL;
+    return memoryUsage;
+}
+
+size_t ObjectCache::getMemoryUsage() const
+{
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
+    return _memoryUsage;
+}
+
+unsigned int ObjectCache::getNumHits() const
+{
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
+    return _numHits;
+}
+
+unsigned int ObjectCache::getNumMisses() const
+{
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
+    return _numMisses;
+}
+
+unsigned int ObjectCache::getNumEvictions() const
+{
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
+    return _numEvictions;
+}
+
 }
@@ -1,5 +1,6 @@
 // Resource ObjectCache for OpenMW, forked from osgDB ObjectCache by Robert Osfield, see copyright notice below.
 // The main change from the upstream version is that removeExpiredObjectsInCache no longer keeps a lock while the unref happens.
+// Additionally, entries carry an estimated memory usage and usage statistics are recorded, to support a memory budget.
 
 /* -*-c++-*- OpenSceneGraph - Copyright (C) 1998-2006 Robert Osfield
  *
@@ -22,6 +23,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 namespace osg
 {
@@ -55,8 +57,9 @@ class ObjectCache : public osg::Referenced
         /** Remove all objects in the cache regardless of having external references or expiry times.*/
         void clear();
 
-        /** Add a filename,object,timestamp triple to the Registry::ObjectCache.*/
-        void addEntryToObjectCache(const std::string& filename, osg::Object* object, double timestamp = 0.0);
+        /** Add a filename,object,timestamp triple to the Registry::ObjectCache.
+          * memoryUsage is the estimated size of the object in bytes, used for enforcing a memory budget.*/
+        void addEntryToObjectCache(const std::string& filename, osg::Object* object, double timestamp = 0.0, size_t memoryUsage = 0);
 
         /** Remove Object from cache.*/
         void removeFromObjectCache(const std::string& fileName);
@@ -79,22 +82,58 @@ class ObjectCache : public osg::Referenced
         {
             OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
             for (ObjectCacheMap::iterator it = _objectCache.begin(); it != _objectCache.end(); ++it)
-                f(it->second.first.get());
+                f(it->second.mObject.get());
         }
 
         /** Get the number of objects in the cache. */
         unsigned int getCacheSize() const;
 
+        /** An object that is only referenced by the cache, and could therefore be evicted to free memory. */
+        struct EvictionCandidate
+        {
+            ObjectCache* mCache;
+            std::string mFileName;
+            double mTimeStamp;
+            size_t mMemoryUsage;
+        };
+
+        /** Append all objects that are not referenced elsewhere and have a memory usage estimate to the list. */
+        void getEvictionCandidates(std::vector<EvictionCandidate>& candidates);
+
+        /** Remove the object from the cache if it is still not referenced elsewhere, and count it as evicted.
+          * Returns the memory usage estimate of the removed object, or 0 if it was not removed. */
+        size_t evictFromObjectCache(const std::string& fileName);
+
+        /** Get the summed memory usage estimates of all objects in the cache, in bytes. */
+        size_t getMemoryUsage() const;
+
+        /** Number of successful lookups with getRefFromObjectCache since the cache was created. */
+        unsigned int getNumHits() const;
+        /** Number of failed lookups with getRefFromObjectCache since the cache was created. */
+        unsigned int getNumMisses() const;
+        /** Number of objects removed with evictFromObjectCache since the cache was created. */
+        unsigned int getNumEvictions() const;
+
     protected:
 
         virtual ~ObjectCache();
 
-        typedef std::pair<osg::ref_ptr<osg::Object>, double >           ObjectTimeStampPair;
-        typedef std::map<std::string, ObjectTimeStampPair >             ObjectCacheMap;
+        struct Item
+        {
+            osg::ref_ptr<osg::Object> mObject;
+            double mTimeStamp;
+            size_t mMemoryUsage;
+        };
+        typedef std::map<std::string, Item >                            ObjectCacheMap;
 
         ObjectCacheMap                          _objectCache;
         mutable OpenThreads::Mutex              _objectCacheMutex;
 
+        size_t                                  _memoryUsage;
+        unsigned int                            _numHits;
+        unsigned int                            _numMisses;
+        unsigned int                            _numEvictions;
+
 };
 
 }
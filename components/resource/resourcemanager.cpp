@@ -38,6 +38,23 @@ namespace Resource
         return mVFS;
     }
 
+    size_t ResourceManager::getMemoryUsage() const
+    {
+        return mCache->getMemoryUsage();
+    }
+
+    void ResourceManager::getEvictionCandidates(std::vector<ObjectCache::EvictionCandidate>& candidates)
+    {
+        mCache->getEvictionCandidates(candidates);
+    }
+
+    void ResourceManager::getCacheStats(unsigned int& hits, unsigned int& misses, unsigned int& evictions) const
+    {
+        hits = mCache->getNumHits();
+        misses = mCache->getNumMisses();
+        evictions = mCache->getNumEvictions();
+    }
+
     void ResourceManager::releaseGLObjects(osg::State *state)
     {
         mCache->releaseGLObjects(state);
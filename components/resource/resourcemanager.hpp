@@ -3,6 +3,8 @@
 
 #include <osg/ref_ptr>
 
+#include "objectcache.hpp"
+
 namespace VFS
 {
     class Manager;
@@ -16,7 +18,6 @@ namespace osg
 
 namespace Resource
 {
-    class ObjectCache;
 
     /// @brief Base class for managers that require a virtual file system and object cache.
     /// @par This base class implements clearing of the cache, but populating it and what it's used for is up to the individual sub classes.
@@ -37,6 +38,15 @@ namespace Resource
 
         const VFS::Manager* getVFS() const;
 
+        /// Get the estimated memory usage of all cached objects in bytes.
+        size_t getMemoryUsage() const;
+
+        /// Get the cached objects that could be evicted to reduce memory usage.
+        void getEvictionCandidates(std::vector<ObjectCache::EvictionCandidate>& candidates);
+
+        /// Get the cache hit, miss and eviction counters.
+        void getCacheStats(unsigned int& hits, unsigned int& misses, unsigned int& evictions) const;
+
         virtual void reportStats(unsigned int frameNumber, osg::Stats* stats) const {}
 
         virtual void releaseGLObjects(osg::State* state);
@@ -2,16 +2,30 @@
 
 #include <algorithm>
 
+#include <osg/Stats>
+
 #include "scenemanager.hpp"
 #include "imagemanager.hpp"
 #include "niffilemanager.hpp"
 #include "keyframemanager.hpp"
 
+namespace
+{
+    bool compareEvictionCandidates(const Resource::ObjectCache::EvictionCandidate& left, const Resource::ObjectCache::EvictionCandidate& right)
+    {
+        // Least recently used first, and the larger object first when both were last used at the same time
+        if (left.mTimeStamp != right.mTimeStamp)
+            return left.mTimeStamp < right.mTimeStamp;
+        return left.mMemoryUsage > right.mMemoryUsage;
+    }
+}
+
 namespace Resource
 {
 
     ResourceSystem::ResourceSystem(const VFS::Manager *vfs)
         : mVFS(vfs)
+        , mMemoryBudget(0)
     {
         mNifFileManager.reset(new NifFileManager(vfs));
         mKeyframeManager.reset(new KeyframeManager(vfs));
@@ -62,10 +76,37 @@ namespace Resource
         mNifFileManager->setExpiryDelay(0.0);
     }
 
+    void ResourceSystem::setMemoryBudget(size_t bytes)
+    {
+        mMemoryBudget = bytes;
+    }
+
     void ResourceSystem::updateCache(double referenceTime)
     {
         for (std::vector<ResourceManager*>::iterator it = mResourceManagers.begin(); it != mResourceManagers.end(); ++it)
             (*it)->updateCache(referenceTime);
+
+        if (mMemoryBudget)
+            enforceMemoryBudget();
+    }
+
+    void ResourceSystem::enforceMemoryBudget()
+    {
+        size_t memoryUsage = 0;
+        for (std::vector<ResourceManager*>::iterator it = mResourceManagers.begin(); it != mResourceManagers.end(); ++it)
+            memoryUsage += (*it)->getMemoryUsage();
+
+        if (memoryUsage <= mMemoryBudget)
+            return;
+
+        std::vector<ObjectCache::EvictionCandidate> candidates;
+        for (std::vector<ResourceManager*>::iterator it = mResourceManagers.begin(); it != mResourceManagers.end(); ++it)
+            (*it)->getEvictionCandidates(candidates);
+
+        std::sort(candidates.begin(), candidates.end(), compareEvictionCandidates);
+
+        for (std::vector<ObjectCache::EvictionCandidate>::iterator it = candidates.begin(); it != candidates.end() && memoryUsage > mMemoryBudget; ++it)
+            memoryUsage -= std::min(memoryUsage, it->mCache->evictFromObjectCache(it->mFileName));
     }
 
     void ResourceSystem::clearCache()
@@ -93,8 +134,24 @@ namespace Resource
 
     void ResourceSystem::reportStats(unsigned int frameNumber, osg::Stats *stats) const
     {
+        size_t memoryUsage = 0;
+        unsigned int hits = 0, misses = 0, evictions = 0;
         for (std::vector<ResourceManager*>::const_iterator it = mResourceManagers.begin(); it != mResourceManagers.end(); ++it)
+        {
             (*it)->reportStats(frameNumber, stats);
+
+            unsigned int managerHits, managerMisses, managerEvictions;
+            (*it)->getCacheStats(managerHits, managerMisses, managerEvictions);
+            hits += managerHits;
+            misses += managerMisses;
+            evictions += managerEvictions;
+            memoryUsage += (*it)->getMemoryUsage();
+        }
+
+        stats->setAttribute(frameNumber, "Cache MB", memoryUsage / (1024.0 * 1024.0));
+        stats->setAttribute(frameNumber, "Cache Hit", hits);
+        stats->setAttribute(frameNumber, "Cache Miss", misses);
+        stats->setAttribute(frameNumber, "Cache Evicted", evictions);
     }
 
     void ResourceSystem::releaseGLObjects(osg::State *state)
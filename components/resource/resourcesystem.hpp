@@ -56,6 +56,11 @@ namespace Resource
         /// How long to keep objects in cache after no longer being referenced.
         void setExpiryDelay(double expiryDelay);
 
+        /// Maximum estimated memory usage of all resource manager caches combined, in bytes, or 0 for no limit.
+        /// @par When exceeded, updateCache() evicts the least recently used objects that are not referenced elsewhere,
+        /// regardless of the expiry delay.
+        void setMemoryBudget(size_t bytes);
+
         /// @note May be called from any thread.
         const VFS::Manager* getVFS() const;
 
@@ -76,6 +81,11 @@ namespace Resource
 
         const VFS::Manager* mVFS;
 
+        size_t mMemoryBudget;
+
+        /// Evict cached objects until the memory budget is met
+        void enforceMemoryBudget();
+
         ResourceSystem(const ResourceSystem&);
         void operator = (const ResourceSystem&);
     };
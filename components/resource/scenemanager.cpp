@@ -4,6 +4,7 @@
 #include <cstdlib>
 
 #include <osg/Node>
+#include <osg/Geometry>
 #include <osg/UserDataContainer>
 
 #include <osgParticle/ParticleSystem>
@@ -105,6 +106,46 @@ namespace
     private:
         unsigned int mMask;
     };
+
+    /// Estimates the memory used by a scene graph's nodes and geometry.
+    /// @note Textures are not included, since their images are accounted for by the ImageManager.
+    class MemoryUsageVisitor : public osg::NodeVisitor
+    {
+    public:
+        MemoryUsageVisitor()
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            , mMemoryUsage(0)
+        {
+        }
+
+        void apply(osg::Node& node)
+        {
+            mMemoryUsage += sizeof(osg::Group);
+            traverse(node);
+        }
+
+        void apply(osg::Drawable& drawable)
+        {
+            mMemoryUsage += sizeof(osg::Geometry);
+
+            osg::Geometry* geometry = drawable.asGeometry();
+            if (!geometry)
+                return;
+
+            osg::Geometry::ArrayList arrays;
+            geometry->getArrayList(arrays);
+            for (osg::Geometry::ArrayList::const_iterator it = arrays.begin(); it != arrays.end(); ++it)
+                mMemoryUsage += (*it)->getTotalDataSize();
+
+            for (unsigned int i=0; i<geometry->getNumPrimitiveSets(); ++i)
+                mMemoryUsage += geometry->getPrimitiveSet(i)->getTotalDataSize();
+        }
+
+        size_t getMemoryUsage() const { return mMemoryUsage; }
+
+    private:
+        size_t mMemoryUsage;
+    };
 }
 
 namespace Resource
@@ -541,7 +582,10 @@ namespace Resource
             if (mIncrementalCompileOperation)
                 mIncrementalCompileOperation->add(loaded);
 
-            mCache->addEntryToObjectCache(normalized, loaded);
+            MemoryUsageVisitor memoryUsageVisitor;
+            loaded->accept(memoryUsageVisitor);
+
+            mCache->addEntryToObjectCache(normalized, loaded, 0.0, memoryUsageVisitor.getMemoryUsage());
             return loaded;
         }
     }
@@ -5,11 +5,62 @@
 #include <cstdlib>
 
 #include "skeleton.hpp"
+#include "skinning.hpp"
 #include "util.hpp"
+#include "workqueue.hpp"
 
 namespace SceneUtil
 {
 
+/// Transforms the vertices of one frame's buffer of a RigGeometry.
+class RigGeometry::SkinningWorkItem : public WorkItem
+{
+public:
+    SkinningWorkItem(RigGeometry* rig, unsigned int frame)
+        : mRig(rig)
+        , mFrame(frame)
+    {
+    }
+
+    virtual void doWork()
+    {
+        mRig->skin(mFrame);
+    }
+
+private:
+    RigGeometry* mRig;
+    unsigned int mFrame;
+};
+
+/// Makes the draw traversal wait for the skinning of one of the internal geometries to complete.
+class RigGeometry::WaitForSkinning : public osg::Drawable::DrawCallback
+{
+public:
+    WaitForSkinning(SkinningWork* work, unsigned int buffer)
+        : mWork(work)
+        , mBuffer(buffer)
+    {
+    }
+
+    virtual void drawImplementation(osg::RenderInfo& renderInfo, const osg::Drawable* drawable) const
+    {
+        mWork->waitTillDone(mBuffer);
+        drawable->drawImplementation(renderInfo);
+    }
+
+private:
+    // Referenced rather than owned by the RigGeometry, since the render bins may still draw the geometry after the rig is deleted
+    osg::ref_ptr<SkinningWork> mWork;
+    unsigned int mBuffer;
+};
+
+WorkQueue* RigGeometry::sWorkQueue = NULL;
+
+void RigGeometry::setWorkQueue(WorkQueue* workQueue)
+{
+    sWorkQueue = workQueue;
+}
+
 RigGeometry::RigGeometry()
     : mSkeleton(NULL)
     , mLastFrameNumber(0)
@@ -29,9 +80,20 @@ RigGeometry::RigGeometry(const RigGeometry &copy, const osg::CopyOp &copyop)
     setSourceGeometry(copy.mSourceGeometry);
 }
 
+RigGeometry::~RigGeometry()
+{
+    // the work items refer to this object
+    if (mSkinningWork)
+    {
+        mSkinningWork->waitTillDone(0);
+        mSkinningWork->waitTillDone(1);
+    }
+}
+
 void RigGeometry::setSourceGeometry(osg::ref_ptr<osg::Geometry> sourceGeometry)
 {
     mSourceGeometry = sourceGeometry;
+    mSkinningWork = new SkinningWork;
 
     for (unsigned int i=0; i<2; ++i)
     {
@@ -41,6 +103,7 @@ void RigGeometry::setSourceGeometry(osg::ref_ptr<osg::Geometry> sourceGeometry)
         to.setSupportsDisplayList(false);
         to.setUseVertexBufferObjects(true);
         to.setCullingActive(false); // make sure to disable culling since that's handled by this class
+        to.setDrawCallback(new WaitForSkinning(mSkinningWork, i));
 
         // vertices and normals are modified every frame, so we need to deep copy them.
         // assign a dedicated VBO to make sure that modifications don't interfere with source geometry's VBO.
@@ -73,6 +136,9 @@ void RigGeometry::setSourceGeometry(osg::ref_ptr<osg::Geometry> sourceGeometry)
         }
         else
             mSourceTangents = NULL;
+
+        // compute the bounds now, so that they are not computed from the vertices while a worker thread is writing them
+        to.getBound();
     }
 }
 
@@ -185,21 +251,32 @@ void RigGeometry::cull(osg::NodeVisitor* nv)
 
     mSkeleton->updateBoneMatrices(nv->getTraversalNumber());
 
-    // skinning
-    const osg::Vec3Array* positionSrc = static_cast<osg::Vec3Array*>(mSourceGeometry->getVertexArray());
-    const osg::Vec3Array* normalSrc = static_cast<osg::Vec3Array*>(mSourceGeometry->getNormalArray());
-    const osg::Vec4Array* tangentSrc = mSourceTangents;
+    // the bone matrices change in the next update traversal, so they have to be read now. The buffer was last drawn
+    // two frames ago, so the previous work on it has completed and its matrices are no longer in use.
+    mSkinningWork->waitTillDone(mLastFrameNumber);
+    updateSkinningMatrices(mLastFrameNumber);
 
-    osg::Vec3Array* positionDst = static_cast<osg::Vec3Array*>(geom.getVertexArray());
-    osg::Vec3Array* normalDst = static_cast<osg::Vec3Array*>(geom.getNormalArray());
-    osg::Vec4Array* tangentDst = static_cast<osg::Vec4Array*>(geom.getTexCoordArray(7));
+    osg::ref_ptr<SkinningWorkItem> workItem (new SkinningWorkItem(this, mLastFrameNumber));
+    mSkinningWork->start(mLastFrameNumber, workItem, sWorkQueue);
+
+    nv->pushOntoNodePath(&geom);
+    nv->apply(geom);
+    nv->popFromNodePath();
+}
 
-    for (Bone2VertexMap::const_iterator it = mBone2VertexMap.begin(); it != mBone2VertexMap.end(); ++it)
+void RigGeometry::updateSkinningMatrices(unsigned int frame)
+{
+    std::vector<osg::Matrixf>& matrices = mSkinningMatrices[frame%2];
+    matrices.resize(mBone2VertexMap.size());
+
+    std::vector<osg::Matrixf>::iterator matrixIt = matrices.begin();
+    for (Bone2VertexMap::const_iterator it = mBone2VertexMap.begin(); it != mBone2VertexMap.end(); ++it, ++matrixIt)
     {
-        osg::Matrixf resultMat  (0, 0, 0, 0,
-                                0, 0, 0, 0,
-                                0, 0, 0, 0,
-                                0, 0, 0, 1);
+        osg::Matrixf& resultMat = *matrixIt;
+        resultMat.set(0, 0, 0, 0,
+                      0, 0, 0, 0,
+                      0, 0, 0, 0,
+                      0, 0, 0, 1);
 
         for (std::vector<BoneWeight>::const_iterator weightIt = it->first.begin(); weightIt != it->first.end(); ++weightIt)
         {
@@ -211,20 +288,33 @@ void RigGeometry::cull(osg::NodeVisitor* nv)
         }
         if (mGeomToSkelMatrix)
             resultMat *= (*mGeomToSkelMatrix);
+    }
+}
 
-        for (std::vector<unsigned short>::const_iterator vertexIt = it->second.begin(); vertexIt != it->second.end(); ++vertexIt)
-        {
-            unsigned short vertex = *vertexIt;
-            (*positionDst)[vertex] = resultMat.preMult((*positionSrc)[vertex]);
-            if (normalDst)
-                (*normalDst)[vertex] = osg::Matrix::transform3x3((*normalSrc)[vertex], resultMat);
-            if (tangentDst)
-            {
-                osg::Vec4f srcTangent = (*tangentSrc)[vertex];
-                osg::Vec3f transformedTangent = osg::Matrix::transform3x3(osg::Vec3f(srcTangent.x(), srcTangent.y(), srcTangent.z()), resultMat);
-                (*tangentDst)[vertex] = osg::Vec4f(transformedTangent, srcTangent.w());
-            }
-        }
+void RigGeometry::skin(unsigned int frame)
+{
+    osg::Geometry& geom = *getGeometry(frame);
+
+    const osg::Vec3Array* positionSrc = static_cast<osg::Vec3Array*>(mSourceGeometry->getVertexArray());
+    const osg::Vec3Array* normalSrc = static_cast<osg::Vec3Array*>(mSourceGeometry->getNormalArray());
+    const osg::Vec4Array* tangentSrc = mSourceTangents;
+
+    osg::Vec3Array* positionDst = static_cast<osg::Vec3Array*>(geom.getVertexArray());
+    osg::Vec3Array* normalDst = static_cast<osg::Vec3Array*>(geom.getNormalArray());
+    osg::Vec4Array* tangentDst = static_cast<osg::Vec4Array*>(geom.getTexCoordArray(7));
+
+    const std::vector<osg::Matrixf>& matrices = mSkinningMatrices[frame%2];
+    std::vector<osg::Matrixf>::const_iterator matrixIt = matrices.begin();
+    for (Bone2VertexMap::const_iterator it = mBone2VertexMap.begin(); it != mBone2VertexMap.end(); ++it, ++matrixIt)
+    {
+        const float* matrix = matrixIt->ptr();
+        const VertexList& vertices = it->second;
+
+        Skinning::transformPositions(matrix, &vertices[0], vertices.size(), (*positionSrc)[0].ptr(), (*positionDst)[0].ptr());
+        if (normalDst)
+            Skinning::transformNormals(matrix, &vertices[0], vertices.size(), (*normalSrc)[0].ptr(), (*normalDst)[0].ptr());
+        if (tangentDst)
+            Skinning::transformTangents(matrix, &vertices[0], vertices.size(), (*tangentSrc)[0].ptr(), (*tangentDst)[0].ptr());
     }
 
     positionDst->dirty();
@@ -232,10 +322,6 @@ void RigGeometry::cull(osg::NodeVisitor* nv)
         normalDst->dirty();
     if (tangentDst)
         tangentDst->dirty();
-
-    nv->pushOntoNodePath(&geom);
-    nv->apply(geom);
-    nv->popFromNodePath();
 }
 
 void RigGeometry::updateBounds(osg::NodeVisitor *nv)
@@ -326,6 +412,7 @@ void RigGeometry::accept(osg::NodeVisitor &nv)
 
 void RigGeometry::accept(osg::PrimitiveFunctor& func) const
 {
+    mSkinningWork->waitTillDone(mLastFrameNumber);
     getGeometry(mLastFrameNumber)->accept(func);
 }
 
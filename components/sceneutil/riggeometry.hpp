@@ -4,22 +4,29 @@
 #include <osg/Geometry>
 #include <osg/Matrixf>
 
+#include <vector>
+
 namespace SceneUtil
 {
 
     class Skeleton;
     class Bone;
+    class SkinningWork;
+    class WorkQueue;
 
     /// @brief Mesh skinning implementation.
     /// @note A RigGeometry may be attached directly to a Skeleton, or somewhere below a Skeleton.
     /// Note though that the RigGeometry ignores any transforms below the Skeleton, so the attachment point is not that important.
     /// @note The internal Geometry used for rendering is double buffered, this allows updates to be done in a thread safe way while
     /// not compromising rendering performance. This is crucial when using osg's default threading model of DrawThreadPerContext.
+    /// @note If a skinning work queue is set, the vertices are transformed on its worker threads. The cull traversal only computes
+    /// the skinning matrices and queues the work, the draw traversal waits for it to complete before rendering the geometry.
     class RigGeometry : public osg::Drawable
     {
     public:
         RigGeometry();
         RigGeometry(const RigGeometry& copy, const osg::CopyOp& copyop);
+        ~RigGeometry();
 
         META_Object(SceneUtil, RigGeometry)
 
@@ -51,10 +58,24 @@ namespace SceneUtil
         virtual bool supports(const osg::PrimitiveFunctor&) const { return true; }
         virtual void accept(osg::PrimitiveFunctor&) const;
 
+        /// Transform the vertices of all RigGeometries on the worker threads of \a workQueue.
+        /// Set to NULL (default) to transform them in the cull traversal instead.
+        /// @note The work queue must outlive the RigGeometries that are rendered while it is set.
+        static void setWorkQueue(WorkQueue* workQueue);
+
     private:
+        class SkinningWorkItem;
+        class WaitForSkinning;
+
         void cull(osg::NodeVisitor* nv);
         void updateBounds(osg::NodeVisitor* nv);
 
+        /// Compute the skinning matrix of each vertex group in mBone2VertexMap for the given frame's buffer.
+        void updateSkinningMatrices(unsigned int frame);
+
+        /// Transform the vertices of the given frame's buffer by its skinning matrices.
+        void skin(unsigned int frame);
+
         osg::ref_ptr<osg::Geometry> mGeometry[2];
         osg::Geometry* getGeometry(unsigned int frame) const;
 
@@ -76,6 +97,13 @@ namespace SceneUtil
 
         Bone2VertexMap mBone2VertexMap;
 
+        /// Skinning matrix of each entry in mBone2VertexMap, in the same order. Double buffered like the geometry.
+        std::vector<osg::Matrixf> mSkinningMatrices[2];
+
+        osg::ref_ptr<SkinningWork> mSkinningWork;
+
+        static WorkQueue* sWorkQueue;
+
         typedef std::map<Bone*, osg::BoundingSpheref> BoneSphereMap;
 
         BoneSphereMap mBoneSphereMap;
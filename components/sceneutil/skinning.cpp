@@ -0,0 +1,154 @@
+#include "skinning.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define OPENMW_SKINNING_SSE
+#include <xmmintrin.h>
+#endif
+
+#include "workqueue.hpp"
+
+namespace
+{
+
+#ifdef OPENMW_SKINNING_SSE
+
+    /// Rows of the skinning matrix, with a 0 in the unused fourth lane.
+    struct Rows
+    {
+        __m128 mRow[4];
+
+        Rows(const float* matrix)
+        {
+            for (int i=0; i<4; ++i)
+                mRow[i] = _mm_setr_ps(matrix[i*4], matrix[i*4+1], matrix[i*4+2], 0.f);
+        }
+
+        // ((x*row0 + y*row1) + z*row2), the same order of operations as the scalar code
+        __m128 transform3x3(const float* v) const
+        {
+            __m128 result = _mm_mul_ps(_mm_set1_ps(v[0]), mRow[0]);
+            result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(v[1]), mRow[1]));
+            return _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(v[2]), mRow[2]));
+        }
+    };
+
+    // The attributes are tightly packed and the vertices are scattered, so a 16 byte store would overwrite the next vertex.
+    inline void store3(float* dst, __m128 value)
+    {
+        _mm_storel_pi(reinterpret_cast<__m64*>(dst), value);
+        _mm_store_ss(dst + 2, _mm_movehl_ps(value, value));
+    }
+
+#endif
+
+}
+
+namespace SceneUtil
+{
+
+namespace Skinning
+{
+
+#ifdef OPENMW_SKINNING_SSE
+
+void transformPositions(const float* matrix, const unsigned short* indices, std::size_t count, const float* src, float* dst)
+{
+    const Rows rows (matrix);
+    for (std::size_t i=0; i<count; ++i)
+    {
+        const std::size_t offset = indices[i] * 3;
+        store3(dst + offset, _mm_add_ps(rows.transform3x3(src + offset), rows.mRow[3]));
+    }
+}
+
+void transformNormals(const float* matrix, const unsigned short* indices, std::size_t count, const float* src, float* dst)
+{
+    const Rows rows (matrix);
+    for (std::size_t i=0; i<count; ++i)
+    {
+        const std::size_t offset = indices[i] * 3;
+        store3(dst + offset, rows.transform3x3(src + offset));
+    }
+}
+
+void transformTangents(const float* matrix, const unsigned short* indices, std::size_t count, const float* src, float* dst)
+{
+    const Rows rows (matrix);
+    for (std::size_t i=0; i<count; ++i)
+    {
+        const std::size_t offset = indices[i] * 4;
+        store3(dst + offset, rows.transform3x3(src + offset));
+        dst[offset + 3] = src[offset + 3];
+    }
+}
+
+#else
+
+void transformPositions(const float* m, const unsigned short* indices, std::size_t count, const float* src, float* dst)
+{
+    for (std::size_t i=0; i<count; ++i)
+    {
+        const float* v = src + indices[i] * 3;
+        float* out = dst + indices[i] * 3;
+        out[0] = v[0]*m[0] + v[1]*m[4] + v[2]*m[8] + m[12];
+        out[1] = v[0]*m[1] + v[1]*m[5] + v[2]*m[9] + m[13];
+        out[2] = v[0]*m[2] + v[1]*m[6] + v[2]*m[10] + m[14];
+    }
+}
+
+void transformNormals(const float* m, const unsigned short* indices, std::size_t count, const float* src, float* dst)
+{
+    for (std::size_t i=0; i<count; ++i)
+    {
+        const float* v = src + indices[i] * 3;
+        float* out = dst + indices[i] * 3;
+        out[0] = v[0]*m[0] + v[1]*m[4] + v[2]*m[8];
+        out[1] = v[0]*m[1] + v[1]*m[5] + v[2]*m[9];
+        out[2] = v[0]*m[2] + v[1]*m[6] + v[2]*m[10];
+    }
+}
+
+void transformTangents(const float* m, const unsigned short* indices, std::size_t count, const float* src, float* dst)
+{
+    for (std::size_t i=0; i<count; ++i)
+    {
+        const float* v = src + indices[i] * 4;
+        float* out = dst + indices[i] * 4;
+        out[0] = v[0]*m[0] + v[1]*m[4] + v[2]*m[8];
+        out[1] = v[0]*m[1] + v[1]*m[5] + v[2]*m[9];
+        out[2] = v[0]*m[2] + v[1]*m[6] + v[2]*m[10];
+        out[3] = v[3];
+    }
+}
+
+#endif
+
+}
+
+void SkinningWork::start(unsigned int frame, WorkItem* item, WorkQueue* workQueue)
+{
+    osg::ref_ptr<WorkItem>& slot = mWorkItems[frame%2];
+    if (slot)
+        slot->waitTillDone();
+
+    if (workQueue)
+    {
+        slot = item;
+        workQueue->addWorkItem(item);
+    }
+    else
+    {
+        slot = NULL;
+        item->doWork();
+        item->signalDone();
+    }
+}
+
+void SkinningWork::waitTillDone(unsigned int frame) const
+{
+    const osg::ref_ptr<WorkItem>& slot = mWorkItems[frame%2];
+    if (slot)
+        slot->waitTillDone();
+}
+
+}
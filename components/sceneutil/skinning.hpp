@@ -0,0 +1,53 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_SKINNING_H
+#define OPENMW_COMPONENTS_SCENEUTIL_SKINNING_H
+
+#include <cstddef>
+
+#include <osg/Referenced>
+#include <osg/ref_ptr>
+
+namespace SceneUtil
+{
+
+    class WorkItem;
+    class WorkQueue;
+
+    /// Vertex transforms for mesh skinning, on plain float arrays with 3 (positions, normals) or 4 (tangents) floats per vertex.
+    /// Only the vertices listed in \a indices are read and written.
+    /// @par \a matrix is an affine matrix in OSG's memory layout (e.g. osg::Matrixf::ptr()): vertices are row vectors and the translation
+    /// is in elements 12 to 14. The last column is assumed to be (0, 0, 0, 1) and is not read.
+    /// @note Uses SSE when the compiler targets it. Positions are computed in the same order of operations as osg::Matrixf::preMult().
+    /// Normals and tangents are computed in single precision, so they can differ from osg::Matrix::transform3x3() in the last bits.
+    namespace Skinning
+    {
+        void transformPositions(const float* matrix, const unsigned short* indices, std::size_t count, const float* src, float* dst);
+
+        /// Apply the upper 3x3 part of \a matrix only.
+        void transformNormals(const float* matrix, const unsigned short* indices, std::size_t count, const float* src, float* dst);
+
+        /// Apply the upper 3x3 part of \a matrix to xyz and copy w, which holds the handedness of the tangent space.
+        void transformTangents(const float* matrix, const unsigned short* indices, std::size_t count, const float* src, float* dst);
+    }
+
+    /// @brief The pending skinning work for each buffer of a double buffered geometry, with buffer frame%2 used in frame \a frame.
+    /// @par Synchronisation with osgViewer's DrawThreadPerContext threading model: the cull of frame N+1 runs at the same time as
+    /// the draw of frame N, and the cull of frame N+2 only starts once the draw of frame N has completed, because the renderer only has
+    /// two SceneViews. start() is called from the cull traversal and waitTillDone() before drawing, so the two never access the same
+    /// buffer at the same time. The work of frame N may still be running while frame N+1 is culled, since it uses the other buffer.
+    class SkinningWork : public osg::Referenced
+    {
+    public:
+        /// Run \a item for the buffer of \a frame, on \a workQueue if one is given or otherwise right away on the calling thread.
+        /// @note Waits for the previous work on that buffer first.
+        void start(unsigned int frame, WorkItem* item, WorkQueue* workQueue);
+
+        /// Wait until the work on the buffer of \a frame has completed.
+        void waitTillDone(unsigned int frame) const;
+
+    private:
+        osg::ref_ptr<WorkItem> mWorkItems[2];
+    };
+
+}
+
+#endif
@@ -83,6 +83,22 @@ void WorkQueue::addWorkItem(osg::ref_ptr<WorkItem> item, bool front)
     mCondition.signal();
 }
 
+bool WorkQueue::moveToFront(const WorkItem* item)
+{
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+    for (std::deque<osg::ref_ptr<WorkItem> >::iterator it = mQueue.begin(); it != mQueue.end(); ++it)
+    {
+        if (it->get() == item)
+        {
+            osg::ref_ptr<WorkItem> found = *it;
+            mQueue.erase(it);
+            mQueue.push_front(found);
+            return true;
+        }
+    }
+    return false;
+}
+
 osg::ref_ptr<WorkItem> WorkQueue::removeWorkItem()
 {
     OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
@@ -56,6 +56,10 @@ namespace SceneUtil
         /// @param front If true, add item to the front of the queue. If false (default), add to the back.
         void addWorkItem(osg::ref_ptr<WorkItem> item, bool front=false);
 
+        /// Move an item that is still waiting in the queue to the front of the queue.
+        /// @return false if the item is not in the queue, because a thread has already started or finished it.
+        bool moveToFront(const WorkItem* item);
+
         /// Get the next work item from the front of the queue. If the queue is empty, waits until a new item is added.
         /// If the workqueue is in the process of being destroyed, may return NULL.
         /// @par Used internally by the WorkThread.
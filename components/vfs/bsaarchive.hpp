@@ -22,7 +22,8 @@ namespace VFS
     class BsaArchive : public Archive
     {
     public:
-        BsaArchive(const std::string& filename);
+        /// @param memoryMapped Map the archive into memory, see Bsa::BSAFile::open().
+        BsaArchive(const std::string& filename, bool memoryMapped = false);
 
         virtual void listResources(std::map<std::string, File*>& out, char (*normalize_function) (char));
 
@@ -4,6 +4,7 @@
 #include <stdexcept>
 
 #include <components/misc/stringops.hpp>
+#include <components/bsa/bsa_file.hpp>
 
 #include "archive.hpp"
 
@@ -26,6 +27,18 @@ namespace
         std::transform(path.begin(), path.end(), path.begin(), normalize_char);
     }
 
+    /// The archive hash folds case and slashes, so it is valid for both strict and non-strict lookups.
+    uint64_t hash_path(const std::string& path)
+    {
+        return Bsa::BSAFile::getHash(path.c_str(), path.size());
+    }
+
+    size_t hash_bucket(uint64_t hash, size_t mask)
+    {
+        // The archive hash has poor low bits for short names, so mix before masking
+        return static_cast<size_t>((hash * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    }
+
 }
 
 namespace VFS
@@ -33,6 +46,7 @@ namespace VFS
 
     Manager::Manager(bool strict)
         : mStrict(strict)
+        , mHashMask(0)
     {
 
     }
@@ -44,6 +58,8 @@ namespace VFS
 
     void Manager::reset()
     {
+        mHashIndex.clear();
+        mHashMask = 0;
         mIndex.clear();
         for (std::vector<Archive*>::iterator it = mArchives.begin(); it != mArchives.end(); ++it)
             delete *it;
@@ -61,30 +77,72 @@ namespace VFS
 
         for (std::vector<Archive*>::const_iterator it = mArchives.begin(); it != mArchives.end(); ++it)
             (*it)->listResources(mIndex, mStrict ? &strict_normalize_char : &nonstrict_normalize_char);
+
+        // Keep the load factor at or below 0.5
+        size_t size = 16;
+        while (size < mIndex.size() * 2)
+            size *= 2;
+        mHashMask = size - 1;
+
+        HashEntry empty = { 0, 0, 0 };
+        mHashIndex.assign(size, empty);
+        for (std::map<std::string, File*>::const_iterator it = mIndex.begin(); it != mIndex.end(); ++it)
+        {
+            HashEntry entry = { hash_path(it->first), &it->first, it->second };
+            size_t bucket = hash_bucket(entry.mHash, mHashMask);
+            while (mHashIndex[bucket].mName)
+                bucket = (bucket + 1) & mHashMask;
+            mHashIndex[bucket] = entry;
+        }
     }
 
-    Files::IStreamPtr Manager::get(const std::string &name) const
+    File* Manager::lookup(const std::string &name, bool normalized) const
     {
-        std::string normalized = name;
-        normalize_path(normalized, mStrict);
+        if (mHashIndex.empty())
+            return 0;
+
+        char (*normalize_char)(char) = (normalized || mStrict) ? &strict_normalize_char : &nonstrict_normalize_char;
+
+        uint64_t hash = hash_path(name);
+        for (size_t bucket = hash_bucket(hash, mHashMask); mHashIndex[bucket].mName; bucket = (bucket + 1) & mHashMask)
+        {
+            const HashEntry& entry = mHashIndex[bucket];
+            if (entry.mHash != hash || entry.mName->size() != name.size())
+                continue;
+
+            std::string::const_iterator it = name.begin();
+            std::string::const_iterator candidate = entry.mName->begin();
+            for (; it != name.end() && normalize_char(*it) == *candidate; ++it, ++candidate) {}
+
+            if (it == name.end())
+                return entry.mFile;
+        }
+        return 0;
+    }
 
-        return getNormalized(normalized);
+    Files::IStreamPtr Manager::get(const std::string &name) const
+    {
+        File* file = lookup(name, false);
+        if (!file)
+        {
+            std::string normalized = name;
+            normalize_path(normalized, mStrict);
+            throw std::runtime_error("Resource '" + normalized + "' not found");
+        }
+        return file->open();
     }
 
     Files::IStreamPtr Manager::getNormalized(const std::string &normalizedName) const
     {
-        std::map<std::string, File*>::const_iterator found = mIndex.find(normalizedName);
-        if (found == mIndex.end())
+        File* file = lookup(normalizedName, true);
+        if (!file)
             throw std::runtime_error("Resource '" + normalizedName + "' not found");
-        return found->second->open();
+        return file->open();
     }
 
     bool Manager::exists(const std::string &name) const
     {
-        std::string normalized = name;
-        normalize_path(normalized, mStrict);
-
-        return mIndex.find(normalized) != mIndex.end();
+        return lookup(name, false) != 0;
     }
 
     const std::map<std::string, File*>& Manager::getIndex() const
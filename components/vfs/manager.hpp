@@ -3,6 +3,7 @@
 
 #include <components/files/constrainedfilestream.hpp>
 
+#include <stdint.h>
 #include <vector>
 #include <map>
 
@@ -40,7 +41,8 @@ namespace VFS
         /// @note May be called from any thread once the index has been built.
         bool exists(const std::string& name) const;
 
-        /// Get a complete list of files from all archives
+        /// Get a complete list of files from all archives, sorted by normalized name.
+        /// @par Use lower_bound() on the result to iterate over all files with a given prefix.
         /// @note May be called from any thread once the index has been built.
         const std::map<std::string, File*>& getIndex() const;
 
@@ -59,11 +61,26 @@ namespace VFS
         Files::IStreamPtr getNormalized(const std::string& normalizedName) const;
 
     private:
+        /// Look up a file in the hash index, normalizing the name on the fly. Does not allocate.
+        /// @return 0 if the file can not be found.
+        File* lookup(const std::string& name, bool normalized) const;
+
         bool mStrict;
 
         std::vector<Archive*> mArchives;
 
         std::map<std::string, File*> mIndex;
+
+        struct HashEntry
+        {
+            uint64_t mHash;
+            const std::string* mName; // points into mIndex
+            File* mFile;
+        };
+
+        /// Open addressing table over mIndex, immutable once built so lookups need no locking.
+        std::vector<HashEntry> mHashIndex;
+        size_t mHashMask;
     };
 
 }